@@ -0,0 +1,285 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+//! \file ActiveTiles.cpp
+//! Contains the management of the computational domain as a set of
+//! active tiles.
+//! \date 2026-10
+
+
+#include"ActiveTiles.hpp"
+#include<algorithm>
+
+
+ActiveTiles::ActiveTiles(CA::Grid& GRID, CA::CellBuffMask& MASK, CA::Unsigned size) :
+    _fullbox(GRID.box()),
+    _size(std::max(size, static_cast<CA::Unsigned>(1))),
+    _nx((_fullbox.w() + _size - 1) / _size),
+    _ny((_fullbox.h() + _size - 1) / _size),
+    _data(_fullbox.size(), 0),
+    _used(_nx * _ny, 0),
+    _pinned(_nx * _ny, 0),
+    _state(_nx * _ny, OFF),
+    _domain(),
+    _added(),
+    _removed(),
+    _wd()
+{
+    setMask(MASK);
+}
+
+
+void ActiveTiles::setMask(CA::CellBuffMask& MASK)
+{
+    std::vector<CA::Mask> mask(_fullbox.size());
+    MASK.retrieveData(_fullbox, &mask[0], _fullbox.w(), _fullbox.h());
+
+    std::fill(_used.begin(), _used.end(), 0);
+
+    for (CA::Unsigned j = 0; j < _fullbox.h(); ++j)
+    {
+        for (CA::Unsigned i = 0; i < _fullbox.w(); ++i)
+        {
+            const CA::Mask m = mask[j * _fullbox.w() + i];
+
+            // The data bit is true if the cell has data, the boundary
+            // bit if the cell is a boundary cell.
+            const bool bit0 = caMaskData(m, 0) != 0;
+            const bool bit31 = caMaskBoundary(m) != 0;
+
+            _data[j * _fullbox.w() + i] = bit0;
+            if (bit0 || bit31)
+                ++_used[(j / _size) * _nx + i / _size];
+        }
+    }
+}
+
+
+void ActiveTiles::removeCells(const CA::PointList& pl)
+{
+    for (CA::PointList::ConstIter ip = pl.begin(); ip != pl.end(); ++ip)
+    {
+        const CA::Unsigned x = ip->x() - _fullbox.x();
+        const CA::Unsigned y = ip->y() - _fullbox.y();
+
+        // A data cell is never a boundary cell.
+        if (!_data[y * _fullbox.w() + x])
+            continue;
+
+        _data[y * _fullbox.w() + x] = 0;
+        --_used[(y / _size) * _nx + x / _size];
+    }
+}
+
+
+void ActiveTiles::pin(const CA::BoxList& bl)
+{
+    for (CA::BoxList::ConstIter ibox = bl.begin(); ibox != bl.end(); ++ibox)
+    {
+        CA::Box box(*ibox);
+        box.limit(_fullbox);
+        if (box.empty())
+            continue;
+
+        const CA::Unsigned tx0 = (box.x() - _fullbox.x()) / _size;
+        const CA::Unsigned ty0 = (box.y() - _fullbox.y()) / _size;
+        const CA::Unsigned tx1 = (box.right() - 1 - _fullbox.x()) / _size;
+        const CA::Unsigned ty1 = (box.bottom() - 1 - _fullbox.y()) / _size;
+
+        for (CA::Unsigned ty = ty0; ty <= ty1; ++ty)
+            for (CA::Unsigned tx = tx0; tx <= tx1; ++tx)
+                _pinned[ty * _nx + tx] = 1;
+    }
+}
+
+
+void ActiveTiles::unpin()
+{
+    std::fill(_pinned.begin(), _pinned.end(), 0);
+}
+
+
+bool ActiveTiles::update(CA::CellBuffReal& WD, CA::Real ignore_wd)
+{
+    std::vector<char> wet(_nx * _ny, 0);
+
+    // Only the tiles in the domain can have water. Find the tiles
+    // with a data cell with at least the water depth that can be
+    // ignored, the cell with less water do not have any outflow.
+    for (CA::BoxList::ConstIter ibox = _domain.begin(); ibox != _domain.end(); ++ibox)
+    {
+        const CA::Box box(*ibox);
+
+        _wd.resize(box.size());
+        WD.retrieveData(box, &_wd[0], box.w(), box.h());
+
+        for (CA::Unsigned j = 0; j < box.h(); ++j)
+        {
+            const CA::Unsigned y = box.y() + j - _fullbox.y();
+            const CA::Unsigned ty = y / _size;
+
+            for (CA::Unsigned i = 0; i < box.w(); ++i)
+            {
+                const CA::Unsigned x = box.x() + i - _fullbox.x();
+                const CA::Unsigned tile = ty * _nx + x / _size;
+
+                if (wet[tile])
+                {
+                    // Skip the rest of the row of the tile.
+                    i = std::min(box.w(), (x / _size + 1) * _size + _fullbox.x() - box.x()) - 1;
+                    continue;
+                }
+
+                if (_data[y * _fullbox.w() + x] && _wd[j * box.w() + i] >= ignore_wd)
+                    wet[tile] = 1;
+            }
+        }
+    }
+
+    // The new state of the tiles. The active ones first and then the
+    // tiles around them.
+    std::vector<char> state(_nx * _ny, OFF);
+
+    for (CA::Unsigned k = 0; k < state.size(); ++k)
+    {
+        if (_used[k] && (wet[k] || _pinned[k]))
+            state[k] = ACTIVE;
+    }
+
+    for (CA::Unsigned ty = 0; ty < _ny; ++ty)
+    {
+        for (CA::Unsigned tx = 0; tx < _nx; ++tx)
+        {
+            if (state[ty * _nx + tx] != ACTIVE)
+                continue;
+
+            const CA::Unsigned ty0 = (ty > 0) ? ty - 1 : 0;
+            const CA::Unsigned tx0 = (tx > 0) ? tx - 1 : 0;
+            const CA::Unsigned ty1 = std::min(ty + 1, _ny - 1);
+            const CA::Unsigned tx1 = std::min(tx + 1, _nx - 1);
+
+            for (CA::Unsigned ny = ty0; ny <= ty1; ++ny)
+                for (CA::Unsigned nx = tx0; nx <= tx1; ++nx)
+                    if (_used[ny * _nx + nx] && state[ny * _nx + nx] == OFF)
+                        state[ny * _nx + nx] = HALO;
+        }
+    }
+
+    // Find the tiles added and removed from the domain.
+    std::vector<char> added(_nx * _ny, 0);
+    std::vector<char> removed(_nx * _ny, 0);
+    bool changed = false;
+
+    for (CA::Unsigned k = 0; k < state.size(); ++k)
+    {
+        added[k] = (_state[k] == OFF && state[k] != OFF);
+        removed[k] = (_state[k] != OFF && state[k] == OFF);
+        changed = changed || added[k] || removed[k];
+    }
+
+    _state.swap(state);
+
+    _added.clear();
+    _removed.clear();
+
+    if (changed)
+    {
+        std::vector<char> indomain(_nx * _ny, 0);
+        for (CA::Unsigned k = 0; k < _state.size(); ++k)
+            indomain[k] = (_state[k] != OFF);
+
+        makeBoxes(indomain, _domain);
+        makeBoxes(added, _added);
+        makeBoxes(removed, _removed);
+    }
+
+    return changed;
+}
+
+
+CA::Unsigned ActiveTiles::numActive() const
+{
+    return static_cast<CA::Unsigned>(std::count(_state.begin(), _state.end(), static_cast<char>(ACTIVE)));
+}
+
+
+CA::Box ActiveTiles::tileBox(CA::Unsigned tx, CA::Unsigned ty) const
+{
+    const CA::Unsigned x = tx * _size;
+    const CA::Unsigned y = ty * _size;
+
+    return CA::Box(_fullbox.x() + x, _fullbox.y() + y,
+        std::min(_size, _fullbox.w() - x), std::min(_size, _fullbox.h() - y));
+}
+
+
+void ActiveTiles::makeBoxes(const std::vector<char>& flags, CA::BoxList& bl) const
+{
+    bl.clear();
+
+    // The boxes of the previous row of tiles, which can be extended
+    // by the same run of tiles in the current row.
+    std::vector<CA::Box> open;
+
+    for (CA::Unsigned ty = 0; ty < _ny; ++ty)
+    {
+        std::vector<CA::Box> runs;
+
+        for (CA::Unsigned tx = 0; tx < _nx; ++tx)
+        {
+            if (!flags[ty * _nx + tx])
+                continue;
+
+            CA::Unsigned tx1 = tx;
+            while (tx1 + 1 < _nx && flags[ty * _nx + tx1 + 1])
+                ++tx1;
+
+            CA::Box run = CA::Box::Union(tileBox(tx, ty), tileBox(tx1, ty));
+
+            // Extend the box of the previous row with the same columns.
+            for (size_t k = 0; k < open.size(); ++k)
+            {
+                if (open[k].x() == run.x() && open[k].w() == run.w())
+                {
+                    run = CA::Box::Union(open[k], run);
+                    open.erase(open.begin() + k);
+                    break;
+                }
+            }
+
+            runs.push_back(run);
+            tx = tx1;
+        }
+
+        // The boxes that were not extended are complete.
+        for (size_t k = 0; k < open.size(); ++k)
+            bl.add(open[k]);
+
+        open.swap(runs);
+    }
+
+    for (size_t k = 0; k < open.size(); ++k)
+        bl.add(open[k]);
+}
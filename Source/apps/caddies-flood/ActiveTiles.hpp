@@ -0,0 +1,162 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef _ACTIVETILES_HPP_
+#define _ACTIVETILES_HPP_
+
+
+//! \file ActiveTiles.hpp
+//! Contains the class that manages the expanded computational domain
+//! as a set of square tiles of the grid. The domain is made by the
+//! tiles with water and by their neighbour tiles, and it can grow and
+//! shrink following the water.
+//! \date 2026-10
+
+
+#include"ca2D.hpp"
+#include"BaseTypes.hpp"
+#include"Box.hpp"
+#include"BoxList.hpp"
+#include"PointList.hpp"
+#include<vector>
+
+
+//! Manage the computational domain as the set of the active tiles,
+//! i.e. the tiles with a data cell with at least the water depth that
+//! can be ignored (or pinned by an event), plus the tiles around them
+//! (diagonal ones included). The water moves at most one cell per
+//! time step, thus if the tiles are updated at least once every size
+//! iterations, the water cannot leave the domain between two updates.
+//! The tiles without any data or boundary cell are never in the
+//! domain.
+class ActiveTiles
+{
+public:
+
+    //! Create the tiles of the given size (in cells) of the grid. The
+    //! MASK is used to identify the data and boundary cells.
+    ActiveTiles(CA::Grid& GRID, CA::CellBuffMask& MASK, CA::Unsigned size);
+
+    //! Read again the data cells from the MASK.
+    void setMask(CA::CellBuffMask& MASK);
+
+    //! Remove the given data cells, e.g. the upstream cells removed
+    //! from the MASK. A tile without any data or boundary cell left is
+    //! not used anymore.
+    void removeCells(const CA::PointList& pl);
+
+    //! Pin the tiles that intersect the given boxes, e.g. the areas of
+    //! the events. A pinned tile is always active.
+    void pin(const CA::BoxList& bl);
+
+    //! Unpin all the tiles.
+    void unpin();
+
+    //! Update the active tiles using the water depth of the tiles in
+    //! the domain and rebuild the domain.
+    //! \return true if the domain has changed.
+    bool update(CA::CellBuffReal& WD, CA::Real ignore_wd);
+
+    //! Return the computational domain.
+    const CA::BoxList& domain() const;
+
+    //! Return the tiles added to the domain by the last update.
+    const CA::BoxList& added() const;
+
+    //! Return the tiles removed from the domain by the last update.
+    const CA::BoxList& removed() const;
+
+    //! Return the size of the tiles, which is also the maximum number
+    //! of iterations between two updates.
+    CA::Unsigned size() const;
+
+    //! Return the number of active tiles.
+    CA::Unsigned numActive() const;
+
+protected:
+
+    //! The state of a tile.
+    enum State
+    {
+        OFF = 0,    //!< The tile is not in the domain.
+        HALO,       //!< The tile is in the domain since it is around an active one.
+        ACTIVE      //!< The tile has water or it is pinned.
+    };
+
+    //! Return the box of the given tile.
+    CA::Box tileBox(CA::Unsigned tx, CA::Unsigned ty) const;
+
+    //! Create the list of boxes of the tiles with the given flag. The
+    //! tiles of a row are merged in a single box and the boxes with
+    //! the same columns in consecutive rows are merged.
+    void makeBoxes(const std::vector<char>& flags, CA::BoxList& bl) const;
+
+private:
+
+    CA::Box      _fullbox;      //!< The box of the grid.
+    CA::Unsigned _size;         //!< The size of the tiles.
+    CA::Unsigned _nx;           //!< The number of tiles in the X direction.
+    CA::Unsigned _ny;           //!< The number of tiles in the Y direction.
+
+    std::vector<char> _data;    //!< True if a cell of the grid has data.
+    std::vector<CA::Unsigned> _used; //!< The number of data and boundary cells of a tile.
+    std::vector<char> _pinned;  //!< True if a tile is pinned.
+    std::vector<char> _state;   //!< The state of each tile.
+
+    CA::BoxList  _domain;       //!< The computational domain.
+    CA::BoxList  _added;        //!< The tiles added by the last update.
+    CA::BoxList  _removed;      //!< The tiles removed by the last update.
+
+    std::vector<CA::Real> _wd;  //!< The water depth of a box of the domain.
+};
+
+
+/// ----- Inline implementation ----- ///
+
+
+inline const CA::BoxList& ActiveTiles::domain() const
+{
+    return _domain;
+}
+
+
+inline const CA::BoxList& ActiveTiles::added() const
+{
+    return _added;
+}
+
+
+inline const CA::BoxList& ActiveTiles::removed() const
+{
+    return _removed;
+}
+
+
+inline CA::Unsigned ActiveTiles::size() const
+{
+    return _size;
+}
+
+#endif
@@ -81,6 +81,71 @@ std::ostream& operator<<(std::ostream& out, MODEL::Type& m)
 }
 
 
+// Transform an input string into a SIMD kernels enum.
+std::istream& operator>>(std::istream& in, SIMD::Type& s)
+{
+    CA::String tmp;
+    in >> tmp;
+
+    if (CA::compareCaseInsensitive(tmp, "none"))
+    {
+        s = SIMD::NONE;
+        return in;
+    }
+    if (CA::compareCaseInsensitive(tmp, "auto"))
+    {
+        s = SIMD::AUTO;
+        return in;
+    }
+    if (CA::compareCaseInsensitive(tmp, "sse4.2"))
+    {
+        s = SIMD::SSE42;
+        return in;
+    }
+    if (CA::compareCaseInsensitive(tmp, "avx2"))
+    {
+        s = SIMD::AVX2;
+        return in;
+    }
+    if (CA::compareCaseInsensitive(tmp, "avx512"))
+    {
+        s = SIMD::AVX512;
+        return in;
+    }
+    s = SIMD::UNKNOWN;
+    in.setstate(std::ios::failbit);
+    return in;
+}
+
+
+// Transform a SIMD kernels enum into an output string.
+std::ostream& operator<<(std::ostream& out, SIMD::Type& s)
+{
+    switch (s)
+    {
+    case SIMD::NONE:
+        out << "none";
+        break;
+    case SIMD::AUTO:
+        out << "auto";
+        break;
+    case SIMD::SSE42:
+        out << "sse4.2";
+        break;
+    case SIMD::AVX2:
+        out << "avx2";
+        break;
+    case SIMD::AVX512:
+        out << "avx512";
+        break;
+    default:
+        out << "UNKNOWN";
+    }
+
+    return out;
+}
+
+
 // Transform an input string into a physical variable enum.
 std::istream& operator>>(std::istream& in, PV::Type& pv)
 {
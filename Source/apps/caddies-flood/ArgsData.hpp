@@ -76,6 +76,27 @@ std::istream& operator>>(std::istream& in, MODEL::Type& m);
 std::ostream& operator<<(std::ostream& out, MODEL::Type& m);
 
 
+//! Identifies the SIMD kernels used by the CA functions of the model.
+struct SIMD
+{
+    enum Type
+    {
+        UNKNOWN = 0,
+        NONE,           //!< Use the scalar CA functions.
+        AUTO,           //!< Use the widest instruction set available.
+        SSE42,
+        AVX2,
+        AVX512
+    };
+};
+
+
+//! Transform an input string into a SIMD kernels enum.
+std::istream& operator>>(std::istream& in, SIMD::Type& s);
+//! Transform a SIMD kernels enum into an output string.
+std::ostream& operator<<(std::ostream& out, SIMD::Type& s);
+
+
 //! Public data structure that contains all the data set by the
 //! arguments.
 struct ArgsData
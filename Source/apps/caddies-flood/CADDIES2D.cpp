@@ -40,6 +40,13 @@ THE SOFTWARE.
 #include"TimePlot.hpp"
 #include"RasterGrid.hpp"
 #include"TSPlot.hpp"
+#include"WCA2Dsimd.hpp"
+#include"ActiveTiles.hpp"
+#include"DomainBoxes.hpp"
+#include"WetCells.hpp"
+#include"UpstreamCells.hpp"
+#include"ReachDomain.hpp"
+#include"LocalTimeSteps.hpp"
 #include<ctime>
 
 typedef void(*SetRunStatusCallbackFuncPtr)(void* owner, const std::string& status);
@@ -84,6 +91,42 @@ inline CA::Real fround(CA::Real n, unsigned d)
 }
 
 
+/* Advance the simulation time by the time step. Round the time to be
+   of 0.01 second precision and then check if it is a multiple of the
+   update period (with a 0.01 precision). If it is the case we need to
+   reset the time of the simulation. If we don't do this the floating
+   point error will creep into the time of simulation. */
+inline void advanceTime(CA::Real& t, CA::Real dt, CA::Real period_time_dt)
+{
+    t += dt;
+
+    CA::Real tround = fround(t, 2);
+    if (std::fmod(tround, period_time_dt) < static_cast<CA::Real>(0.01))
+    {
+        t = tround;
+    }
+}
+
+
+/* Return the number of iterations, starting from the current one that
+   ends at time t, that can be computed in a single sweep with the same
+   dt, i.e. only the last one can end at or after the stop time (an
+   update step, an output or the end of the simulation). The number is
+   at most maxsteps and iters. */
+inline CA::Unsigned blockSteps(CA::Unsigned maxsteps, CA::Unsigned iters, CA::Real t, CA::Real dt,
+    CA::Real period_time_dt, CA::Real t_stop)
+{
+    CA::Unsigned k = 1;
+    while (k < maxsteps && k < iters && t < t_stop)
+    {
+        advanceTime(t, dt, period_time_dt);
+        ++k;
+    }
+
+    return k;
+}
+
+
 /* Extend a domain */
 inline CA::Box extendBox(CA::Box extent, CA::Box& fullbox, CA::Unsigned lines)
 {
@@ -103,6 +146,119 @@ inline CA::Box extendBox(CA::Box extent, CA::Box& fullbox, CA::Unsigned lines)
 }
 
 
+/* Return the boxes of the domain that are inside the boxes of the
+   decomposition, the pieces that share a side are merged. */
+inline CA::BoxList intersectBoxes(const CA::BoxList& domain, const CA::BoxList& decomp)
+{
+    CA::BoxList bl;
+
+    for (CA::BoxList::ConstIter idom = domain.begin(); idom != domain.end(); ++idom)
+    {
+        for (CA::BoxList::ConstIter idec = decomp.begin(); idec != decomp.end(); ++idec)
+            bl.add(CA::Box::Intersect(*idom, *idec));
+    }
+
+    bl.coalesce();
+
+    return bl;
+}
+
+
+/* Decompose the box in boxes with at least the setup efficiency of
+   cells with a non zero value in TMP, the boxes without any of these
+   cells are removed. */
+inline void decomposeDomain(const CA::Box& box, CA::CellBuffReal& TMP, const Setup& setup, CA::BoxList& decomp)
+{
+    CA::BoxList boxes;
+    CA::domainDecomposition(box, TMP, 0.0, setup.decomp_eff, setup.decomp_lines, boxes);
+
+    decomp.clear();
+    for (CA::BoxList::ConstIter ibox = boxes.begin(); ibox != boxes.end(); ++ibox)
+    {
+        if (ibox->e() > 0.0)
+            decomp.add(*ibox);
+    }
+}
+
+
+/* Update the list of the wet cells, the cells of the list are scanned
+   if it is in use otherwise the cells of the domain. Return true if the
+   list is to be used, i.e. if the wet fraction is below the setup
+   threshold. The outflux of the cells added to, or removed from, a list
+   in use is cleared. No wet cell is next to these cells, thus no flux
+   is lost. */
+inline bool updateWetCells(WetCells& WET, bool compact, bool unpin, const CA::BoxList& domain,
+    CA::Grid& GRID, CA::CellBuffReal& WD, CA::EdgeBuffReal& OUTF1, CA::EdgeBuffReal& OUTF2,
+    CA::Real ignore_wd, const Setup& setup)
+{
+    // The events do not pin their cells once they are finished.
+    if (unpin)
+        WET.unpin();
+
+    if (compact)
+        WET.update(WD, ignore_wd);
+    else
+        WET.update(WD, ignore_wd, domain);
+
+    bool use = WET.wetFraction() < setup.wet_fraction;
+
+    if (compact || use)
+    {
+        clearEdges(WET.added(), GRID, OUTF1);
+        clearEdges(WET.added(), GRID, OUTF2);
+        clearEdges(WET.removed(), GRID, OUTF1);
+        clearEdges(WET.removed(), GRID, OUTF2);
+    }
+
+    return use;
+}
+
+
+/* Compute the velocity of each tile of the local time steps using the
+   outflux (OUTF for level zero, LAST otherwise) and the time step of
+   its last step. The possible dt of a tile is the minimum between the
+   possible dt of its cells and the one given by its maximum velocity.
+   The maximum velocity and the minimum possible dt of all the tiles
+   are reduced into VAMAX and DTMIN. */
+inline void velocityTiles(SIMD::Type simd, const LocalTimeSteps& LTS, CA::Grid& GRID,
+    CA::CellBuffReal& V, CA::CellBuffReal& A, CA::CellBuffReal& WD, CA::CellBuffReal& ELV,
+    CA::EdgeBuffReal& OUTF, CA::EdgeBuffReal& LAST, CA::CellBuffMask& MASK, CA::Alarms& ALARMS,
+    CA::ReductionReal& VAMAX, CA::ReductionReal& DTMIN,
+    CA::Real tol_va, CA::Real tol_slope, CA::Real dt, CA::Real irough, CA::Real upstr_elv,
+    CA::Real alpha, const Setup& setup, std::vector<CA::Real>& tiledt)
+{
+    CA::Real vamax = 0.0;
+    CA::Real dtmin = setup.time_updatedt;
+
+    tiledt.assign(LTS.numTiles(), setup.time_maxdt);
+
+    for (CA::Unsigned k = 0; k < LTS.numTiles(); ++k)
+    {
+        if (LTS.tileDomain(k).size() == 0)
+            continue;
+
+        VAMAX.reset(0.0);
+        DTMIN.reset(setup.time_updatedt);
+        velocityDiffusiveSIMD(simd, LTS.tileDomain(k), GRID, V, A,
+            WD, ELV, (LTS.level(k) == 0) ? OUTF : LAST, MASK, ALARMS, VAMAX, DTMIN,
+            tol_va, tol_slope, dt * (1 << LTS.level(k)), irough, upstr_elv);
+
+        const CA::Real va = VAMAX.value();
+        const CA::Real pdt = DTMIN.value();
+
+        vamax = std::max(vamax, va);
+        dtmin = std::min(dtmin, pdt);
+
+        tiledt[k] = std::min(tiledt[k], pdt);
+        if (va > 0.0)
+            tiledt[k] = std::min(tiledt[k], alpha * GRID.length() / va);
+    }
+
+    VAMAX.reset(vamax);
+    DTMIN.reset(dtmin);
+}
+
+
 //! Output to console the information about the simulation.
 void outputConsole(CA::Unsigned iter, CA::Unsigned oiter, CA::Real t, CA::Real dt,
     CA::Real avgodt, CA::Real minodt, CA::Real maxodt,
@@ -187,9 +343,9 @@ void computeDT(CA::Real& dt, CA::Unsigned& dtfrac, CA::Real dtn1, const Setup& s
 #include CA_2D_INCLUDE(infiltration)
 
 #include CA_2D_INCLUDE(setBoundaryEle)
-#include CA_2D_INCLUDE(removeUpstr)
 #include CA_2D_INCLUDE(updatePEAKC)
 #include CA_2D_INCLUDE(updatePEAKE)
+#include CA_2D_INCLUDE(computeDomainCells)
 
 #include CA_2D_INCLUDE(outflowWCA2Dv2)
 #include CA_2D_INCLUDE(waterdepth)
@@ -306,13 +462,15 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
     }
     // ---- CELL BUFFERS ----
 
-    // Create the water depth cell buffer.
+    // Create the water depth cell buffer. It is created just after the
+    // elevation, thus with the cell records (the "cell-record" option)
+    // the rows of the two buffers read by the outflow are interleaved.
     CA::CellBuffReal WD(GRID);
 
     // Create the MASK cell buffer. The mask is useful to check which
     // cell has data and nodata and which cell has neighbourhood with
     // data.
-    CA::CellBuffState MASK(GRID);
+    CA::CellBuffMask MASK(GRID);
 
     // Create the velocity cell buffer with the speed of the velocity
     CA::CellBuffReal V(GRID);
@@ -320,18 +478,6 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
     // Create the velocity cell buffer with the angle of the velocity
     CA::CellBuffReal A(GRID);
 
-    // If the we are using the WCA2Dv2 model create the buffer with the
-    // dt value.
-    cpp11::shared_ptr<CA::CellBuffReal> PDT;
-
-    // Allocate the buffer for the time step
-    // Only WCA2Dv1 does not need this.
-    if (setup.model_type != MODEL::WCA2Dv1)
-    {
-        PDT.reset(new CA::CellBuffReal(GRID));
-        (*PDT).fill(fulldomain, setup.time_updatedt);
-    }
-
     // ---- EDGES BUFFERS ----
 
     // Create the outflow edge buffer(s). Many models use a double buffer
@@ -351,18 +497,45 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
         (*PTOT).clear();
     }
 
+    // Allocate the buffer with the last outflux of each edge of the
+    // tiles that do not step at every iteration with the local time
+    // steps. Only WCA2Dv2 (with a domain not expanded) does need this.
+    cpp11::shared_ptr<CA::EdgeBuffReal> PLAST;
+    if (setup.model_type == MODEL::WCA2Dv2 && !setup.expand_domain && setup.lts_levels > 0)
+    {
+        PLAST.reset(new CA::EdgeBuffReal(GRID));
+        (*PLAST).clear();
+    }
+
 
     // ---- ALARMS ----
 
     // Create the alarm(s) checked during the outflux computation.
     // Alarm 1: indicates when there is going to be an outflux outside of the computational domain.
-    CA::Alarms  OUTFALARMS(GRID, 1);
+    // Alarm 2-5: indicates the outflux through the east, north, west and south side of the domain.
+    CA::Alarms  OUTFALARMS(GRID, 5);
 
     // Create the alarm(s) checked during the velocity computation
     // Alarm 1: indicates when there is still water movement over the elevation threshold.
     CA::Alarms  VELALARMS(GRID, 1);
 
 
+    // ---- REDUCTIONS ----
+
+    // Create the reductions computed during the velocity computation.
+    // The maximum velocity and the minimum possible dt (WCA2Dv2 only).
+    CA::ReductionReal VAMAX(GRID, CA::Seq::Max);
+    CA::ReductionReal DTMIN(GRID, CA::Seq::Min);
+
+#ifdef CA2D_TASKS
+    // ---- TASKS ----
+
+    // The list of CA functions executed by a single team of threads
+    // (WCA2Dv1 when the domain box is not expanded).
+    CA::TaskList TEAM(GRID);
+#endif
+
+
     // ---- SCALAR VALUES ----
 
     CA::Unsigned iter = 0;              // The actual iteration number.
@@ -420,6 +593,11 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
     CA::Real     wd_volume = 0.0;
     CA::Real     inf_volume = 0.0;
 
+    // The water added or set by the events in a time step, and in each
+    // time step of a temporal block.
+    WDSources    sources;
+    std::vector<WDSources> block_sources;
+
     // Maximum velocity.
     CA::Real     vamax = 0.0;
 
@@ -439,6 +617,13 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
     // possible expanding domain.
     bool         checkbox = setup.expand_domain;
 
+    // The SIMD kernels used by the WCA2Dv2 CA functions, if NONE the
+    // scalar CA functions are used.
+    SIMD::Type   simd = selectSIMD(setup.simd_kernels);
+
+    if (setup.output_console)
+        std::cout << "SIMD Kernels : " << simd << std::endl;
+
     // Variable which indicates if the PEAK values need to be updated.
     // The PEAK values can be updated on every update step or on every
     // steps.
@@ -463,7 +648,7 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
     //***********************//
 
     // The MASK is used to check if a cell with nodata has a neighbour
-    // with data (Bit 31 set to true in the MASK). This kind of cells
+    // with data (boundary bit set to true in the MASK). This kind of cells
     // are called boundary cells and they are ignored by the computation
     // (not visited), i.e. the rain is not added into them, the outflow
     // are not computed. However, these boundary cells are used as
@@ -479,6 +664,35 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
     // Set the boundary cell elevation to the given boundary_elv value.
     CA::Execute::function(fulldomain, setBoundaryEle, GRID, ELV, MASK, setup.boundary_elv);
 
+    // ---- REACHABLE DOMAIN ----
+
+    // If requested, only the cells that the water of the events can
+    // reach are computed. The unreachable data cells are removed from
+    // the MASK and the ones on its edge become boundary cells that
+    // keep their elevation (after the setting of the boundary
+    // elevation).
+    cpp11::shared_ptr<ReachDomain> REACH;
+    if (setup.reach_domain)
+    {
+        CA::CellBuffState RCH(GRID);
+        if (!RCH.loadData(setup.preproc_name + "_REACH", "0"))
+        {
+            std::cerr << "Error while loading the Reachable domain pre-processed file" << std::endl;
+            return 1;
+        }
+
+        REACH.reset(new ReachDomain(GRID, MASK, RCH));
+
+        if (setup.output_console)
+        {
+            std::cout << "Reachable domain : " << REACH->cells() << " cells" << std::endl;
+            std::cout << "------------------------------------------" << std::endl;
+        }
+    }
+
+    // Warn only once when the water reaches the edge of the domain.
+    bool reach_warned = false;
+
     //CA_DUMP_BUFF(ELV,0);  
 
     // ---- INFILTRATION ----
@@ -570,6 +784,38 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
     // Time Step plot manager
     TSPlot tsplot(basefilename + "_ts.csv", setup.ts_plot);
 
+    // -- DOMAIN DECOMPOSITION --
+
+    // The domain of the data and boundary cells, i.e. the cells
+    // visited by the water depth update. If requested, the grid is
+    // decomposed in the boxes with at least the given efficiency of
+    // these cells, otherwise the domain is the full grid. A is used as
+    // temporary buffer. The reachable domain limits the grid.
+    CA::Box      databox = (REACH && REACH->cells() > 0) ? REACH->extent() : fullbox;
+    CA::BoxList  datadomain(databox);
+    if (setup.decomp_eff > 0.0)
+    {
+        CA::Execute::function(fulldomain, computeDomainCells, GRID, A, MASK);
+        decomposeDomain(databox, A, setup, datadomain);
+
+        if (setup.output_console)
+        {
+            CA::Unsigned cells = 0;
+            for (CA::BoxList::ConstIter ibox = datadomain.begin(); ibox != datadomain.end(); ++ibox)
+                cells += ibox->size();
+
+            std::cout << "Domain decomposition : " << datadomain.size() << " boxes with "
+                << (100.0 * cells) / fullbox.size() << "% of the cells" << std::endl;
+            std::cout << "------------------------------------------" << std::endl;
+        }
+    }
+
+    // If the upstream cells are ignored, the data cells are sorted by
+    // elevation once, thus each removal visits only the cells removed.
+    cpp11::shared_ptr<UpstreamCells> UPSTR;
+    if (setup.ignore_upstream)
+        UPSTR.reset(new UpstreamCells(GRID, ELV, MASK, datadomain));
+
     // -- INITIALISE ---
 
     // Clear the buffer to zero (borders included).
@@ -579,11 +825,44 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
     V.clear();
     WD.clear();
 
+    // If the domain is not expanded, the tiles of the domain can step
+    // with a local time step, a power of two multiple of the global
+    // one, computed by WCA2Dv2 at each update step. The areas of the
+    // events are pinned to the global time step.
+    cpp11::shared_ptr<LocalTimeSteps> LTS;
+    if (PLAST)
+    {
+        LTS.reset(new LocalTimeSteps(GRID, datadomain, setup.lts_tile, setup.lts_levels + 1));
+        LTS->pin(compdomain);
+
+        if (setup.output_console)
+        {
+            std::cout << "Local time steps : " << LTS->levels() << " levels of tiles of "
+                << setup.lts_tile << " cells" << std::endl;
+            std::cout << "------------------------------------------" << std::endl;
+        }
+    }
+
+    // The iteration of the update step and the possible dt of each tile.
+    CA::Unsigned lts_iter = 0;
+    std::vector<CA::Real> tile_dt;
+
+    // If the domain is not expanded, only the rows of the wet cells, and
+    // of a halo around them, are computed by WCA2Dv2 when the wet
+    // fraction of the domain is below the setup threshold. The areas of
+    // the events are pinned in the list. The list is not used with the
+    // local time steps.
+    cpp11::shared_ptr<WetCells> WET;
+    if (!setup.expand_domain && setup.model_type == MODEL::WCA2Dv2 && setup.wet_fraction > 0.0 && !LTS)
+    {
+        WET.reset(new WetCells(GRID, MASK, datadomain, setup.wet_halo));
+        WET->pin(compdomain);
+    }
+
     // If there is not request to expand domain. Set the computational and extend domain to full domain.
     if (!setup.expand_domain)
     {
-        compdomain.clear();
-        compdomain.add(fullbox);
+        compdomain = datadomain;
     }
     else
     {
@@ -591,6 +870,37 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
         seqdomain = compdomain;
     }
 
+    // If the domain is expanded by tiles, the computational domain is
+    // made by the tiles with water, or with an event, and the tiles
+    // around them. Otherwise each area of the events is a box that is
+    // expanded on the sides crossed by an outflux.
+    cpp11::shared_ptr<ActiveTiles> TILES;
+    if (setup.expand_domain && setup.domain_tile > 0)
+    {
+        TILES.reset(new ActiveTiles(GRID, MASK, setup.domain_tile));
+        TILES->pin(compdomain);
+        TILES->update(WD, ignore_wd);
+        compdomain = intersectBoxes(TILES->domain(), datadomain);
+    }
+
+    // If true the boxes of the domain are expanded. The boxes are
+    // merged only when they touch.
+    bool expand_box = setup.expand_domain && !TILES;
+    cpp11::shared_ptr<DomainBoxes> BOXES;
+    if (expand_box)
+    {
+        BOXES.reset(new DomainBoxes(fullbox, datadomain));
+        BOXES->add(compdomain);
+        compdomain = BOXES->domain();
+    }
+
+    // If true only the list of the wet cells is computed. The list is
+    // updated at least once every halo iterations.
+    bool compact = false;
+    CA::Unsigned wet_iter = 0;
+    if (WET)
+        compact = updateWetCells(*WET, compact, false, compdomain, GRID, WD, OUTF1, OUTF2, ignore_wd, setup);
+
 
     // -- CALCULATE POSSIBLE INITIAL DT ---
 
@@ -662,9 +972,46 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
         // The raster has not been written this iteration.
         RGwritten = false;
 
-        // If there is the request to expand the domain.
+        // Update the active tiles at least once every tile size
+        // iterations, thus the water cannot leave the domain.
+        if (TILES && iter % TILES->size() == 0)
+        {
+            // The events do not pin their tiles once they are finished.
+            if (t > t_end_events)
+                TILES->unpin();
+
+            if (TILES->update(WD, ignore_wd))
+            {
+                // Clear the old outflux of the tiles added to the
+                // domain and the velocity of the tiles removed. The
+                // outflux of the tiles removed is cleared too, the
+                // water depth update does not erase it anymore and it
+                // would be read by the cells around them. No wet cell
+                // is next to a removed tile, thus no flux is lost.
+                OUTF1.fill(TILES->added(), 0.0);
+                OUTF2.fill(TILES->added(), 0.0);
+                OUTF1.fill(TILES->removed(), 0.0);
+                OUTF2.fill(TILES->removed(), 0.0);
+                V.fill(TILES->removed(), 0.0);
+                A.fill(TILES->removed(), 0.0);
+
+                compdomain = intersectBoxes(TILES->domain(), datadomain);
+            }
+        }
+
+        // Update the list of the wet cells at least once every halo
+        // iterations, thus the water cannot leave the list.
+        if (WET && compact && wet_iter >= WET->halo())
+        {
+            compact = updateWetCells(*WET, compact, t > t_end_events, compdomain, GRID, WD, OUTF1, OUTF2,
+                ignore_wd, setup);
+            wet_iter = 0;
+        }
+        ++wet_iter;
+
+        // If there is the request to expand the domain box.
         // Deactivate Box alarm(s) and set them.
-        if (setup.expand_domain)
+        if (expand_box)
         {
             OUTFALARMS.deactivateAll();
             OUTFALARMS.set();
@@ -677,6 +1024,15 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
         {
             outputConsole(iter, oiter, t, dt, avgodt, minodt, maxodt, vamax, upstr_elv, compdomain, setup);
 
+            if (LTS)
+            {
+                std::cout << "Tiles of each local time step level:";
+                for (CA::Unsigned l = 0; l < LTS->levels(); ++l)
+                    std::cout << " " << LTS->numLevel(l);
+                std::cout << std::endl;
+                std::cout << "-----" << std::endl;
+            }
+
             oiter = 0;
             avgodt = 0.0;
             minodt = setup.time_maxdt;  // Output step minimum dt.
@@ -708,18 +1064,7 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
         // --- SIMULATION TIME ---
 
         // Set the new time step.
-        t += dt;
-
-        // Round the time step to be of 0.01 second precision and then
-        // check if it is a multiple of 60 (with a 0.01 precision). If it
-        // is the case we need to reset the time of the simulation. If we
-        // don't do this the floating point error will creep into the time
-        // of simulation.
-        CA::Real tround = fround(t, 2);
-        if (std::fmod(tround, period_time_dt) < static_cast<CA::Real>(0.01))
-        {
-            t = tround;
-        }
+        advanceTime(t, dt, period_time_dt);
 
         // Compute output step information.
         avgodt += dt;
@@ -727,45 +1072,231 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
         if (dt > maxodt) maxodt = dt;
         if (dt < minodt) minodt = dt;
 
+        // If the water depth was already computed with the outflux, in
+        // the same sweep or by the same team of threads.
+        bool fused = false;
+
+        // If the velocity of the update step was already computed by
+        // the same sweep of the outflux (a pipelined update).
+        bool pipelined = false;
+
+        // The cells added by the domain expansion.
+        CA::BoxList newcells;
+
+        // --- EXTRA LATERAL EVENT(s) ---
+
+        // Get the eventual rain, inflow and water level events of this
+        // time step. They are applied by the update of the water depth.
+        sources.clear();
+        rain_manager.add(sources, t, dt);
+        inflow_manager.add(sources, t, dt);
+        wl_manager.add(sources, t, dt);
+
         // --- COMPUTE OUTFLUX ---
         switch (setup.model_type)
         {
         case MODEL::WCA2Dv1:
-            // Clear the outflow buffer to zero (borders included).
-            OUTF1.clear();
+            // Clear the outflow buffer to zero only inside the
+            // computational domain, the outflow is never computed outside
+            // it and the domain can only grow.
+            OUTF1.fill(compdomain, 0.0);
+
+#ifdef CA2D_TASKS
+            // If the domain box is not expanded, the outflow and the
+            // water depth are computed by the same team of threads,
+            // which waits on a barrier between them.
+            if (!expand_box)
+            {
+                TEAM.clear();
+                TEAM.add(compdomain, CA::makeFunction(outflowWCA2Dv1, OUTF1, ELV, WD, MASK, OUTFALARMS,
+                    ignore_wd, tol_delwl, dt, irough));
+                TEAM.add(compdomain, CA::makeFunction(waterdepthWCA2Dv1, WD, OUTF1, (*PTOT), MASK,
+                    dt, period_time_dt));
+                TEAM.run();
+
+                fused = true;
+                break;
+            }
+#endif
 
             // Compute outflow using WCA2Dv1.
-            // Check if there is an outflow in the border of the box.
-            CA::Execute::function(compdomain, outflowWCA2Dv1, GRID, OUTF1, ELV, WD, MASK, OUTFALARMS,
-                ignore_wd, tol_delwl, dt, irough);
+            // Check if there is an outflow in the border of the box. If
+            // the boxes are expanded, each box is computed apart to know
+            // which of its sides are crossed.
+            for (size_t i = 0; i < (expand_box ? BOXES->size() : 1); ++i)
+            {
+                CA::Execute::function(expand_box ? BOXES->domain(i) : compdomain, outflowWCA2Dv1, GRID,
+                    OUTF1, ELV, WD, MASK, OUTFALARMS, ignore_wd, tol_delwl, dt, irough);
+                if (expand_box)
+                    BOXES->check(i, OUTFALARMS);
+            }
 
             break;
         case MODEL::WCA2Dv2:
             // Compute outflow using WCA2Dv2.
             // This save a division operation for each cell.
             CA::Real ratio_dt = dt / previous_dt;
-            CA::Execute::function(compdomain, outflowWCA2Dv2, GRID, (*POUTF1), (*POUTF2),
-                ELV, WD, MASK, OUTFALARMS, ignore_wd, tol_delwl, dt, ratio_dt, irough);
+
+            // With the local time steps, the tiles of the levels that
+            // step at this iteration compute the outflow with their
+            // time step and the previous outflux of their last step,
+            // which is in the double buffer for level zero and in the
+            // recorded one for the other levels. At the first iteration
+            // of an update step, the ratio and the previous outflux
+            // depend on the old level of a tile. The water depth of the
+            // whole domain is updated at each iteration.
+            if (LTS)
+            {
+                const CA::Unsigned top = LTS->stepLevel(lts_iter);
+
+                for (CA::Unsigned l = 0; l <= top; ++l)
+                {
+                    const CA::Real dtl = dt * (1 << l);
+
+                    if (lts_iter == 0)
+                    {
+                        for (CA::Unsigned old = 0; old < LTS->levels(); ++old)
+                            outflowWCA2Dv2SIMD(simd, LTS->domain(l, old), GRID, (*POUTF1),
+                                (old == 0) ? (*POUTF2) : (*PLAST), ELV, WD, MASK, OUTFALARMS,
+                                ignore_wd, tol_delwl, dtl, dtl / (previous_dt * (1 << old)), irough);
+                    }
+                    else
+                    {
+                        outflowWCA2Dv2SIMD(simd, LTS->domain(l), GRID, (*POUTF1),
+                            (l == 0) ? (*POUTF2) : (*PLAST), ELV, WD, MASK, OUTFALARMS,
+                            ignore_wd, tol_delwl, dtl, 1.0, irough);
+                    }
+                }
+
+                // Record the outflux of the tiles that do not step at
+                // the next iteration.
+                for (CA::Unsigned l = 1; l <= top; ++l)
+                    recordOutflow(LTS->domain(l), GRID, (*PLAST), (*POUTF1));
+
+                ++lts_iter;
+                break;
+            }
+
+            // Compute also the water depth in the same sweep if the
+            // domain is a single box and its expansion is inside the
+            // grid. The water depth of the cells added by the expansion
+            // is computed later.
+            fused = !compact && setup.fused_sweep && compdomain.size() == 1 &&
+                (!expand_box || (BOXES->size() == 1 && GRID.box().inside(extendBox(compdomain.extent(), fullbox, 1))));
+
+            if (fused)
+            {
+                // Compute also the next iterations with the same dt in
+                // the same sweep (a temporal block), if none of them but
+                // the last one updates the dt, outputs or ends the
+                // simulation. The time, the counters and the sources of
+                // these iterations are advanced here.
+                CA::Unsigned block = 1;
+                if (setup.block_steps > 1 && !expand_box && !setup.update_peak_dt)
+                {
+                    CA::Real t_stop = std::min(time_dt, setup.time_end);
+                    t_stop = std::min(t_stop, std::min(tp_manager.nextTime(), rg_manager.nextTime()));
+                    if (setup.output_console)
+                        t_stop = std::min(t_stop, time_output);
+                    // The block cannot pass over the next update of the
+                    // active tiles.
+                    CA::Unsigned iters = std::min(iter_dt, setup.time_maxiters - iter);
+                    if (TILES)
+                        iters = std::min(iters, TILES->size() - iter % TILES->size());
+                    block = blockSteps(setup.block_steps, iters, t, dt, period_time_dt, t_stop);
+                }
+
+                block_sources.resize(block);
+                block_sources[0] = sources;
+
+                for (CA::Unsigned s = 1; s < block; ++s)
+                {
+                    // The end of the previous iteration and the start
+                    // of this one.
+                    start_updatedt += dt;
+                    previous_dt = dt;
+                    --iter_dt;
+                    iter++;
+                    oiter++;
+                    advanceTime(t, dt, period_time_dt);
+                    avgodt += dt;
+
+                    block_sources[s].clear();
+                    rain_manager.add(block_sources[s], t, dt);
+                    inflow_manager.add(block_sources[s], t, dt);
+                    wl_manager.add(block_sources[s], t, dt);
+                }
+
+                // If the last iteration updates the dt, compute also
+                // its velocity in the same sweep, a row as soon as the
+                // outflux around it is computed. The velocity and the
+                // reductions are cleared here instead of by the update.
+                pipelined = setup.pipelined_update && !expand_box && !useInfiltration &&
+                    (t >= time_dt || iter_dt == 1);
+
+                if (pipelined)
+                {
+                    if (setup.ignore_upstream)
+                    {
+                        VELALARMS.deactivateAll();
+                        VELALARMS.set();
+                    }
+
+                    V.fill(compdomain, 0.0);
+                    A.fill(compdomain, 0.0);
+                    VAMAX.reset(0.0);
+                    DTMIN.reset(setup.time_updatedt);
+
+                    outflowWaterdepthVelocitySIMD(simd, compdomain, GRID, (*POUTF1), (*POUTF2),
+                        ELV, WD, MASK, OUTFALARMS, ignore_wd, tol_delwl, dt, ratio_dt, irough, block_sources,
+                        V, A, VELALARMS, VAMAX, DTMIN, tol_va, tol_slope, upstr_elv);
+                }
+                else if (block > 1)
+                    outflowWaterdepthStepsSIMD(simd, compdomain, GRID, (*POUTF1), (*POUTF2),
+                        ELV, WD, MASK, OUTFALARMS, ignore_wd, tol_delwl, dt, ratio_dt, irough, block_sources);
+                else
+                    outflowWaterdepthSIMD(simd, compdomain, GRID, (*POUTF1), (*POUTF2),
+                        ELV, WD, MASK, OUTFALARMS, ignore_wd, tol_delwl, dt, ratio_dt, irough, sources);
+
+                // The swap below must leave the outflux of the last
+                // step in POUTF2.
+                if (block % 2 == 0)
+                    std::swap(POUTF1, POUTF2);
+
+                if (expand_box)
+                    BOXES->check(0, OUTFALARMS);
+                break;
+            }
+
+            // Compute only the rows of the list of the wet cells.
+            if (compact)
+            {
+                outflowWCA2Dv2SIMD(simd, WET->rows(), GRID, (*POUTF1), (*POUTF2),
+                    ELV, WD, MASK, OUTFALARMS, ignore_wd, tol_delwl, dt, ratio_dt, irough);
+                break;
+            }
+
+            // If the boxes are expanded, each box is computed apart to
+            // know which of its sides are crossed.
+            for (size_t i = 0; i < (expand_box ? BOXES->size() : 1); ++i)
+            {
+                outflowWCA2Dv2SIMD(simd, expand_box ? BOXES->domain(i) : compdomain, GRID, (*POUTF1), (*POUTF2),
+                    ELV, WD, MASK, OUTFALARMS, ignore_wd, tol_delwl, dt, ratio_dt, irough);
+                if (expand_box)
+                    BOXES->check(i, OUTFALARMS);
+            }
 
             break;
         }
 
-        // If there is a request to expand the domain.
-        // Get the alarms states.
-        if (setup.expand_domain)
+        // If there is a request to expand the domain boxes, grow the
+        // boxes on the sides crossed by an outflux.
+        if (expand_box && BOXES->grow())
         {
-            OUTFALARMS.get();
+            compdomain = BOXES->domain();
 
-            // Check if the box alarm is active, that mean there is some
-            // outflux on the border of the computational domain.
-            if (OUTFALARMS.isActivated(0))
-            {
-                // Set the computational domain to be the extend version and
-                // create the new extended one.
-                CA::Box extent(compdomain.extent());
-                compdomain.clear();
-                compdomain.add(extendBox(extent, fullbox, 1));
-            }
+            if (fused)
+                newcells = BOXES->added();
         }
 
         // --- UPDATE WL AND WD ---
@@ -774,12 +1305,20 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
         case MODEL::WCA2Dv1:
             // Update the water depth with the outflux and store the total
             // amount of outflux for the WCA2Dv1 model. 
-            CA::Execute::function(compdomain, waterdepthWCA2Dv1, GRID, WD, OUTF1, (*PTOT), MASK, dt, period_time_dt);
+            if (!fused)
+                CA::Execute::function(compdomain, waterdepthWCA2Dv1, GRID, WD, OUTF1, (*PTOT), MASK, dt, period_time_dt);
+            applySources(GRID, WD, ELV, MASK, sources);
             break;
 
         case MODEL::WCA2Dv2:
-            // Generic water depth, use OUTF1, erase OUTF2.
-            CA::Execute::function(compdomain, waterdepth, GRID, WD, (*POUTF1), (*POUTF2), MASK, dt);
+            // Generic water depth, use OUTF1, erase OUTF2, and add the
+            // sources. If the sweep was fused only the new cells are left.
+            if (compact)
+                waterdepthSIMD(simd, WET->rows(), GRID, WD, (*POUTF1), (*POUTF2), ELV, MASK, dt, sources);
+            else if (!fused)
+                waterdepthSIMD(simd, compdomain, GRID, WD, (*POUTF1), (*POUTF2), ELV, MASK, dt, sources);
+            else if (newcells.size() > 0)
+                waterdepthSIMD(simd, newcells, GRID, WD, (*POUTF1), (*POUTF2), ELV, MASK, dt, WDSources());
 
             // Swap the double buffer
             // Now POUTF1 is zeroed while POUTF2 contains the previous flux.
@@ -789,17 +1328,6 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
 
         start_updatedt += dt;
 
-        // --- EXTRA LATERAL EVENT(s) ---
-
-        // Add the eventual rain events.
-        rain_manager.add(WD, MASK, t, dt);
-
-        // Add the eventual inflow events.
-        inflow_manager.add(WD, MASK, t, dt);
-
-        // Add the eventual water level events.
-        wl_manager.add(WD, ELV, MASK, t, dt);
-
         // --- COMPUTE NEXT DT, I.E. PERIOD STEP ---
 
         // Update previous dt
@@ -819,7 +1347,7 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
                 // Clear the angle.
                 A.clear();
 
-                CA::Execute::function(fulldomain, infiltration, GRID, WD, MASK, A, inf_updatedt);
+                CA::Execute::function(datadomain, infiltration, GRID, WD, MASK, A, inf_updatedt);
 
                 if (setup.check_vols)
                 {
@@ -830,7 +1358,7 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
                 }
             }
 
-            if (setup.ignore_upstream)
+            if (setup.ignore_upstream && !pipelined)
             {
                 // Deactivate the alarms checked during the velocity
                 // calculation.
@@ -857,35 +1385,72 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
             switch (setup.model_type)
             {
             case MODEL::WCA2Dv1:
-                // Clear the Velocity and angle.
-                V.clear();
-                A.clear();
+                // Clear the Velocity and angle inside the computational
+                // domain. The infiltration uses the angle over the full
+                // domain.
+                V.fill(compdomain, 0.0);
+                if (useInfiltration)
+                    A.clear();
+                else
+                    A.fill(compdomain, 0.0);
 
                 // Compute the velocity using the total outflux.
                 // Attention the tolerance is different here. 
                 // Check if there is water movement over the upstream elevation threshold.
+                // Reduce the maximum velocity.
+                VAMAX.reset(0.0);
                 CA::Execute::function(compdomain, velocityWCA2Dv1, GRID, V, A, WD, ELV, (*PTOT), MASK, VELALARMS,
-                    tol_va, period_time_dt, irough, upstr_elv);
+                    VAMAX, tol_va, period_time_dt, irough, upstr_elv);
 
                 // CLear the total outflux.
                 (*PTOT).clear();
                 break;
 
             case MODEL::WCA2Dv2:
-                // Clear the Velocity and angle.
-                V.clear();
-                A.clear();
+                // The velocity was already computed by the sweep of the
+                // outflux with a pipelined update.
+                if (!pipelined)
+                {
+                    // Clear the Velocity and angle inside the computational
+                    // domain. The infiltration uses the angle over the full
+                    // domain.
+                    V.fill(compdomain, 0.0);
+                    if (useInfiltration)
+                        A.clear();
+                    else
+                        A.fill(compdomain, 0.0);
+
+                    // Compute the velocity using the last outflux (OUTF2)
+                    // Compute dt using Hunter formula
+                    // Reduce the maximum velocity and the minimum possible
+                    // dt, which is never over the update dt.
+                    // With the local time steps, the velocity of each tile
+                    // uses the outflux and the time step of its last step,
+                    // and the possible dt of each tile is kept.
+                    VAMAX.reset(0.0);
+                    DTMIN.reset(setup.time_updatedt);
+                    if (LTS)
+                        velocityTiles(simd, *LTS, GRID, V, A, WD, ELV, (*POUTF2), (*PLAST), MASK, VELALARMS, VAMAX, DTMIN,
+                            tol_va, tol_slope, dt, irough, upstr_elv, alpha, setup, tile_dt);
+                    else
+                        velocityDiffusiveSIMD(simd, compdomain, GRID, V, A,
+                            WD, ELV, (*POUTF2), MASK, VELALARMS, VAMAX, DTMIN,
+                            tol_va, tol_slope, dt, irough, upstr_elv);
+                }
 
-                // Compute the velocity using the last outflux (OUTF2)
-                // Compute dt using Hunter formula
-                CA::Execute::function(compdomain, velocityDiffusive, GRID, V, A, (*PDT),
-                    WD, ELV, (*POUTF2), MASK, VELALARMS,
-                    tol_va, tol_slope, dt, irough, upstr_elv);
+                // Rebuild the list of the wet cells after the velocity
+                // pass, the list can be switched on or off.
+                if (WET)
+                {
+                    compact = updateWetCells(*WET, compact, t > t_end_events, compdomain, GRID, WD, OUTF1, OUTF2,
+                        ignore_wd, setup);
+                    wet_iter = 0;
+                }
                 break;
             }
 
             // Retrieve the maximum velocity 
-            V.sequentialOp(compdomain, vamax, CA::Seq::MaxAbs);
+            vamax = VAMAX.value();
 
             // Find the maximum velocity
             CA::Real grid_max_va = vamax;
@@ -911,7 +1476,7 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
                 dtn1 = setup.time_maxdt;
                 // Retrieve the possible dt using the WCA2Dv2 diffusive formula.
                 // This is very similar to the LISFLOOD-FP diffusive formula.
-                (*PDT).sequentialOp(seqdomain, possible_dt, CA::Seq::Min);
+                possible_dt = DTMIN.value();
 
                 // I Don't like using alpha. But at the moment this is the
                 // simplest way to find the potential impact of events.
@@ -925,9 +1490,6 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
 
                 // Use the possible dt and the dtn1 to find the time step.
                 dtn1 = std::min(dtn1, possible_dt);
-
-                // Reset the PDT.
-                (*PDT).fill(fulldomain, setup.time_updatedt);
                 break;
             }
 
@@ -939,6 +1501,18 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
             // Update the number of iterations before the next update dt.
             iter_dt = floor(setup.time_updatedt / dt + 0.5);
 
+            // Set the level of the tiles with the new time step, the
+            // steps of each tile fill the update step. The events do
+            // not pin their tiles once they are finished.
+            if (LTS)
+            {
+                if (t > t_end_events)
+                    LTS->unpin();
+
+                LTS->update(tile_dt, dt, iter_dt);
+                lts_iter = 0;
+            }
+
             // When the dt need to be recomputed.
             time_dt += period_time_dt;
 
@@ -947,6 +1521,15 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
             inflow_manager.prepare(t, period_time_dt, dt);
             wl_manager.prepare(t, period_time_dt, dt);
 
+            // The water on the edge of the reachable domain cannot
+            // move further, thus the domain was too small.
+            if (REACH && !reach_warned && REACH->reached(WD))
+            {
+                std::cerr << "Warning the water reached the edge of the reachable domain at time "
+                    << t << ", increase the Reach Head Tolerance" << std::endl;
+                reach_warned = true;
+            }
+
             if (setup.ignore_upstream)
             {
                 // Check the ALARMS computed during the velocity step.
@@ -961,8 +1544,15 @@ int CADDIES2D(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Re
                 // finished to add water to the domain.
                 if (!VELALARMS.isActivated(0) && t > t_end_events)
                 {
-                    CA::Execute::function(fulldomain, removeUpstr, GRID, MASK, ELV, upstr_elv);
+                    UPSTR->remove(MASK, upstr_elv);
                     upstr_elv -= setup.upstream_reduction;
+
+                    // The removed cells cannot activate a tile, or be
+                    // counted by the list of the wet cells.
+                    if (TILES)
+                        TILES->removeCells(UPSTR->removed());
+                    if (WET)
+                        WET->removeCells(UPSTR->removed());
                 }
             }
         } // COMPUTE NEXT DT.
@@ -1212,13 +1802,15 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
     }
     // ---- CELL BUFFERS ----
 
-    // Create the water depth cell buffer.
+    // Create the water depth cell buffer. It is created just after the
+    // elevation, thus with the cell records (the "cell-record" option)
+    // the rows of the two buffers read by the outflow are interleaved.
     CA::CellBuffReal WD(GRID);
 
     // Create the MASK cell buffer. The mask is useful to check which
     // cell has data and nodata and which cell has neighbourhood with
     // data.
-    CA::CellBuffState MASK(GRID);
+    CA::CellBuffMask MASK(GRID);
 
     // Create the velocity cell buffer with the speed of the velocity
     CA::CellBuffReal V(GRID);
@@ -1226,18 +1818,6 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
     // Create the velocity cell buffer with the angle of the velocity
     CA::CellBuffReal A(GRID);
 
-    // If the we are using the WCA2Dv2 model create the buffer with the
-    // dt value.
-    cpp11::shared_ptr<CA::CellBuffReal> PDT;
-
-    // Allocate the buffer for the time step
-    // Only WCA2Dv1 does not need this.
-    if (setup.model_type != MODEL::WCA2Dv1)
-    {
-        PDT.reset(new CA::CellBuffReal(GRID));
-        (*PDT).fill(fulldomain, setup.time_updatedt);
-    }
-
     // ---- EDGES BUFFERS ----
 
     // Create the outflow edge buffer(s). Many models use a double buffer
@@ -1257,18 +1837,45 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
         (*PTOT).clear();
     }
 
+    // Allocate the buffer with the last outflux of each edge of the
+    // tiles that do not step at every iteration with the local time
+    // steps. Only WCA2Dv2 (with a domain not expanded) does need this.
+    cpp11::shared_ptr<CA::EdgeBuffReal> PLAST;
+    if (setup.model_type == MODEL::WCA2Dv2 && !setup.expand_domain && setup.lts_levels > 0)
+    {
+        PLAST.reset(new CA::EdgeBuffReal(GRID));
+        (*PLAST).clear();
+    }
+
 
     // ---- ALARMS ----
 
     // Create the alarm(s) checked during the outflux computation.
     // Alarm 1: indicates when there is going to be an outflux outside of the computational domain.
-    CA::Alarms  OUTFALARMS(GRID, 1);
+    // Alarm 2-5: indicates the outflux through the east, north, west and south side of the domain.
+    CA::Alarms  OUTFALARMS(GRID, 5);
 
     // Create the alarm(s) checked during the velocity computation
     // Alarm 1: indicates when there is still water movement over the elevation threshold.
     CA::Alarms  VELALARMS(GRID, 1);
 
 
+    // ---- REDUCTIONS ----
+
+    // Create the reductions computed during the velocity computation.
+    // The maximum velocity and the minimum possible dt (WCA2Dv2 only).
+    CA::ReductionReal VAMAX(GRID, CA::Seq::Max);
+    CA::ReductionReal DTMIN(GRID, CA::Seq::Min);
+
+#ifdef CA2D_TASKS
+    // ---- TASKS ----
+
+    // The list of CA functions executed by a single team of threads
+    // (WCA2Dv1 when the domain box is not expanded).
+    CA::TaskList TEAM(GRID);
+#endif
+
+
     // ---- SCALAR VALUES ----
 
     CA::Unsigned iter = 0;              // The actual iteration number.
@@ -1326,6 +1933,11 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
     CA::Real     wd_volume = 0.0;
     CA::Real     inf_volume = 0.0;
 
+    // The water added or set by the events in a time step, and in each
+    // time step of a temporal block.
+    WDSources    sources;
+    std::vector<WDSources> block_sources;
+
     // Maximum velocity.
     CA::Real     vamax = 0.0;
 
@@ -1345,6 +1957,10 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
     // possible expanding domain.
     bool         checkbox = setup.expand_domain;
 
+    // The SIMD kernels used by the WCA2Dv2 CA functions, if NONE the
+    // scalar CA functions are used.
+    SIMD::Type   simd = selectSIMD(setup.simd_kernels);
+
     // Variable which indicates if the PEAK values need to be updated.
     // The PEAK values can be updated on every update step or on every
     // steps.
@@ -1369,7 +1985,7 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
     //***********************//
 
     // The MASK is used to check if a cell with nodata has a neighbour
-    // with data (Bit 31 set to true in the MASK). This kind of cells
+    // with data (boundary bit set to true in the MASK). This kind of cells
     // are called boundary cells and they are ignored by the computation
     // (not visited), i.e. the rain is not added into them, the outflow
     // are not computed. However, these boundary cells are used as
@@ -1385,6 +2001,35 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
     // Set the boundary cell elevation to the given boundary_elv value.
     CA::Execute::function(fulldomain, setBoundaryEle, GRID, ELV, MASK, setup.boundary_elv);
 
+    // ---- REACHABLE DOMAIN ----
+
+    // If requested, only the cells that the water of the events can
+    // reach are computed. The unreachable data cells are removed from
+    // the MASK and the ones on its edge become boundary cells that
+    // keep their elevation (after the setting of the boundary
+    // elevation).
+    cpp11::shared_ptr<ReachDomain> REACH;
+    if (setup.reach_domain)
+    {
+        CA::CellBuffState RCH(GRID);
+        if (!RCH.loadData(setup.preproc_name + "_REACH", "0"))
+        {
+            std::cerr << "Error while loading the Reachable domain pre-processed file" << std::endl;
+            return 1;
+        }
+
+        REACH.reset(new ReachDomain(GRID, MASK, RCH));
+
+        if (rptFile)
+        {
+            fprintf(rptFile, "Reachable domain : %lu cells\n", static_cast<unsigned long>(REACH->cells()));
+            fprintf(rptFile, "------------------------------------------\n");
+        }
+    }
+
+    // Warn only once when the water reaches the edge of the domain.
+    bool reach_warned = false;
+
     //CA_DUMP_BUFF(ELV,0);  
 
     // ---- INFILTRATION ----
@@ -1469,6 +2114,39 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
         initRGData(filename, GRID, nodata, rgs[i], rgdatas[i], rgpeak);
     }
 
+    // -- DOMAIN DECOMPOSITION --
+
+    // The domain of the data and boundary cells, i.e. the cells
+    // visited by the water depth update. If requested, the grid is
+    // decomposed in the boxes with at least the given efficiency of
+    // these cells, otherwise the domain is the full grid. A is used as
+    // temporary buffer. The reachable domain limits the grid.
+    CA::Box      databox = (REACH && REACH->cells() > 0) ? REACH->extent() : fullbox;
+    CA::BoxList  datadomain(databox);
+    if (setup.decomp_eff > 0.0)
+    {
+        CA::Execute::function(fulldomain, computeDomainCells, GRID, A, MASK);
+        decomposeDomain(databox, A, setup, datadomain);
+
+        if (rptFile)
+        {
+            CA::Unsigned cells = 0;
+            for (CA::BoxList::ConstIter ibox = datadomain.begin(); ibox != datadomain.end(); ++ibox)
+                cells += ibox->size();
+
+            fprintf(rptFile, "Domain decomposition : %lu boxes with %f%% of the cells\n",
+                static_cast<unsigned long>(datadomain.size()),
+                (100.0 * cells) / fullbox.size());
+            fprintf(rptFile, "------------------------------------------\n");
+        }
+    }
+
+    // If the upstream cells are ignored, the data cells are sorted by
+    // elevation once, thus each removal visits only the cells removed.
+    cpp11::shared_ptr<UpstreamCells> UPSTR;
+    if (setup.ignore_upstream)
+        UPSTR.reset(new UpstreamCells(GRID, ELV, MASK, datadomain));
+
     // -- INITIALISE ---
 
     // Clear the buffer to zero (borders included).
@@ -1478,11 +2156,44 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
     V.clear();
     WD.clear();
 
+    // If the domain is not expanded, the tiles of the domain can step
+    // with a local time step, a power of two multiple of the global
+    // one, computed by WCA2Dv2 at each update step. The areas of the
+    // events are pinned to the global time step.
+    cpp11::shared_ptr<LocalTimeSteps> LTS;
+    if (PLAST)
+    {
+        LTS.reset(new LocalTimeSteps(GRID, datadomain, setup.lts_tile, setup.lts_levels + 1));
+        LTS->pin(compdomain);
+
+        if (rptFile)
+        {
+            fprintf(rptFile, "Local time steps : %lu levels of tiles of %lu cells\n",
+                static_cast<unsigned long>(LTS->levels()), static_cast<unsigned long>(setup.lts_tile));
+            fprintf(rptFile, "------------------------------------------\n");
+        }
+    }
+
+    // The iteration of the update step and the possible dt of each tile.
+    CA::Unsigned lts_iter = 0;
+    std::vector<CA::Real> tile_dt;
+
+    // If the domain is not expanded, only the rows of the wet cells, and
+    // of a halo around them, are computed by WCA2Dv2 when the wet
+    // fraction of the domain is below the setup threshold. The areas of
+    // the events are pinned in the list. The list is not used with the
+    // local time steps.
+    cpp11::shared_ptr<WetCells> WET;
+    if (!setup.expand_domain && setup.model_type == MODEL::WCA2Dv2 && setup.wet_fraction > 0.0 && !LTS)
+    {
+        WET.reset(new WetCells(GRID, MASK, datadomain, setup.wet_halo));
+        WET->pin(compdomain);
+    }
+
     // If there is not request to expand domain. Set the computational and extend domain to full domain.
     if (!setup.expand_domain)
     {
-        compdomain.clear();
-        compdomain.add(fullbox);
+        compdomain = datadomain;
     }
     else
     {
@@ -1490,6 +2201,37 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
         seqdomain = compdomain;
     }
 
+    // If the domain is expanded by tiles, the computational domain is
+    // made by the tiles with water, or with an event, and the tiles
+    // around them. Otherwise each area of the events is a box that is
+    // expanded on the sides crossed by an outflux.
+    cpp11::shared_ptr<ActiveTiles> TILES;
+    if (setup.expand_domain && setup.domain_tile > 0)
+    {
+        TILES.reset(new ActiveTiles(GRID, MASK, setup.domain_tile));
+        TILES->pin(compdomain);
+        TILES->update(WD, ignore_wd);
+        compdomain = intersectBoxes(TILES->domain(), datadomain);
+    }
+
+    // If true the boxes of the domain are expanded. The boxes are
+    // merged only when they touch.
+    bool expand_box = setup.expand_domain && !TILES;
+    cpp11::shared_ptr<DomainBoxes> BOXES;
+    if (expand_box)
+    {
+        BOXES.reset(new DomainBoxes(fullbox, datadomain));
+        BOXES->add(compdomain);
+        compdomain = BOXES->domain();
+    }
+
+    // If true only the list of the wet cells is computed. The list is
+    // updated at least once every halo iterations.
+    bool compact = false;
+    CA::Unsigned wet_iter = 0;
+    if (WET)
+        compact = updateWetCells(*WET, compact, false, compdomain, GRID, WD, OUTF1, OUTF2, ignore_wd, setup);
+
 
     // -- CALCULATE POSSIBLE INITIAL DT ---
 
@@ -1571,9 +2313,46 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
         // The raster has not been written this iteration.
         RGwritten = false;
 
-        // If there is the request to expand the domain.
+        // Update the active tiles at least once every tile size
+        // iterations, thus the water cannot leave the domain.
+        if (TILES && iter % TILES->size() == 0)
+        {
+            // The events do not pin their tiles once they are finished.
+            if (t > t_end_events)
+                TILES->unpin();
+
+            if (TILES->update(WD, ignore_wd))
+            {
+                // Clear the old outflux of the tiles added to the
+                // domain and the velocity of the tiles removed. The
+                // outflux of the tiles removed is cleared too, the
+                // water depth update does not erase it anymore and it
+                // would be read by the cells around them. No wet cell
+                // is next to a removed tile, thus no flux is lost.
+                OUTF1.fill(TILES->added(), 0.0);
+                OUTF2.fill(TILES->added(), 0.0);
+                OUTF1.fill(TILES->removed(), 0.0);
+                OUTF2.fill(TILES->removed(), 0.0);
+                V.fill(TILES->removed(), 0.0);
+                A.fill(TILES->removed(), 0.0);
+
+                compdomain = intersectBoxes(TILES->domain(), datadomain);
+            }
+        }
+
+        // Update the list of the wet cells at least once every halo
+        // iterations, thus the water cannot leave the list.
+        if (WET && compact && wet_iter >= WET->halo())
+        {
+            compact = updateWetCells(*WET, compact, t > t_end_events, compdomain, GRID, WD, OUTF1, OUTF2,
+                ignore_wd, setup);
+            wet_iter = 0;
+        }
+        ++wet_iter;
+
+        // If there is the request to expand the domain box.
         // Deactivate Box alarm(s) and set them.
-        if (setup.expand_domain)
+        if (expand_box)
         {
             OUTFALARMS.deactivateAll();
             OUTFALARMS.set();
@@ -1584,6 +2363,14 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
         {
             if (rptFile)
                 outputConsole_2(iter, oiter, t, dt, avgodt, minodt, maxodt, vamax, upstr_elv, compdomain, setup, rptFile);
+
+            if (rptFile && LTS)
+            {
+                fprintf(rptFile, "Tiles of each local time step level:");
+                for (CA::Unsigned l = 0; l < LTS->levels(); ++l)
+                    fprintf(rptFile, " %lu", static_cast<unsigned long>(LTS->numLevel(l)));
+                fprintf(rptFile, "\n-----\n");
+            }
             oiter = 0;
             avgodt = 0.0;
             minodt = setup.time_maxdt;  // Output step minimum dt.
@@ -1621,18 +2408,7 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
         // --- SIMULATION TIME ---
 
         // Set the new time step.
-        t += dt;
-
-        // Round the time step to be of 0.01 second precision and then
-        // check if it is a multiple of 60 (with a 0.01 precision). If it
-        // is the case we need to reset the time of the simulation. If we
-        // don't do this the floating point error will creep into the time
-        // of simulation.
-        CA::Real tround = fround(t, 2);
-        if (std::fmod(tround, period_time_dt) < static_cast<CA::Real>(0.01))
-        {
-            t = tround;
-        }
+        advanceTime(t, dt, period_time_dt);
 
         // Compute output step information.
         avgodt += dt;
@@ -1640,45 +2416,229 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
         if (dt > maxodt) maxodt = dt;
         if (dt < minodt) minodt = dt;
 
+        // If the water depth was already computed with the outflux, in
+        // the same sweep or by the same team of threads.
+        bool fused = false;
+
+        // If the velocity of the update step was already computed by
+        // the same sweep of the outflux (a pipelined update).
+        bool pipelined = false;
+
+        // The cells added by the domain expansion.
+        CA::BoxList newcells;
+
+        // --- EXTRA LATERAL EVENT(s) ---
+
+        // Get the eventual rain, inflow and water level events of this
+        // time step. They are applied by the update of the water depth.
+        sources.clear();
+        rain_manager.add(sources, t, dt);
+        inflow_manager.add(sources, t, dt);
+        wl_manager.add(sources, t, dt);
+
         // --- COMPUTE OUTFLUX ---
         switch (setup.model_type)
         {
         case MODEL::WCA2Dv1:
-            // Clear the outflow buffer to zero (borders included).
-            OUTF1.clear();
+            // Clear the outflow buffer to zero only inside the
+            // computational domain, the outflow is never computed outside
+            // it and the domain can only grow.
+            OUTF1.fill(compdomain, 0.0);
+
+#ifdef CA2D_TASKS
+            // If the domain box is not expanded, the outflow and the
+            // water depth are computed by the same team of threads,
+            // which waits on a barrier between them.
+            if (!expand_box)
+            {
+                TEAM.clear();
+                TEAM.add(compdomain, CA::makeFunction(outflowWCA2Dv1, OUTF1, ELV, WD, MASK, OUTFALARMS,
+                    ignore_wd, tol_delwl, dt, irough));
+                TEAM.add(compdomain, CA::makeFunction(waterdepthWCA2Dv1, WD, OUTF1, (*PTOT), MASK,
+                    dt, period_time_dt));
+                TEAM.run();
+
+                fused = true;
+                break;
+            }
+#endif
 
             // Compute outflow using WCA2Dv1.
-            // Check if there is an outflow in the border of the box.
-            CA::Execute::function(compdomain, outflowWCA2Dv1, GRID, OUTF1, ELV, WD, MASK, OUTFALARMS,
-                ignore_wd, tol_delwl, dt, irough);
+            // Check if there is an outflow in the border of the box. If
+            // the boxes are expanded, each box is computed apart to know
+            // which of its sides are crossed.
+            for (size_t i = 0; i < (expand_box ? BOXES->size() : 1); ++i)
+            {
+                CA::Execute::function(expand_box ? BOXES->domain(i) : compdomain, outflowWCA2Dv1, GRID,
+                    OUTF1, ELV, WD, MASK, OUTFALARMS, ignore_wd, tol_delwl, dt, irough);
+                if (expand_box)
+                    BOXES->check(i, OUTFALARMS);
+            }
 
             break;
         case MODEL::WCA2Dv2:
             // Compute outflow using WCA2Dv2.
             // This save a division operation for each cell.
             CA::Real ratio_dt = dt / previous_dt;
-            CA::Execute::function(compdomain, outflowWCA2Dv2, GRID, (*POUTF1), (*POUTF2),
-                ELV, WD, MASK, OUTFALARMS, ignore_wd, tol_delwl, dt, ratio_dt, irough);
+
+            // With the local time steps, the tiles of the levels that
+            // step at this iteration compute the outflow with their
+            // time step and the previous outflux of their last step,
+            // which is in the double buffer for level zero and in the
+            // recorded one for the other levels. At the first iteration
+            // of an update step, the ratio and the previous outflux
+            // depend on the old level of a tile. The water depth of the
+            // whole domain is updated at each iteration.
+            if (LTS)
+            {
+                const CA::Unsigned top = LTS->stepLevel(lts_iter);
+
+                for (CA::Unsigned l = 0; l <= top; ++l)
+                {
+                    const CA::Real dtl = dt * (1 << l);
+
+                    if (lts_iter == 0)
+                    {
+                        for (CA::Unsigned old = 0; old < LTS->levels(); ++old)
+                            outflowWCA2Dv2SIMD(simd, LTS->domain(l, old), GRID, (*POUTF1),
+                                (old == 0) ? (*POUTF2) : (*PLAST), ELV, WD, MASK, OUTFALARMS,
+                                ignore_wd, tol_delwl, dtl, dtl / (previous_dt * (1 << old)), irough);
+                    }
+                    else
+                    {
+                        outflowWCA2Dv2SIMD(simd, LTS->domain(l), GRID, (*POUTF1),
+                            (l == 0) ? (*POUTF2) : (*PLAST), ELV, WD, MASK, OUTFALARMS,
+                            ignore_wd, tol_delwl, dtl, 1.0, irough);
+                    }
+                }
+
+                // Record the outflux of the tiles that do not step at
+                // the next iteration.
+                for (CA::Unsigned l = 1; l <= top; ++l)
+                    recordOutflow(LTS->domain(l), GRID, (*PLAST), (*POUTF1));
+
+                ++lts_iter;
+                break;
+            }
+
+            // Compute also the water depth in the same sweep if the
+            // domain is a single box and its expansion is inside the
+            // grid. The water depth of the cells added by the expansion
+            // is computed later.
+            fused = !compact && setup.fused_sweep && compdomain.size() == 1 &&
+                (!expand_box || (BOXES->size() == 1 && GRID.box().inside(extendBox(compdomain.extent(), fullbox, 1))));
+
+            if (fused)
+            {
+                // Compute also the next iterations with the same dt in
+                // the same sweep (a temporal block), if none of them but
+                // the last one updates the dt, outputs or ends the
+                // simulation. The time, the counters and the sources of
+                // these iterations are advanced here.
+                CA::Unsigned block = 1;
+                if (setup.block_steps > 1 && !expand_box && !setup.update_peak_dt)
+                {
+                    CA::Real t_stop = std::min(time_dt, setup.time_end);
+                    t_stop = std::min(t_stop, std::min(rg_manager.nextTime(), time_output));
+                    // The block cannot pass over the next update of the
+                    // active tiles.
+                    CA::Unsigned iters = std::min(iter_dt, setup.time_maxiters - iter);
+                    if (TILES)
+                        iters = std::min(iters, TILES->size() - iter % TILES->size());
+                    block = blockSteps(setup.block_steps, iters, t, dt, period_time_dt, t_stop);
+                }
+
+                block_sources.resize(block);
+                block_sources[0] = sources;
+
+                for (CA::Unsigned s = 1; s < block; ++s)
+                {
+                    // The end of the previous iteration and the start
+                    // of this one.
+                    start_updatedt += dt;
+                    previous_dt = dt;
+                    --iter_dt;
+                    iter++;
+                    oiter++;
+                    advanceTime(t, dt, period_time_dt);
+                    avgodt += dt;
+
+                    block_sources[s].clear();
+                    rain_manager.add(block_sources[s], t, dt);
+                    inflow_manager.add(block_sources[s], t, dt);
+                    wl_manager.add(block_sources[s], t, dt);
+                }
+
+                // If the last iteration updates the dt, compute also
+                // its velocity in the same sweep, a row as soon as the
+                // outflux around it is computed. The velocity and the
+                // reductions are cleared here instead of by the update.
+                pipelined = setup.pipelined_update && !expand_box && !useInfiltration &&
+                    (t >= time_dt || iter_dt == 1);
+
+                if (pipelined)
+                {
+                    if (setup.ignore_upstream)
+                    {
+                        VELALARMS.deactivateAll();
+                        VELALARMS.set();
+                    }
+
+                    V.fill(compdomain, 0.0);
+                    A.fill(compdomain, 0.0);
+                    VAMAX.reset(0.0);
+                    DTMIN.reset(setup.time_updatedt);
+
+                    outflowWaterdepthVelocitySIMD(simd, compdomain, GRID, (*POUTF1), (*POUTF2),
+                        ELV, WD, MASK, OUTFALARMS, ignore_wd, tol_delwl, dt, ratio_dt, irough, block_sources,
+                        V, A, VELALARMS, VAMAX, DTMIN, tol_va, tol_slope, upstr_elv);
+                }
+                else if (block > 1)
+                    outflowWaterdepthStepsSIMD(simd, compdomain, GRID, (*POUTF1), (*POUTF2),
+                        ELV, WD, MASK, OUTFALARMS, ignore_wd, tol_delwl, dt, ratio_dt, irough, block_sources);
+                else
+                    outflowWaterdepthSIMD(simd, compdomain, GRID, (*POUTF1), (*POUTF2),
+                        ELV, WD, MASK, OUTFALARMS, ignore_wd, tol_delwl, dt, ratio_dt, irough, sources);
+
+                // The swap below must leave the outflux of the last
+                // step in POUTF2.
+                if (block % 2 == 0)
+                    std::swap(POUTF1, POUTF2);
+
+                if (expand_box)
+                    BOXES->check(0, OUTFALARMS);
+                break;
+            }
+
+            // Compute only the rows of the list of the wet cells.
+            if (compact)
+            {
+                outflowWCA2Dv2SIMD(simd, WET->rows(), GRID, (*POUTF1), (*POUTF2),
+                    ELV, WD, MASK, OUTFALARMS, ignore_wd, tol_delwl, dt, ratio_dt, irough);
+                break;
+            }
+
+            // If the boxes are expanded, each box is computed apart to
+            // know which of its sides are crossed.
+            for (size_t i = 0; i < (expand_box ? BOXES->size() : 1); ++i)
+            {
+                outflowWCA2Dv2SIMD(simd, expand_box ? BOXES->domain(i) : compdomain, GRID, (*POUTF1), (*POUTF2),
+                    ELV, WD, MASK, OUTFALARMS, ignore_wd, tol_delwl, dt, ratio_dt, irough);
+                if (expand_box)
+                    BOXES->check(i, OUTFALARMS);
+            }
 
             break;
         }
 
-        // If there is a request to expand the domain.
-        // Get the alarms states.
-        if (setup.expand_domain)
+        // If there is a request to expand the domain boxes, grow the
+        // boxes on the sides crossed by an outflux.
+        if (expand_box && BOXES->grow())
         {
-            OUTFALARMS.get();
+            compdomain = BOXES->domain();
 
-            // Check if the box alarm is active, that mean there is some
-            // outflux on the border of the computational domain.
-            if (OUTFALARMS.isActivated(0))
-            {
-                // Set the computational domain to be the extend version and
-                // create the new extended one.
-                CA::Box extent(compdomain.extent());
-                compdomain.clear();
-                compdomain.add(extendBox(extent, fullbox, 1));
-            }
+            if (fused)
+                newcells = BOXES->added();
         }
 
         // --- UPDATE WL AND WD ---
@@ -1687,12 +2647,20 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
         case MODEL::WCA2Dv1:
             // Update the water depth with the outflux and store the total
             // amount of outflux for the WCA2Dv1 model. 
-            CA::Execute::function(compdomain, waterdepthWCA2Dv1, GRID, WD, OUTF1, (*PTOT), MASK, dt, period_time_dt);
+            if (!fused)
+                CA::Execute::function(compdomain, waterdepthWCA2Dv1, GRID, WD, OUTF1, (*PTOT), MASK, dt, period_time_dt);
+            applySources(GRID, WD, ELV, MASK, sources);
             break;
 
         case MODEL::WCA2Dv2:
-            // Generic water depth, use OUTF1, erase OUTF2.
-            CA::Execute::function(compdomain, waterdepth, GRID, WD, (*POUTF1), (*POUTF2), MASK, dt);
+            // Generic water depth, use OUTF1, erase OUTF2, and add the
+            // sources. If the sweep was fused only the new cells are left.
+            if (compact)
+                waterdepthSIMD(simd, WET->rows(), GRID, WD, (*POUTF1), (*POUTF2), ELV, MASK, dt, sources);
+            else if (!fused)
+                waterdepthSIMD(simd, compdomain, GRID, WD, (*POUTF1), (*POUTF2), ELV, MASK, dt, sources);
+            else if (newcells.size() > 0)
+                waterdepthSIMD(simd, newcells, GRID, WD, (*POUTF1), (*POUTF2), ELV, MASK, dt, WDSources());
 
             // Swap the double buffer
             // Now POUTF1 is zeroed while POUTF2 contains the previous flux.
@@ -1702,17 +2670,6 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
 
         start_updatedt += dt;
 
-        // --- EXTRA LATERAL EVENT(s) ---
-
-        // Add the eventual rain events.
-        rain_manager.add(WD, MASK, t, dt);
-
-        // Add the eventual inflow events.
-        inflow_manager.add(WD, MASK, t, dt);
-
-        // Add the eventual water level events.
-        wl_manager.add(WD, ELV, MASK, t, dt);
-
         // --- COMPUTE NEXT DT, I.E. PERIOD STEP ---
 
         // Update previous dt
@@ -1732,7 +2689,7 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
                 // Clear the angle.
                 A.clear();
 
-                CA::Execute::function(fulldomain, infiltration, GRID, WD, MASK, A, inf_updatedt);
+                CA::Execute::function(datadomain, infiltration, GRID, WD, MASK, A, inf_updatedt);
 
                 if (setup.check_vols)
                 {
@@ -1743,7 +2700,7 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
                 }
             }
 
-            if (setup.ignore_upstream)
+            if (setup.ignore_upstream && !pipelined)
             {
                 // Deactivate the alarms checked during the velocity
                 // calculation.
@@ -1767,35 +2724,72 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
             switch (setup.model_type)
             {
             case MODEL::WCA2Dv1:
-                // Clear the Velocity and angle.
-                V.clear();
-                A.clear();
+                // Clear the Velocity and angle inside the computational
+                // domain. The infiltration uses the angle over the full
+                // domain.
+                V.fill(compdomain, 0.0);
+                if (useInfiltration)
+                    A.clear();
+                else
+                    A.fill(compdomain, 0.0);
 
                 // Compute the velocity using the total outflux.
                 // Attention the tolerance is different here. 
                 // Check if there is water movement over the upstream elevation threshold.
+                // Reduce the maximum velocity.
+                VAMAX.reset(0.0);
                 CA::Execute::function(compdomain, velocityWCA2Dv1, GRID, V, A, WD, ELV, (*PTOT), MASK, VELALARMS,
-                    tol_va, period_time_dt, irough, upstr_elv);
+                    VAMAX, tol_va, period_time_dt, irough, upstr_elv);
 
                 // CLear the total outflux.
                 (*PTOT).clear();
                 break;
 
             case MODEL::WCA2Dv2:
-                // Clear the Velocity and angle.
-                V.clear();
-                A.clear();
+                // The velocity was already computed by the sweep of the
+                // outflux with a pipelined update.
+                if (!pipelined)
+                {
+                    // Clear the Velocity and angle inside the computational
+                    // domain. The infiltration uses the angle over the full
+                    // domain.
+                    V.fill(compdomain, 0.0);
+                    if (useInfiltration)
+                        A.clear();
+                    else
+                        A.fill(compdomain, 0.0);
+
+                    // Compute the velocity using the last outflux (OUTF2)
+                    // Compute dt using Hunter formula
+                    // Reduce the maximum velocity and the minimum possible
+                    // dt, which is never over the update dt.
+                    // With the local time steps, the velocity of each tile
+                    // uses the outflux and the time step of its last step,
+                    // and the possible dt of each tile is kept.
+                    VAMAX.reset(0.0);
+                    DTMIN.reset(setup.time_updatedt);
+                    if (LTS)
+                        velocityTiles(simd, *LTS, GRID, V, A, WD, ELV, (*POUTF2), (*PLAST), MASK, VELALARMS, VAMAX, DTMIN,
+                            tol_va, tol_slope, dt, irough, upstr_elv, alpha, setup, tile_dt);
+                    else
+                        velocityDiffusiveSIMD(simd, compdomain, GRID, V, A,
+                            WD, ELV, (*POUTF2), MASK, VELALARMS, VAMAX, DTMIN,
+                            tol_va, tol_slope, dt, irough, upstr_elv);
+                }
 
-                // Compute the velocity using the last outflux (OUTF2)
-                // Compute dt using Hunter formula
-                CA::Execute::function(compdomain, velocityDiffusive, GRID, V, A, (*PDT),
-                    WD, ELV, (*POUTF2), MASK, VELALARMS,
-                    tol_va, tol_slope, dt, irough, upstr_elv);
+                // Rebuild the list of the wet cells after the velocity
+                // pass, the list can be switched on or off.
+                if (WET)
+                {
+                    compact = updateWetCells(*WET, compact, t > t_end_events, compdomain, GRID, WD, OUTF1, OUTF2,
+                        ignore_wd, setup);
+                    wet_iter = 0;
+                }
                 break;
             }
 
             // Retrieve the maximum velocity 
-            V.sequentialOp(compdomain, vamax, CA::Seq::MaxAbs);
+            vamax = VAMAX.value();
 
             // Find the maximum velocity
             CA::Real grid_max_va = vamax;
@@ -1821,7 +2815,7 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
                 dtn1 = setup.time_maxdt;
                 // Retrieve the possible dt using the WCA2Dv2 diffusive formula.
                 // This is very similar to the LISFLOOD-FP diffusive formula.
-                (*PDT).sequentialOp(seqdomain, possible_dt, CA::Seq::Min);
+                possible_dt = DTMIN.value();
 
                 if (possible_dt < setup.time_mindt)
                 {
@@ -1841,9 +2835,6 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
 
                 // Use the possible dt and the dtn1 to find the time step.
                 dtn1 = std::min(dtn1, possible_dt);
-
-                // Reset the PDT.
-                (*PDT).fill(fulldomain, setup.time_updatedt);
                 break;
             }
 
@@ -1855,6 +2846,18 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
             // Update the number of iterations before the next update dt.
             iter_dt = floor(setup.time_updatedt / dt + 0.5);
 
+            // Set the level of the tiles with the new time step, the
+            // steps of each tile fill the update step. The events do
+            // not pin their tiles once they are finished.
+            if (LTS)
+            {
+                if (t > t_end_events)
+                    LTS->unpin();
+
+                LTS->update(tile_dt, dt, iter_dt);
+                lts_iter = 0;
+            }
+
             // When the dt need to be recomputed.
             time_dt += period_time_dt;
 
@@ -1863,6 +2866,16 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
             inflow_manager.prepare(t, period_time_dt, dt);
             wl_manager.prepare(t, period_time_dt, dt);
 
+            // The water on the edge of the reachable domain cannot
+            // move further, thus the domain was too small.
+            if (REACH && !reach_warned && REACH->reached(WD))
+            {
+                if (rptFile)
+                    fprintf(rptFile, "Warning the water reached the edge of the reachable domain at time %f, "
+                        "increase the Reach Head Tolerance\n", t);
+                reach_warned = true;
+            }
+
             if (setup.ignore_upstream)
             {
                 // Check the ALARMS computed during the velocity step.
@@ -1877,8 +2890,15 @@ int CADDIES2D_2(const std::string& data_dir, const Setup& setup, const CA::Ascii
                 // finished to add water to the domain.
                 if (!VELALARMS.isActivated(0) && t > t_end_events)
                 {
-                    CA::Execute::function(fulldomain, removeUpstr, GRID, MASK, ELV, upstr_elv);
+                    UPSTR->remove(MASK, upstr_elv);
                     upstr_elv -= setup.upstream_reduction;
+
+                    // The removed cells cannot activate a tile, or be
+                    // counted by the list of the wet cells.
+                    if (TILES)
+                        TILES->removeCells(UPSTR->removed());
+                    if (WET)
+                        WET->removeCells(UPSTR->removed());
                 }
             }
         } // COMPUTE NEXT DT.
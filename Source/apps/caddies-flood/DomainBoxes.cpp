@@ -0,0 +1,204 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+//! \file DomainBoxes.cpp
+//! Contains the management of the computational domain as a set of
+//! boxes that grow independently.
+//! \date 2026-10
+
+
+#include"DomainBoxes.hpp"
+#include<algorithm>
+
+
+DomainBoxes::DomainBoxes(const CA::Box& fullbox, const CA::BoxList& datadomain) :
+    _fullbox(fullbox),
+    _datadomain(datadomain),
+    _boxes(),
+    _sides(),
+    _domains(),
+    _domain(),
+    _added()
+{
+}
+
+
+void DomainBoxes::add(const CA::BoxList& bl)
+{
+    for (CA::BoxList::ConstIter ibox = bl.begin(); ibox != bl.end(); ++ibox)
+    {
+        CA::Box box(*ibox);
+        box.limit(_fullbox);
+        if (box.empty())
+            continue;
+
+        _boxes.push_back(box);
+        _sides.push_back(0);
+    }
+
+    merge();
+}
+
+
+void DomainBoxes::check(size_t i, CA::Alarms& ALARMS)
+{
+    ALARMS.get();
+
+    // Alarm 0 is set if any side is crossed.
+    if (!ALARMS.isActivated(0))
+        return;
+
+    for (CA::Unsigned k = 1; k <= 4; ++k)
+    {
+        if (ALARMS.isActivated(k))
+            _sides[i] |= 1 << k;
+    }
+
+    ALARMS.deactivateAll();
+    ALARMS.set();
+}
+
+
+bool DomainBoxes::grow()
+{
+    _added.clear();
+
+    bool changed = false;
+    for (size_t i = 0; i < _boxes.size(); ++i)
+    {
+        if (_sides[i] == 0)
+            continue;
+
+        // Extend the box by one line on each crossed side (1 east, 2
+        // north, 3 west, 4 south) without leaving the grid.
+        CA::Box& box = _boxes[i];
+        const CA::Box old(box);
+        const CA::State sides = _sides[i];
+
+        if ((sides & (1 << 1)) && box.right() < _fullbox.right())
+            box.setW(box.w() + 1);
+        if ((sides & (1 << 2)) && box.top() > _fullbox.top())
+        {
+            box.setY(box.y() - 1);
+            box.setH(box.h() + 1);
+        }
+        if ((sides & (1 << 3)) && box.left() > _fullbox.left())
+        {
+            box.setX(box.x() - 1);
+            box.setW(box.w() + 1);
+        }
+        if ((sides & (1 << 4)) && box.bottom() < _fullbox.bottom())
+            box.setH(box.h() + 1);
+
+        _sides[i] = 0;
+
+        if (box == old)
+            continue;
+
+        changed = true;
+
+        // The cells of the new lines.
+        if (_boxes.size() == 1)
+        {
+            CA::BoxList ring;
+            if (box.top() < old.top())
+                ring.add(CA::Box(box.x(), box.y(), box.w(), old.top() - box.top()));
+            if (box.bottom() > old.bottom())
+                ring.add(CA::Box(box.x(), old.bottom(), box.w(), box.bottom() - old.bottom()));
+            if (box.left() < old.left())
+                ring.add(CA::Box(box.x(), old.y(), old.left() - box.left(), old.h()));
+            if (box.right() > old.right())
+                ring.add(CA::Box(old.right(), old.y(), box.right() - old.right(), old.h()));
+
+            for (CA::BoxList::ConstIter iring = ring.begin(); iring != ring.end(); ++iring)
+            {
+                for (CA::BoxList::ConstIter idata = _datadomain.begin(); idata != _datadomain.end(); ++idata)
+                    _added.add(CA::Box::Intersect(*iring, *idata));
+            }
+        }
+    }
+
+    if (changed)
+        merge();
+
+    return changed;
+}
+
+
+bool DomainBoxes::touch(const CA::Box& a, const CA::Box& b)
+{
+    // The overlap of the boxes in each direction, it is zero if they
+    // are adjacent.
+    const CA::Unsigned l = std::max(a.left(), b.left());
+    const CA::Unsigned r = std::min(a.right(), b.right());
+    const CA::Unsigned t = std::max(a.top(), b.top());
+    const CA::Unsigned d = std::min(a.bottom(), b.bottom());
+
+    if (l > r || t > d)
+        return false;
+
+    // Boxes that share only a corner do not touch.
+    return (l < r || t < d);
+}
+
+
+void DomainBoxes::merge()
+{
+    // Merge the boxes until there are no two boxes that touch, the
+    // merged box can touch boxes that did not touch before.
+    bool merged = true;
+    while (merged)
+    {
+        merged = false;
+        for (size_t i = 0; i < _boxes.size() && !merged; ++i)
+        {
+            for (size_t j = i + 1; j < _boxes.size(); ++j)
+            {
+                if (touch(_boxes[i], _boxes[j]))
+                {
+                    _boxes[i] = CA::Box::Union(_boxes[i], _boxes[j]);
+                    _sides[i] |= _sides[j];
+                    _boxes.erase(_boxes.begin() + j);
+                    _sides.erase(_sides.begin() + j);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Rebuild the domain of each box with its data cells.
+    _domains.assign(_boxes.size(), CA::BoxList());
+    _domain.clear();
+    for (size_t i = 0; i < _boxes.size(); ++i)
+    {
+        for (CA::BoxList::ConstIter idata = _datadomain.begin(); idata != _datadomain.end(); ++idata)
+        {
+            CA::Box box(CA::Box::Intersect(_boxes[i], *idata));
+            _domains[i].add(box);
+            _domain.add(box);
+        }
+    }
+}
@@ -0,0 +1,133 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef _DOMAINBOXES_HPP_
+#define _DOMAINBOXES_HPP_
+
+
+//! \file DomainBoxes.hpp
+//! Contains the class that manages the expanded computational domain
+//! as a set of boxes, one for each separate area of the events. Each
+//! box grows only on the sides crossed by the water.
+//! \date 2026-10
+
+
+#include"ca2D.hpp"
+#include"BaseTypes.hpp"
+#include"Box.hpp"
+#include"BoxList.hpp"
+#include<vector>
+
+
+//! Manage the computational domain as a set of disjoint boxes. Each
+//! box grows by one line on the sides where there was an outflux
+//! leaving it, which is signalled by the alarms 1-4 of the outflow
+//! function (one for each side). Two boxes are merged in the box that
+//! contains both only when they overlap or share part of a side. The
+//! water moves at most one cell per time step, thus the boxes must be
+//! grown after each outflow computation.
+class DomainBoxes
+{
+public:
+
+    //! Create an empty set of boxes inside the full box. The domain is
+    //! limited to the boxes of the data and boundary cells.
+    DomainBoxes(const CA::Box& fullbox, const CA::BoxList& datadomain);
+
+    //! Add the given boxes, e.g. the areas of the events. The boxes
+    //! that touch are merged.
+    void add(const CA::BoxList& bl);
+
+    //! Return the number of boxes.
+    size_t size() const;
+
+    //! Return the computational domain of the given box.
+    const CA::BoxList& domain(size_t i) const;
+
+    //! Return the computational domain of all the boxes.
+    const CA::BoxList& domain() const;
+
+    //! Retrieve the side alarms set by the outflow of the given box
+    //! and deactivate them.
+    void check(size_t i, CA::Alarms& ALARMS);
+
+    //! Grow the boxes on the sides crossed by an outflux since the
+    //! last call, merge the boxes that touch and rebuild the domain.
+    //! \return true if the domain has changed.
+    bool grow();
+
+    //! Return the cells added by the last grow if the domain had a
+    //! single box, otherwise the list is empty.
+    const CA::BoxList& added() const;
+
+protected:
+
+    //! Return true if the boxes overlap or share part of a side.
+    static bool touch(const CA::Box& a, const CA::Box& b);
+
+    //! Merge the boxes that touch and rebuild the domain.
+    void merge();
+
+private:
+
+    CA::Box      _fullbox;              //!< The box of the grid.
+    CA::BoxList  _datadomain;           //!< The boxes of the data cells.
+
+    std::vector<CA::Box>     _boxes;    //!< The boxes.
+    std::vector<CA::State>   _sides;    //!< The crossed sides of each box (bits 1-4).
+    std::vector<CA::BoxList> _domains;  //!< The domain of each box.
+
+    CA::BoxList  _domain;               //!< The computational domain.
+    CA::BoxList  _added;                //!< The cells added by the last grow.
+};
+
+
+/// ----- Inline implementation ----- ///
+
+
+inline size_t DomainBoxes::size() const
+{
+    return _boxes.size();
+}
+
+
+inline const CA::BoxList& DomainBoxes::domain(size_t i) const
+{
+    return _domains[i];
+}
+
+
+inline const CA::BoxList& DomainBoxes::domain() const
+{
+    return _domain;
+}
+
+
+inline const CA::BoxList& DomainBoxes::added() const
+{
+    return _added;
+}
+
+#endif
@@ -39,7 +39,6 @@ THE SOFTWARE.
 // Include the CA 2D functions //
 // -------------------------//
 #include CA_2D_INCLUDE(computeArea)
-#include CA_2D_INCLUDE(addInflow)
 
 
 int initIEventFromCSV(const std::string& filename, IEvent& ie)
@@ -177,7 +176,7 @@ void InflowManager::addDomain(CA::BoxList& compdomain)
 }
 
 
-void InflowManager::analyseArea(CA::CellBuffReal& TMP, CA::CellBuffState& MASK, CA::BoxList&  domain)
+void InflowManager::analyseArea(CA::CellBuffReal& TMP, CA::CellBuffMask& MASK, CA::BoxList&  domain)
 {
     for (size_t i = 0; i < _datas.size(); ++i)
     {
@@ -247,7 +246,7 @@ CA::Real InflowManager::volume()
 }
 
 
-void InflowManager::add(CA::CellBuffReal& WD, CA::CellBuffState& MASK, CA::Real t, CA::Real dt)
+void InflowManager::add(WDSources& sources, CA::Real t, CA::Real dt)
 {
     // Loop through the inflow event(s).
     for (size_t i = 0; i < _ies.size(); ++i)
@@ -263,7 +262,7 @@ void InflowManager::add(CA::CellBuffReal& WD, CA::CellBuffState& MASK, CA::Real
             CA::Real level_prev = std::pow((7.0 / 3.0)*(0 - pn * pu*(-_ies[i].u*(t - dt))), (3.0 / 7.0));
             CA::Real volume = _ies[i].u*((level_now + level_prev) / 2)*_grid.length()*dt; // per cell!!!
 
-            CA::Execute::function(_datas[i].box_area, addInflow, _grid, WD, MASK, volume);
+            sources.push_back(WDSource(_datas[i].box_area, WDSource::VOLUME, volume));
             continue;
         }
 
@@ -312,7 +311,7 @@ void InflowManager::add(CA::CellBuffReal& WD, CA::CellBuffState& MASK, CA::Real
         // Do not add it if it is zero.
         if (volume >= SMALL_INFLOW)
         {
-            CA::Execute::function(_datas[i].box_area, addInflow, _grid, WD, MASK, volume);
+            sources.push_back(WDSource(_datas[i].box_area, WDSource::VOLUME, volume));
         }
 
         // Check if the simulation time now is equal or higher than the
@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include"ca2D.hpp"
 #include"BaseTypes.hpp"
 #include"Box.hpp"
+#include"Sources.hpp"
 #include<string>
 #include<vector>
 
@@ -120,7 +121,7 @@ public:
     void addDomain(CA::BoxList& compdomain);
 
     //! Analyse the area where the various inflow event will happen.
-    void analyseArea(CA::CellBuffReal& TMP, CA::CellBuffState& MASK, CA::BoxList&  domain);
+    void analyseArea(CA::CellBuffReal& TMP, CA::CellBuffMask& MASK, CA::BoxList&  domain);
 
     //! Prepare the inflow events for the next update step considering the
     //! simulation time, the length of the update step and the next time
@@ -131,8 +132,8 @@ public:
     //! \attention This is the PERIOD volume.
     CA::Real volume();
 
-    //! Add the amount of inflow 
-    void add(CA::CellBuffReal& WD, CA::CellBuffState& MASK, CA::Real t, CA::Real next_dt);
+    //! Add the amount of inflow of the next time step into the sources.
+    void add(WDSources& sources, CA::Real t, CA::Real next_dt);
 
     //! Compute the potential velocity that could happen in the next
     //! update/period step.
@@ -0,0 +1,230 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+//! \file LocalTimeSteps.cpp
+//! Contains the management of the local time steps of the tiles of
+//! the computational domain.
+//! \date 2026-10
+
+
+#include"LocalTimeSteps.hpp"
+#include<algorithm>
+
+
+LocalTimeSteps::LocalTimeSteps(CA::Grid& GRID, const CA::BoxList& domain, CA::Unsigned size, CA::Unsigned levels) :
+    _fullbox(GRID.box()),
+    _domain(domain),
+    _size(std::max(size, static_cast<CA::Unsigned>(1))),
+    _levels(std::max(levels, static_cast<CA::Unsigned>(1))),
+    _nx((_fullbox.w() + _size - 1) / _size),
+    _ny((_fullbox.h() + _size - 1) / _size),
+    _tiles(_nx * _ny),
+    _pinned(_nx * _ny, 0),
+    _level(_nx * _ny, 0),
+    _old(_nx * _ny, 0),
+    _domains(_levels),
+    _changes(_levels * _levels)
+{
+    for (CA::Unsigned ty = 0; ty < _ny; ++ty)
+    {
+        for (CA::Unsigned tx = 0; tx < _nx; ++tx)
+        {
+            const CA::Box tile = tileBox(tx, ty);
+
+            for (CA::BoxList::ConstIter ibox = _domain.begin(); ibox != _domain.end(); ++ibox)
+                _tiles[ty * _nx + tx].add(CA::Box::Intersect(tile, *ibox));
+        }
+    }
+
+    makeDomains();
+}
+
+
+void LocalTimeSteps::pin(const CA::BoxList& bl)
+{
+    for (CA::BoxList::ConstIter ibox = bl.begin(); ibox != bl.end(); ++ibox)
+    {
+        CA::Box box(*ibox);
+        box.limit(_fullbox);
+        if (box.empty())
+            continue;
+
+        const CA::Unsigned tx0 = (box.x() - _fullbox.x()) / _size;
+        const CA::Unsigned ty0 = (box.y() - _fullbox.y()) / _size;
+        const CA::Unsigned tx1 = (box.right() - 1 - _fullbox.x()) / _size;
+        const CA::Unsigned ty1 = (box.bottom() - 1 - _fullbox.y()) / _size;
+
+        for (CA::Unsigned ty = ty0; ty <= ty1; ++ty)
+            for (CA::Unsigned tx = tx0; tx <= tx1; ++tx)
+                _pinned[ty * _nx + tx] = 1;
+    }
+}
+
+
+void LocalTimeSteps::unpin()
+{
+    std::fill(_pinned.begin(), _pinned.end(), 0);
+}
+
+
+void LocalTimeSteps::update(const std::vector<CA::Real>& tiledt, CA::Real dt, CA::Unsigned iters)
+{
+    std::vector<CA::Unsigned> level(_nx * _ny, 0);
+
+    // The highest level whose time step is not over the possible time
+    // step of the tile and whose steps fill the update step.
+    for (CA::Unsigned k = 0; k < level.size(); ++k)
+    {
+        if (_pinned[k] || _tiles[k].size() == 0)
+            continue;
+
+        CA::Unsigned l = 0;
+        while (l + 1 < _levels)
+        {
+            const CA::Unsigned steps = static_cast<CA::Unsigned>(1) << (l + 1);
+            if (dt * steps > tiledt[k] || iters % steps != 0)
+                break;
+            ++l;
+        }
+
+        level[k] = l;
+    }
+
+    // The level of a tile is at most one more than the level of its
+    // neighbours. Each sweep can only lower the levels, thus the
+    // sweeps stop.
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+
+        for (CA::Unsigned ty = 0; ty < _ny; ++ty)
+        {
+            for (CA::Unsigned tx = 0; tx < _nx; ++tx)
+            {
+                const CA::Unsigned k = ty * _nx + tx;
+                if (_tiles[k].size() == 0)
+                    continue;
+
+                const CA::Unsigned ty0 = (ty > 0) ? ty - 1 : 0;
+                const CA::Unsigned tx0 = (tx > 0) ? tx - 1 : 0;
+                const CA::Unsigned ty1 = std::min(ty + 1, _ny - 1);
+                const CA::Unsigned tx1 = std::min(tx + 1, _nx - 1);
+
+                for (CA::Unsigned ny = ty0; ny <= ty1; ++ny)
+                {
+                    for (CA::Unsigned nx = tx0; nx <= tx1; ++nx)
+                    {
+                        const CA::Unsigned kn = ny * _nx + nx;
+                        if (_tiles[kn].size() != 0 && level[k] > level[kn] + 1)
+                        {
+                            level[k] = level[kn] + 1;
+                            changed = true;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    _old.swap(_level);
+    _level.swap(level);
+
+    makeDomains();
+}
+
+
+CA::Unsigned LocalTimeSteps::numLevel(CA::Unsigned l) const
+{
+    CA::Unsigned num = 0;
+    for (CA::Unsigned k = 0; k < _level.size(); ++k)
+    {
+        if (_tiles[k].size() != 0 && _level[k] == l)
+            ++num;
+    }
+
+    return num;
+}
+
+
+CA::Box LocalTimeSteps::tileBox(CA::Unsigned tx, CA::Unsigned ty) const
+{
+    const CA::Unsigned x = tx * _size;
+    const CA::Unsigned y = ty * _size;
+
+    return CA::Box(_fullbox.x() + x, _fullbox.y() + y,
+        std::min(_size, _fullbox.w() - x), std::min(_size, _fullbox.h() - y));
+}
+
+
+void LocalTimeSteps::makeBoxes(const std::vector<char>& flags, CA::BoxList& bl) const
+{
+    bl.clear();
+
+    // The tiles of a row are merged in a single box, the box is then
+    // cut by the boxes of the domain.
+    for (CA::Unsigned ty = 0; ty < _ny; ++ty)
+    {
+        for (CA::Unsigned tx = 0; tx < _nx; ++tx)
+        {
+            if (!flags[ty * _nx + tx])
+                continue;
+
+            CA::Unsigned tx1 = tx;
+            while (tx1 + 1 < _nx && flags[ty * _nx + tx1 + 1])
+                ++tx1;
+
+            const CA::Box run = CA::Box::Union(tileBox(tx, ty), tileBox(tx1, ty));
+
+            for (CA::BoxList::ConstIter ibox = _domain.begin(); ibox != _domain.end(); ++ibox)
+                bl.add(CA::Box::Intersect(run, *ibox));
+
+            tx = tx1;
+        }
+    }
+
+    // Merge the boxes of consecutive rows.
+    bl.coalesce();
+}
+
+
+void LocalTimeSteps::makeDomains()
+{
+    std::vector<char> flags(_nx * _ny);
+
+    for (CA::Unsigned l = 0; l < _levels; ++l)
+    {
+        for (CA::Unsigned k = 0; k < flags.size(); ++k)
+            flags[k] = (_tiles[k].size() != 0 && _level[k] == l);
+        makeBoxes(flags, _domains[l]);
+
+        for (CA::Unsigned old = 0; old < _levels; ++old)
+        {
+            for (CA::Unsigned k = 0; k < flags.size(); ++k)
+                flags[k] = (_tiles[k].size() != 0 && _level[k] == l && _old[k] == old);
+            makeBoxes(flags, _changes[l * _levels + old]);
+        }
+    }
+}
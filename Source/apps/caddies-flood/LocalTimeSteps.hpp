@@ -0,0 +1,179 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef _LOCALTIMESTEPS_HPP_
+#define _LOCALTIMESTEPS_HPP_
+
+
+//! \file LocalTimeSteps.hpp
+//! Contains the class that manages the local time steps of the
+//! tiles of the computational domain.
+//! \date 2026-10
+
+
+#include"ca2D.hpp"
+#include"BaseTypes.hpp"
+#include"Box.hpp"
+#include"BoxList.hpp"
+#include<vector>
+
+
+//! Manage the local time steps of the square tiles of the domain. A
+//! tile of level l steps every 2^l global iterations with a time step
+//! 2^l times the global one. The levels are nested, when a tile steps
+//! all the tiles with a lower level step too, and all the tiles step
+//! together at the first iteration of an update step.
+//!
+//! The level of a tile is the highest one whose time step is not over
+//! the possible time step of the tile, and the levels of two
+//! neighbour tiles (diagonal ones included) differ at most by one. A
+//! pinned tile (e.g. the area of an event) has level zero.
+class LocalTimeSteps
+{
+public:
+
+    //! Create the tiles of the given size (in cells) of the grid that
+    //! intersect the domain, all of them with level zero.
+    LocalTimeSteps(CA::Grid& GRID, const CA::BoxList& domain, CA::Unsigned size, CA::Unsigned levels);
+
+    //! Pin the tiles that intersect the given boxes.
+    void pin(const CA::BoxList& bl);
+
+    //! Unpin all the tiles.
+    void unpin();
+
+    //! Set the level of each tile given its possible time step, the
+    //! global time step and the number of iterations of the update
+    //! step, which must be a multiple of the steps of a tile.
+    void update(const std::vector<CA::Real>& tiledt, CA::Real dt, CA::Unsigned iters);
+
+    //! Return the number of levels (the highest level plus one).
+    CA::Unsigned levels() const;
+
+    //! Return the highest level of the tiles that step at the given
+    //! iteration of the update step.
+    CA::Unsigned stepLevel(CA::Unsigned iter) const;
+
+    //! Return the domain of the tiles of the given level.
+    const CA::BoxList& domain(CA::Unsigned l) const;
+
+    //! Return the domain of the tiles of the given level which had
+    //! the given old level before the last update.
+    const CA::BoxList& domain(CA::Unsigned l, CA::Unsigned old) const;
+
+    //! Return the number of tiles.
+    CA::Unsigned numTiles() const;
+
+    //! Return the domain of the given tile, which is empty if the tile
+    //! is outside the domain.
+    const CA::BoxList& tileDomain(CA::Unsigned k) const;
+
+    //! Return the level of the given tile.
+    CA::Unsigned level(CA::Unsigned k) const;
+
+    //! Return the number of tiles (inside the domain) of the given level.
+    CA::Unsigned numLevel(CA::Unsigned l) const;
+
+protected:
+
+    //! Return the box of the given tile.
+    CA::Box tileBox(CA::Unsigned tx, CA::Unsigned ty) const;
+
+    //! Create the list of the boxes of the domain inside the tiles
+    //! with the given flag.
+    void makeBoxes(const std::vector<char>& flags, CA::BoxList& bl) const;
+
+    //! Rebuild the domains of the levels.
+    void makeDomains();
+
+private:
+
+    CA::Box      _fullbox;      //!< The box of the grid.
+    CA::BoxList  _domain;       //!< The computational domain.
+    CA::Unsigned _size;         //!< The size of the tiles.
+    CA::Unsigned _levels;       //!< The number of levels.
+    CA::Unsigned _nx;           //!< The number of tiles in the X direction.
+    CA::Unsigned _ny;           //!< The number of tiles in the Y direction.
+
+    std::vector<CA::BoxList> _tiles;    //!< The domain of each tile.
+    std::vector<char> _pinned;          //!< True if a tile is pinned.
+    std::vector<CA::Unsigned> _level;   //!< The level of each tile.
+    std::vector<CA::Unsigned> _old;     //!< The level of each tile before the last update.
+
+    std::vector<CA::BoxList> _domains;  //!< The domain of each level.
+    std::vector<CA::BoxList> _changes;  //!< The domain of each pair of level and old level.
+};
+
+
+/// ----- Inline implementation ----- ///
+
+
+inline CA::Unsigned LocalTimeSteps::levels() const
+{
+    return _levels;
+}
+
+
+inline CA::Unsigned LocalTimeSteps::stepLevel(CA::Unsigned iter) const
+{
+    // The tiles of level l step when the iteration is a multiple of 2^l.
+    CA::Unsigned l = 0;
+    while (l + 1 < _levels && (iter & (static_cast<CA::Unsigned>(1) << l)) == 0)
+        ++l;
+
+    return l;
+}
+
+
+inline const CA::BoxList& LocalTimeSteps::domain(CA::Unsigned l) const
+{
+    return _domains[l];
+}
+
+
+inline const CA::BoxList& LocalTimeSteps::domain(CA::Unsigned l, CA::Unsigned old) const
+{
+    return _changes[l * _levels + old];
+}
+
+
+inline CA::Unsigned LocalTimeSteps::numTiles() const
+{
+    return _nx * _ny;
+}
+
+
+inline const CA::BoxList& LocalTimeSteps::tileDomain(CA::Unsigned k) const
+{
+    return _tiles[k];
+}
+
+
+inline CA::Unsigned LocalTimeSteps::level(CA::Unsigned k) const
+{
+    return _level[k];
+}
+
+#endif
@@ -39,7 +39,6 @@ THE SOFTWARE.
 // Include the CA 2D functions //
 // -------------------------//
 #include CA_2D_INCLUDE(computeArea)
-#include CA_2D_INCLUDE(addRain)
 
 
 // Initialise the RainEvents structure usign a CSV file. 
@@ -162,7 +161,7 @@ void RainManager::addDomain(CA::BoxList& compdomain)
 }
 
 
-void RainManager::analyseArea(CA::CellBuffReal& TMP, CA::CellBuffState& MASK, CA::BoxList&  domain)
+void RainManager::analyseArea(CA::CellBuffReal& TMP, CA::CellBuffMask& MASK, CA::BoxList&  domain)
 {
     for (size_t i = 0; i < _datas.size(); ++i)
     {
@@ -234,7 +233,7 @@ CA::Real RainManager::volume()
 }
 
 
-void RainManager::add(CA::CellBuffReal& WD, CA::CellBuffState& MASK, CA::Real t, CA::Real next_dt)
+void RainManager::add(WDSources& sources, CA::Real t, CA::Real next_dt)
 {
     // Loop through the rain event(s).
     for (size_t i = 0; i < _res.size(); ++i)
@@ -246,7 +245,7 @@ void RainManager::add(CA::CellBuffReal& WD, CA::CellBuffState& MASK, CA::Real t,
             CA::Real rain = static_cast<double>(_datas[i].rain) + _datas[i].one_off_rain;
             _datas[i].one_off_rain = 0.0; // Reset the one of rain.
 
-            CA::Execute::function(_datas[i].box_area, addRain, _grid, WD, MASK, rain);
+            sources.push_back(WDSource(_datas[i].box_area, WDSource::ADD, rain));
 
             // Increase the amount of rain added into the period.
             _datas[i].total_rain += _datas[i].rain;
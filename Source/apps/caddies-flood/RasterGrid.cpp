@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include<iostream>
 #include<fstream>
 #include<limits>
+#include<algorithm>
 
 
 // -------------------------//
@@ -169,12 +170,17 @@ RGManager::~RGManager()
 
 
 bool RGManager::updatePeak(const CA::BoxList&  domain,
-    CA::CellBuffReal& WD, CA::CellBuffReal& V, CA::CellBuffState& MASK)
+    CA::CellBuffReal& WD, CA::CellBuffReal& V, CA::CellBuffMask& MASK)
 {
     // This variable make sure that the peak values are updated only once.
     bool VAPEAKupdated = false;
     bool WDPEAKupdated = false;
 
+#ifdef CA2D_TASKS
+    // The peak values are updated by a single team of threads.
+    CA::TaskList peaks(_grid);
+#endif
+
     for (size_t i = 0; i < _datas.size(); ++i)
     {
         // Check if the peak values need to be updated.
@@ -187,7 +193,11 @@ bool RGManager::updatePeak(const CA::BoxList&  domain,
                 // ATTENTION need to be tested.
                 if (!VAPEAKupdated)
                 {
+#ifdef CA2D_TASKS
+                    peaks.add(domain, CA::makeFunction(updatePEAKC, (*_peak.V), V, MASK));
+#else
                     CA::Execute::function(domain, updatePEAKC, _grid, (*_peak.V), V, MASK);
+#endif
                     VAPEAKupdated = true;
                 }
                 // ATTENTION! The break is removed since in order to
@@ -198,7 +208,11 @@ bool RGManager::updatePeak(const CA::BoxList&  domain,
                 // Update the absolute maximum water depth only once.
                 if (!WDPEAKupdated)
                 {
+#ifdef CA2D_TASKS
+                    peaks.add(domain, CA::makeFunction(updatePEAKC, (*_peak.WD), WD, MASK));
+#else
                     CA::Execute::function(domain, updatePEAKC, _grid, (*_peak.WD), WD, MASK);
+#endif
                     WDPEAKupdated = true;
                 }
                 break;
@@ -208,6 +222,10 @@ bool RGManager::updatePeak(const CA::BoxList&  domain,
         }
     }
 
+#ifdef CA2D_TASKS
+    peaks.run();
+#endif
+
     return (WDPEAKupdated || VAPEAKupdated);
 }
 
@@ -388,6 +406,17 @@ bool RGManager::output(CA::Real t, CA::CellBuffReal& WD,
 }
 
 
+CA::Real RGManager::nextTime() const
+{
+    CA::Real time_next = std::numeric_limits<CA::Real>::max();
+
+    for (size_t i = 0; i < _datas.size(); ++i)
+        time_next = std::min(time_next, _datas[i].time_next);
+
+    return time_next;
+}
+
+
 int RGManager::initData(const std::string& filename, const RasterGrid& rg, Data& rgdata, Peak& rgpeak)
 {
     rgdata.filename = filename;
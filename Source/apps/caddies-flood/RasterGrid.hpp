@@ -123,7 +123,7 @@ public:
     //! \params V          The cell buffer with the velocity magnitude.
     //! \params MASK       The cell buffer with the mask
     //! \return True if the peak were updated.
-    bool updatePeak(const CA::BoxList&  domain, CA::CellBuffReal& WD, CA::CellBuffReal& V, CA::CellBuffState& MASK);
+    bool updatePeak(const CA::BoxList&  domain, CA::CellBuffReal& WD, CA::CellBuffReal& V, CA::CellBuffMask& MASK);
 
     //! Output only the peak raster grids
     //! \params t          The simulation time.
@@ -146,6 +146,9 @@ public:
     bool output(CA::Real t, CA::CellBuffReal& WD, CA::CellBuffReal& V, CA::CellBuffReal& A,
         const std::string& saveid, bool output, bool final = false);
 
+    //! Return the time of the next output of the raster grids.
+    CA::Real nextTime() const;
+
 protected:
 
     //! Initialise the raster grid data that is used during the
@@ -0,0 +1,221 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+//! \file ReachDomain.cpp
+//! Contains the computation of the reachable domain.
+//! \date 2026-10
+
+
+#include"ReachDomain.hpp"
+#include<queue>
+#include<utility>
+#include<algorithm>
+
+
+CA::Unsigned ReachDomain::compute(CA::Grid& GRID, CA::CellBuffReal& ELV, CA::CellBuffMask& MASK,
+    const CA::BoxList& sources, CA::Real tol, CA::CellBuffState& REACH)
+{
+    const CA::Box fullbox(GRID.box());
+    const CA::Unsigned w = fullbox.w();
+    const CA::Unsigned h = fullbox.h();
+
+    std::vector<CA::Real>  elv(fullbox.size());
+    std::vector<CA::Mask> mask(fullbox.size());
+    ELV.retrieveData(fullbox, &elv[0], w, h);
+    MASK.retrieveData(fullbox, &mask[0], w, h);
+
+    // The water level of each cell, a cell is reachable once it has
+    // a level.
+    std::vector<CA::Real> level(fullbox.size(), 0.0);
+    std::vector<char>     reach(fullbox.size(), 0);
+
+    // The cells to visit, the highest water level first.
+    typedef std::pair<CA::Real, CA::Unsigned> Item;
+    std::priority_queue<Item> queue;
+
+    for (CA::BoxList::ConstIter ibox = sources.begin(); ibox != sources.end(); ++ibox)
+    {
+        CA::Box box(*ibox);
+        box.limit(fullbox);
+        if (box.empty())
+            continue;
+
+        for (CA::Unsigned j = box.top(); j < box.bottom(); ++j)
+        {
+            for (CA::Unsigned i = box.left(); i < box.right(); ++i)
+            {
+                const CA::Unsigned k = (j - fullbox.y()) * w + i - fullbox.x();
+
+                // The data bit is true if the cell has data.
+                if (caMaskData(mask[k], 0) == 0 || reach[k])
+                    continue;
+
+                reach[k] = 1;
+                level[k] = elv[k] + tol;
+                queue.push(Item(level[k], k));
+            }
+        }
+    }
+
+    while (!queue.empty())
+    {
+        const Item item = queue.top();
+        queue.pop();
+
+        // Skip the cells already visited with a higher level.
+        const CA::Unsigned k = item.second;
+        if (item.first < level[k])
+            continue;
+
+        const CA::Unsigned x = k % w;
+        const CA::Unsigned y = k / w;
+
+        // The von Neumann neighbours.
+        CA::Unsigned nb[4];
+        CA::Unsigned nn = 0;
+        if (x + 1 < w) nb[nn++] = k + 1;
+        if (y > 0)     nb[nn++] = k - w;
+        if (x > 0)     nb[nn++] = k - 1;
+        if (y + 1 < h) nb[nn++] = k + w;
+
+        for (CA::Unsigned n = 0; n < nn; ++n)
+        {
+            const CA::Unsigned kn = nb[n];
+
+            if (caMaskData(mask[kn], 0) == 0 || elv[kn] > item.first)
+                continue;
+
+            const CA::Real l = std::min(item.first, elv[kn] + tol);
+            if (reach[kn] && l <= level[kn])
+                continue;
+
+            reach[kn] = 1;
+            level[kn] = l;
+            queue.push(Item(l, kn));
+        }
+    }
+
+    std::vector<CA::State> out(fullbox.size());
+    CA::Unsigned cells = 0;
+    for (CA::Unsigned k = 0; k < out.size(); ++k)
+    {
+        out[k] = reach[k];
+        cells += reach[k];
+    }
+    REACH.insertData(fullbox, &out[0], w, h);
+
+    return cells;
+}
+
+
+ReachDomain::ReachDomain(CA::Grid& GRID, CA::CellBuffMask& MASK, CA::CellBuffState& REACH) :
+    _extent(CA::Box::Empty()),
+    _cells(0),
+    _edge(),
+    _wd()
+{
+    const CA::Box fullbox(GRID.box());
+    const CA::Unsigned w = fullbox.w();
+    const CA::Unsigned h = fullbox.h();
+
+    std::vector<CA::Mask> mask(fullbox.size());
+    std::vector<CA::State> reach(fullbox.size());
+    MASK.retrieveData(fullbox, &mask[0], w, h);
+    REACH.retrieveData(fullbox, &reach[0], w, h);
+
+    // The reachable data cells.
+    std::vector<char> inside(fullbox.size(), 0);
+    for (CA::Unsigned k = 0; k < mask.size(); ++k)
+        inside[k] = caMaskData(mask[k], 0) != 0 && reach[k] != 0;
+
+    CA::Unsigned x0 = w, y0 = h, x1 = 0, y1 = 0;
+    for (CA::Unsigned y = 0; y < h; ++y)
+    {
+        for (CA::Unsigned x = 0; x < w; ++x)
+        {
+            const CA::Unsigned k = y * w + x;
+
+            if (!inside[k])
+            {
+                if (caMaskData(mask[k], 0) == 0)
+                    continue;
+
+                // Remove the data cell, if it is next to a reachable
+                // one it is a boundary cell.
+                CA::Mask m = caMaskSetData(mask[k], 0, 0);
+
+                const bool edge =
+                    (x + 1 < w && inside[k + 1]) || (y > 0 && inside[k - w]) ||
+                    (x > 0 && inside[k - 1]) || (y + 1 < h && inside[k + w]);
+
+                if (edge)
+                {
+                    m = caMaskSetBoundary(m, 1);
+                    _edge.add(CA::Point(fullbox.x() + x, fullbox.y() + y));
+                }
+
+                mask[k] = m;
+                continue;
+            }
+
+            ++_cells;
+            x0 = std::min(x0, x);
+            y0 = std::min(y0, y);
+            x1 = std::max(x1, x + 1);
+            y1 = std::max(y1, y + 1);
+        }
+    }
+
+    MASK.insertData(fullbox, &mask[0], w, h);
+
+    // The extent includes the edge and boundary cells around the
+    // reachable cells.
+    if (_cells > 0)
+    {
+        x0 = (x0 > 0) ? x0 - 1 : 0;
+        y0 = (y0 > 0) ? y0 - 1 : 0;
+        x1 = std::min(x1 + 1, w);
+        y1 = std::min(y1 + 1, h);
+        _extent = CA::Box(fullbox.x() + x0, fullbox.y() + y0, x1 - x0, y1 - y0);
+    }
+}
+
+
+bool ReachDomain::reached(CA::CellBuffReal& WD)
+{
+    if (_edge.size() == 0)
+        return false;
+
+    _wd.resize(_edge.size());
+    WD.retrievePoints(_edge, &_wd[0], _edge.size());
+
+    for (size_t k = 0; k < _wd.size(); ++k)
+    {
+        if (_wd[k] > 0.0)
+            return true;
+    }
+
+    return false;
+}
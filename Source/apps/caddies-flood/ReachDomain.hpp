@@ -0,0 +1,107 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef _REACHDOMAIN_HPP_
+#define _REACHDOMAIN_HPP_
+
+
+//! \file ReachDomain.hpp
+//! Contains the class that limits the computation to the cells that
+//! the water of the events can reach.
+//! \date 2026-10
+
+
+#include"ca2D.hpp"
+#include"BaseTypes.hpp"
+#include"Box.hpp"
+#include"BoxList.hpp"
+#include"PointList.hpp"
+#include<vector>
+
+
+//! Manage the reachable domain, i.e. the data cells that the water of
+//! the events can reach. The water level of a source cell (a data
+//! cell inside the area of an event) is its elevation plus the head
+//! tolerance. The water moves from a cell to a neighbour whose
+//! elevation is not over the water level, and the water level of the
+//! neighbour is the lowest between this level and its elevation plus
+//! the head tolerance, i.e. the water can climb at most the head
+//! tolerance over the lowest cell of its path. The cells are visited
+//! from the highest water level (priority-flood).
+//!
+//! The data cells that are not reachable are removed from the MASK,
+//! the ones next to a reachable cell become boundary cells without
+//! changing their elevation, thus the water that reaches the edge of
+//! the domain is kept there and it can be detected.
+class ReachDomain
+{
+public:
+
+    //! Find the data cells reachable from the data cells inside the
+    //! given sources with the given head tolerance and set the REACH
+    //! buffer to one for the reachable cells and zero otherwise.
+    //! \return The number of reachable cells.
+    static CA::Unsigned compute(CA::Grid& GRID, CA::CellBuffReal& ELV, CA::CellBuffMask& MASK,
+        const CA::BoxList& sources, CA::Real tol, CA::CellBuffState& REACH);
+
+    //! Remove the data cells that are not reachable from the MASK and
+    //! set the cells on the edge of the reachable ones as boundary
+    //! cells.
+    ReachDomain(CA::Grid& GRID, CA::CellBuffMask& MASK, CA::CellBuffState& REACH);
+
+    //! Return the box with the reachable cells, the edge cells and the
+    //! boundary cells around them.
+    CA::Box extent() const;
+
+    //! Return the number of reachable cells.
+    CA::Unsigned cells() const;
+
+    //! Return true if a cell of the edge of the domain has water.
+    bool reached(CA::CellBuffReal& WD);
+
+private:
+
+    CA::Box       _extent;          //!< The box of the domain.
+    CA::Unsigned  _cells;           //!< The number of reachable cells.
+    CA::PointList _edge;            //!< The cells on the edge of the domain.
+    std::vector<CA::Real> _wd;      //!< The water depth of the edge cells.
+};
+
+
+/// ----- Inline implementation ----- ///
+
+
+inline CA::Box ReachDomain::extent() const
+{
+    return _extent;
+}
+
+
+inline CA::Unsigned ReachDomain::cells() const
+{
+    return _cells;
+}
+
+#endif
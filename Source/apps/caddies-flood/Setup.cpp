@@ -65,8 +65,21 @@ int initSetupFromCSV(const std::string& filename, Setup& setup)
     setup.rast_places = 6;
     setup.update_peak_dt = false;
     setup.expand_domain = false;
+    setup.domain_tile = 32;
+    setup.decomp_eff = 0.0;
+    setup.decomp_lines = 16;
+    setup.wet_fraction = 0.05;
+    setup.wet_halo = 4;
     setup.ignore_upstream = false;
     setup.upstream_reduction = 1.0;
+    setup.reach_domain = false;
+    setup.reach_tol = 1.0;
+    setup.lts_levels = 0;
+    setup.lts_tile = 32;
+    setup.simd_kernels = SIMD::AUTO;
+    setup.fused_sweep = true;
+    setup.block_steps = 1;
+    setup.pipelined_update = false;
 
     // Read values
     std::ifstream ifile(filename.c_str());
@@ -319,6 +332,21 @@ int initSetupFromCSV(const std::string& filename, Setup& setup)
             READ_TOKEN(found_tok, setup.expand_domain, str, tokens[0]);
         }
 
+        if (CA::compareCaseInsensitive("Domain Tile Size", tokens[0], true))
+            READ_TOKEN(found_tok, setup.domain_tile, tokens[1], tokens[0]);
+
+        if (CA::compareCaseInsensitive("Decomposition Efficiency", tokens[0], true))
+            READ_TOKEN(found_tok, setup.decomp_eff, tokens[1], tokens[0]);
+
+        if (CA::compareCaseInsensitive("Decomposition Min Lines", tokens[0], true))
+            READ_TOKEN(found_tok, setup.decomp_lines, tokens[1], tokens[0]);
+
+        if (CA::compareCaseInsensitive("Wet Cells Fraction", tokens[0], true))
+            READ_TOKEN(found_tok, setup.wet_fraction, tokens[1], tokens[0]);
+
+        if (CA::compareCaseInsensitive("Wet Cells Halo", tokens[0], true))
+            READ_TOKEN(found_tok, setup.wet_halo, tokens[1], tokens[0]);
+
         if (CA::compareCaseInsensitive("Ignore Upstream", tokens[0], true))
         {
             std::string str = CA::trimToken(tokens[1]);
@@ -328,6 +356,39 @@ int initSetupFromCSV(const std::string& filename, Setup& setup)
         if (CA::compareCaseInsensitive("Upstream Reduction", tokens[0], true))
             READ_TOKEN(found_tok, setup.upstream_reduction, tokens[1], tokens[0]);
 
+        if (CA::compareCaseInsensitive("Reach Domain", tokens[0], true))
+        {
+            std::string str = CA::trimToken(tokens[1]);
+            READ_TOKEN(found_tok, setup.reach_domain, str, tokens[0]);
+        }
+
+        if (CA::compareCaseInsensitive("Reach Head Tolerance", tokens[0], true))
+            READ_TOKEN(found_tok, setup.reach_tol, tokens[1], tokens[0]);
+
+        if (CA::compareCaseInsensitive("Local Time Step Levels", tokens[0], true))
+            READ_TOKEN(found_tok, setup.lts_levels, tokens[1], tokens[0]);
+
+        if (CA::compareCaseInsensitive("Local Time Step Tile Size", tokens[0], true))
+            READ_TOKEN(found_tok, setup.lts_tile, tokens[1], tokens[0]);
+
+        if (CA::compareCaseInsensitive("SIMD Kernels", tokens[0], true))
+            READ_TOKEN(found_tok, setup.simd_kernels, tokens[1], tokens[0]);
+
+        if (CA::compareCaseInsensitive("Fused Sweep", tokens[0], true))
+        {
+            std::string str = CA::trimToken(tokens[1]);
+            READ_TOKEN(found_tok, setup.fused_sweep, str, tokens[0]);
+        }
+
+        if (CA::compareCaseInsensitive("Temporal Block Steps", tokens[0], true))
+            READ_TOKEN(found_tok, setup.block_steps, tokens[1], tokens[0]);
+
+        if (CA::compareCaseInsensitive("Pipelined Update", tokens[0], true))
+        {
+            std::string str = CA::trimToken(tokens[1]);
+            READ_TOKEN(found_tok, setup.pipelined_update, str, tokens[0]);
+        }
+
         // If the token was not identified stop!
         if (!found_tok)
         {
@@ -348,6 +409,20 @@ int initSetupFromCSV(const std::string& filename, Setup& setup)
     if (r > 0.0)
         setup.time_end += setup.time_updatedt - r;
 
+    // The decomposition needs at least two lines in a side of a box.
+    setup.decomp_lines = std::max(setup.decomp_lines, static_cast<CA::Unsigned>(2));
+
+    // The list of the wet cells needs at least one cell of halo.
+    setup.wet_halo = std::max(setup.wet_halo, static_cast<CA::Unsigned>(1));
+
+    // The tiles of the local time steps need at least one cell and the
+    // step of a level is at most 2^15 global steps.
+    setup.lts_tile = std::max(setup.lts_tile, static_cast<CA::Unsigned>(1));
+    setup.lts_levels = std::min(setup.lts_levels, static_cast<CA::Unsigned>(15));
+
+    // A sweep computes at least one step.
+    setup.block_steps = std::max(setup.block_steps, static_cast<CA::Unsigned>(1));
+
     // If the preproc base name is empty use the simulation short name.
     if (setup.preproc_name.empty())
         setup.preproc_name = setup.short_name;
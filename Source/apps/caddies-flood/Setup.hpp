@@ -127,8 +127,21 @@ struct Setup
 
     // --- OPTIMISATIONS ---
     bool     expand_domain;         //!< If true expand the computational domain when needed.
+    CA::Unsigned domain_tile;       //!< The size of the tiles of the expanded domain, zero to expand a single box (default 32).
+    CA::Real decomp_eff;            //!< The efficiency threshold of the domain decomposition, zero to not decompose (default).
+    CA::Unsigned decomp_lines;      //!< The minimum number of lines in a side of a box of the decomposition (default 16).
+    CA::Real wet_fraction;          //!< The wet fraction below which only the list of the wet cells is computed, zero to never use it (default 0.05).
+    CA::Unsigned wet_halo;          //!< The halo around the wet cells of the list (default 4).
     bool     ignore_upstream;       //!< If true ignore upstream cells.
     CA::Real upstream_reduction;    //!< The amount of elevation to reduce
+    bool     reach_domain;          //!< If true compute only the cells that the water of the events can reach (default false).
+    CA::Real reach_tol;             //!< The head of water that can climb over the lowest cell of its path (default 1.0).
+    CA::Unsigned lts_levels;        //!< The highest level of the local time steps (a step of 2^level dt), zero to use the global dt only (default).
+    CA::Unsigned lts_tile;          //!< The size of the tiles of the local time steps (default 32).
+    SIMD::Type simd_kernels;        //!< The SIMD kernels of the CA functions (default auto).
+    bool     fused_sweep;           //!< If true compute outflow and water depth in a single sweep (default true).
+    CA::Unsigned block_steps;       //!< The maximum number of steps with the same dt computed in a single sweep (default 1).
+    bool     pipelined_update;      //!< If true compute the velocity of the update step in the sweep of the outflux (default false).
 };
 
 
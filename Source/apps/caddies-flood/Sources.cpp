@@ -0,0 +1,89 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+//! \file Sources.cpp
+//! Contains the application of the sources of the water depth.
+//! \date 2026-10
+
+
+#include"ca2D.hpp"
+#include"Sources.hpp"
+
+// -------------------------//
+// Include the CA 2D functions //
+// -------------------------//
+#include CA_2D_INCLUDE(addRain)
+#include CA_2D_INCLUDE(addInflow)
+#include CA_2D_INCLUDE(addRaise)
+
+
+// Apply the sources on their boxes.
+void applySources(CA::Grid& GRID,
+    CA::CellBuffReal& WD, CA::CellBuffReal& ELV, CA::CellBuffMask& MASK,
+    const WDSources& sources)
+{
+    for (size_t i = 0; i < sources.size(); ++i)
+    {
+        switch (sources[i].type)
+        {
+        case WDSource::ADD:
+            CA::Execute::function(sources[i].box, addRain, GRID, WD, MASK, sources[i].value);
+            break;
+        case WDSource::VOLUME:
+            CA::Execute::function(sources[i].box, addInflow, GRID, WD, MASK, sources[i].value);
+            break;
+        case WDSource::LEVEL:
+            CA::Execute::function(sources[i].box, addRaise, GRID, WD, ELV, MASK, sources[i].value);
+            break;
+        }
+    }
+}
+
+
+// Check if the sources can be applied by the water depth update of
+// the given box list.
+bool coversSources(const CA::BoxList& bl, CA::Grid& GRID, const WDSources& sources)
+{
+    // The CA functions are not executed if the box list is not inside
+    // the grid.
+    if (!GRID.box().inside(bl.extent()))
+        return sources.empty();
+
+    for (size_t i = 0; i < sources.size(); ++i)
+    {
+        // A source outside the grid is ignored.
+        if (!GRID.box().inside(sources[i].box))
+            continue;
+
+        bool covered = false;
+        for (CA::BoxList::ConstIter ibox = bl.begin(); ibox != bl.end() && !covered; ++ibox)
+            covered = ibox->inside(sources[i].box);
+
+        if (!covered)
+            return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,83 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef _SOURCES_HPP_
+#define _SOURCES_HPP_
+
+
+//! \file Sources.hpp
+//! Contains the structure that describes the water added or set by
+//! the events (rain, inflow, water level) in a time step. The sources
+//! are applied by the water depth update.
+//! \date 2026-10
+
+
+#include"ca2D.hpp"
+#include"BaseTypes.hpp"
+#include"Box.hpp"
+#include<vector>
+
+
+//! The change of the water depth of the cells of a box in a time
+//! step. The change is applied only to the cells with data.
+struct WDSource
+{
+    //! The type of change.
+    enum Type
+    {
+        ADD = 0,    //!< Add the value to the water depth (rain).
+        VOLUME,     //!< Add the value divided by the cell area (inflow).
+        LEVEL       //!< Set the water depth to the value minus the elevation (water level).
+    };
+
+    CA::Box  box;       //!< The box of the cells.
+    Type     type;      //!< The type of change.
+    CA::Real value;     //!< The depth, volume or level.
+
+    WDSource(const CA::Box& b, Type t, CA::Real v) :
+        box(b), type(t), value(v)
+    {}
+};
+
+
+//! The list of sources of a time step. The sources are applied in
+//! order, i.e. rain, inflow and then water level.
+typedef std::vector<WDSource> WDSources;
+
+
+//! Apply the sources by executing the CA function of each source on
+//! its box. A source whose box is not inside the grid is ignored.
+void applySources(CA::Grid& GRID,
+    CA::CellBuffReal& WD, CA::CellBuffReal& ELV, CA::CellBuffMask& MASK,
+    const WDSources& sources);
+
+
+//! Return true if the sources can be applied by the water depth
+//! update of the given box list, i.e. the extent of the box list is
+//! inside the grid and the box of each source inside the grid is
+//! inside a box of the list.
+bool coversSources(const CA::BoxList& bl, CA::Grid& GRID, const WDSources& sources);
+
+#endif
@@ -34,6 +34,8 @@ THE SOFTWARE.
 #include"Utilities.hpp"
 #include<iostream>
 #include<fstream>
+#include<limits>
+#include<algorithm>
 
 
 // Initialise the TimePlot structure using a CSV file.
@@ -230,6 +232,20 @@ void TPManager::output(CA::Real t, CA::Unsigned iter, CA::CellBuffReal& WD, CA::
 }
 
 
+CA::Real TPManager::nextTime() const
+{
+    CA::Real time_next = std::numeric_limits<CA::Real>::max();
+
+    for (size_t i = 0; i < _datas.size(); ++i)
+    {
+        if (_datas[i].file->good())
+            time_next = std::min(time_next, _datas[i].time_next);
+    }
+
+    return time_next;
+}
+
+
 int TPManager::initData(const std::string& filename, const TimePlot& tp, Data& tpdata)
 {
     // Create file
@@ -105,6 +105,9 @@ public:
     //! \params output  If true, output information to console.
     void output(CA::Real t, CA::Unsigned iter, CA::CellBuffReal& WD, CA::CellBuffReal& V, bool output);
 
+    //! Return the time of the next output of the time plots.
+    CA::Real nextTime() const;
+
 protected:
 
     //! Initialise the time plot data that is used during the
@@ -0,0 +1,97 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+//! \file UpstreamCells.cpp
+//! Contains the removal of the upstream cells.
+//! \date 2026-10
+
+
+#include"UpstreamCells.hpp"
+#include<algorithm>
+
+
+UpstreamCells::UpstreamCells(CA::Grid& GRID, CA::CellBuffReal& ELV, CA::CellBuffMask& MASK,
+    const CA::BoxList& domain) :
+    _cells(),
+    _next(0),
+    _removed(),
+    _mask()
+{
+    std::vector<CA::Real>  elv;
+    std::vector<CA::Mask> mask;
+
+    for (CA::BoxList::ConstIter ibox = domain.begin(); ibox != domain.end(); ++ibox)
+    {
+        CA::Box box(*ibox);
+        box.limit(GRID.box());
+        if (box.empty())
+            continue;
+
+        elv.resize(box.size());
+        mask.resize(box.size());
+        ELV.retrieveData(box, &elv[0], box.w(), box.h());
+        MASK.retrieveData(box, &mask[0], box.w(), box.h());
+
+        for (CA::Unsigned j = 0; j < box.h(); ++j)
+        {
+            for (CA::Unsigned i = 0; i < box.w(); ++i)
+            {
+                // The data bit is true if the cell has data.
+                if (caMaskData(mask[j * box.w() + i], 0) == 0)
+                    continue;
+
+                Cell c = { elv[j * box.w() + i], box.x() + i, box.y() + j };
+                _cells.push_back(c);
+            }
+        }
+    }
+
+    std::sort(_cells.begin(), _cells.end());
+}
+
+
+CA::Unsigned UpstreamCells::remove(CA::CellBuffMask& MASK, CA::Real upstr_elv)
+{
+    _removed.clear();
+
+    // The cells over the upstream elevation are at the start of the
+    // cells not removed yet.
+    for (; _next < _cells.size() && _cells[_next].elv > upstr_elv; ++_next)
+        _removed.add(CA::Point(_cells[_next].x, _cells[_next].y));
+
+    if (_removed.size() == 0)
+        return 0;
+
+    // Set the data bit of the mask of these cells to false.
+    _mask.resize(_removed.size());
+    MASK.retrievePoints(_removed, &_mask[0], _removed.size());
+
+    for (size_t k = 0; k < _mask.size(); ++k)
+        _mask[k] = caMaskSetData(_mask[k], 0, 0);
+
+    MASK.insertPoints(_removed, &_mask[0], _removed.size());
+
+    return _removed.size();
+}
@@ -0,0 +1,107 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef _UPSTREAMCELLS_HPP_
+#define _UPSTREAMCELLS_HPP_
+
+
+//! \file UpstreamCells.hpp
+//! Contains the class that removes the upstream cells, i.e. the data
+//! cells over the upstream elevation, using the data cells sorted by
+//! elevation.
+//! \date 2026-10
+
+
+#include"ca2D.hpp"
+#include"BaseTypes.hpp"
+#include"BoxList.hpp"
+#include"PointList.hpp"
+#include<vector>
+
+
+//! Manage the removal of the upstream cells. The data cells of the
+//! domain are sorted by decreasing elevation once at the start, thus
+//! each removal visits only the cells between the previous and the
+//! new upstream elevation, instead of the whole domain. The elevation
+//! of the data cells must not change.
+class UpstreamCells
+{
+public:
+
+    //! Create the sorted list of the data cells of the domain, the MASK
+    //! is used to identify the data cells.
+    UpstreamCells(CA::Grid& GRID, CA::CellBuffReal& ELV, CA::CellBuffMask& MASK, const CA::BoxList& domain);
+
+    //! Remove the data cells with elevation over the given upstream
+    //! elevation, i.e. set the data bit of the MASK to false.
+    //! \return The number of cells removed.
+    CA::Unsigned remove(CA::CellBuffMask& MASK, CA::Real upstr_elv);
+
+    //! Return the cells removed by the last removal.
+    const CA::PointList& removed() const;
+
+    //! Return the number of data cells not removed yet.
+    CA::Unsigned size() const;
+
+protected:
+
+    //! A data cell and its elevation.
+    struct Cell
+    {
+        CA::Real     elv;
+        CA::Unsigned x;
+        CA::Unsigned y;
+
+        //! Order the cells by decreasing elevation.
+        bool operator<(const Cell& c) const
+        {
+            return elv > c.elv;
+        }
+    };
+
+private:
+
+    std::vector<Cell> _cells;       //!< The data cells sorted by decreasing elevation.
+    CA::Unsigned      _next;        //!< The highest cell not removed yet.
+    CA::PointList     _removed;     //!< The cells removed by the last removal.
+    std::vector<CA::Mask>  _mask;   //!< The mask of the removed cells.
+};
+
+
+/// ----- Inline implementation ----- ///
+
+
+inline const CA::PointList& UpstreamCells::removed() const
+{
+    return _removed;
+}
+
+
+inline CA::Unsigned UpstreamCells::size() const
+{
+    return static_cast<CA::Unsigned>(_cells.size()) - _next;
+}
+
+#endif
@@ -0,0 +1,948 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+//! \file WCA2Dsimd.cpp
+//! Contains the selection of the SIMD kernels and the execution of
+//! the row kernels.
+//! \date 2026-10
+
+
+#include"ca2D.hpp"
+#include"ArgsData.hpp"
+#include"WCA2Dsimd.hpp"
+#include"WCA2DsimdKernels.hpp"
+#include<cmath>
+#include<algorithm>
+#include<limits>
+
+#if defined _MSC_VER && (defined _M_X64 || defined _M_IX86)
+#include<intrin.h>
+#endif
+
+
+// -------------------------//
+// Include the CA 2D functions //
+// -------------------------//
+#include CA_2D_INCLUDE(outflowWCA2Dv2)
+#include CA_2D_INCLUDE(waterdepth)
+#include CA_2D_INCLUDE(velocityDiffusive)
+#include CA_2D_INCLUDE(lastOutflow)
+
+
+//! \def WCA2D_SIMD
+//! Defined if the SIMD kernels can be used, i.e. the implementation
+//! can execute a row function, the neighbourhood is von Neumann, the
+//! real values are single precision and the cells of a row of a cell
+//! buffer are contiguous (no tiles, see CA_CELL_TILE).
+#if defined CA2D_ROWS && !defined CA2D_MOORE && CA_REAL_PRECISION == CA_REAL_FLOAT && CA_CELL_TILE == 1
+#define WCA2D_SIMD
+#endif
+
+
+namespace {
+
+    //! Return true if the processor supports the given instruction set.
+    bool cpuSupports(SIMD::Type simd)
+    {
+#if defined __GNUC__ && (defined __x86_64__ || defined __i386__)
+        __builtin_cpu_init();
+        switch (simd)
+        {
+        case SIMD::SSE42:  return __builtin_cpu_supports("sse4.2") != 0;
+        case SIMD::AVX2:   return __builtin_cpu_supports("avx2") != 0;
+        case SIMD::AVX512: return __builtin_cpu_supports("avx512f") != 0;
+        default:           return false;
+        }
+#elif defined _MSC_VER && (defined _M_X64 || defined _M_IX86)
+        int info[4];
+        __cpuid(info, 0);
+        int nids = info[0];
+        __cpuid(info, 1);
+        bool sse42 = (info[2] & (1 << 20)) != 0;
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+        int ebx7 = 0;
+        if (nids >= 7)
+        {
+            __cpuidex(info, 7, 0);
+            ebx7 = info[1];
+        }
+        switch (simd)
+        {
+        case SIMD::SSE42:  return sse42;
+        case SIMD::AVX2:   return avx && (xcr0 & 0x6) == 0x6 && (ebx7 & (1 << 5)) != 0;
+        case SIMD::AVX512: return (xcr0 & 0xE6) == 0xE6 && (ebx7 & (1 << 16)) != 0;
+        default:           return false;
+        }
+#else
+        return false;
+#endif
+    }
+
+
+    //! Return the row kernels of the given instruction set or null if
+    //! they were not compiled.
+    const WCA2DRowKernels* rowKernels(SIMD::Type simd)
+    {
+        switch (simd)
+        {
+        case SIMD::SSE42:  return rowKernelsSSE42();
+        case SIMD::AVX2:   return rowKernelsAVX2();
+        case SIMD::AVX512: return rowKernelsAVX512();
+        default:           return 0;
+        }
+    }
+
+}
+
+
+// Return the SIMD kernels to use given the requested one.
+SIMD::Type selectSIMD(SIMD::Type request)
+{
+#ifdef WCA2D_SIMD
+    switch (request)
+    {
+    case SIMD::AUTO:
+    case SIMD::AVX512:
+        if (rowKernels(SIMD::AVX512) && cpuSupports(SIMD::AVX512))
+            return SIMD::AVX512;
+        // fall through
+    case SIMD::AVX2:
+        if (rowKernels(SIMD::AVX2) && cpuSupports(SIMD::AVX2))
+            return SIMD::AVX2;
+        // fall through
+    case SIMD::SSE42:
+        if (rowKernels(SIMD::SSE42) && cpuSupports(SIMD::SSE42))
+            return SIMD::SSE42;
+        // fall through
+    default:
+        break;
+    }
+#endif
+    return SIMD::NONE;
+}
+
+
+#ifdef WCA2D_SIMD
+
+namespace {
+
+    //! Return the index of the main cell in a cell buffer.
+    inline std::ptrdiff_t cellIndex(CA_GRID grid)
+    {
+        return (grid.main_y + grid.cb_border) * grid.cb_x_pitch + grid.main_x + grid.cb_border;
+    }
+
+
+    //! Return the index of the north edge of the main cell in an edge buffer.
+    inline std::ptrdiff_t nsIndex(CA_GRID grid)
+    {
+        return (grid.main_y + grid.eb_ns_y_border) * grid.eb_ns_x_pitch + grid.main_x + grid.eb_ns_start;
+    }
+
+
+    //! Return the index of the west edge of the main cell in an edge buffer.
+    inline std::ptrdiff_t weIndex(CA_GRID grid)
+    {
+        return grid.main_y * grid.eb_we_x_pitch + grid.main_x + grid.eb_we_x_border + grid.eb_we_start;
+    }
+
+
+    //! The row function that executes outflowWCA2Dv2. It returns the number of
+    //! computed cells.
+    struct OutflowWCA2Dv2Rows
+    {
+        size_t(*kernel)(const OutflowWCA2Dv2Row& r, size_t n, size_t& work);
+        OutflowWCA2Dv2Row args;
+        CA::Real* OUTF1;
+        CA::Real* OUTF2;
+        CA::Real* ELV;
+        CA::Real* WD;
+        CA::Mask* MASK;
+        char* ALARMS;
+
+        CA::Unsigned operator()(CA_GRID grid, CA::Unsigned n) const
+        {
+            const std::ptrdiff_t c = cellIndex(grid);
+            const std::ptrdiff_t ns = nsIndex(grid);
+            const std::ptrdiff_t we = weIndex(grid);
+
+            // The alarms of the sides of the box crossed by the cells
+            // computed by the kernel.
+            char alarm[5] = { 0, 0, 0, 0, 0 };
+
+            OutflowWCA2Dv2Row r(args);
+            r.outf1_we = OUTF1 + we;
+            r.outf1_ns = OUTF1 + ns;
+            r.outf2_we = OUTF2 + we;
+            r.outf2_ns = OUTF2 + ns;
+            r.elv = ELV + c;
+            r.wd = WD + c;
+            r.mask = MASK + c;
+            r.alarm = alarm;
+            r.box_top = (grid.main_y == grid.bx_ty);
+            r.box_bottom = (grid.main_y == grid.bx_by - 1);
+            r.box_left = (grid.main_x == grid.bx_lx);
+            r.box_right = (grid.main_x + n == grid.bx_rx);
+
+            // Compute the remaining cells with the CA function.
+            size_t work = 0;
+            _caGrid g(grid);
+            for (size_t i = kernel(r, n, work); i < n; ++i, ++work)
+            {
+                g.main_x = grid.main_x + i;
+                outflowWCA2Dv2(g, OUTF1, OUTF2, ELV, WD, MASK, ALARMS,
+                    args.ignore_wd, args.tol_delwl, args.dt, args.ratio_dt, args.irough);
+            }
+
+            for (int k = 1; k <= 4; ++k)
+            {
+                if (alarm[k])
+                {
+                    caActivateAlarm(grid, ALARMS, 0);
+                    caActivateAlarm(grid, ALARMS, k);
+                }
+            }
+
+            return work;
+        }
+    };
+
+
+    //! The row function that executes waterdepth and then applies the
+    //! sources to the cells of the row. It returns the number of
+    //! computed cells.
+    struct WaterDepthRows
+    {
+        size_t(*kernel)(const WaterDepthRow& r, size_t n, size_t& work);
+        WaterDepthRow args;
+        CA::Real* WD;
+        CA::Real* OUTF1;
+        CA::Real* OUTF2;
+        CA::Real* ELV;
+        CA::Mask* MASK;
+        CA::Real dt;
+        const WDSource* sources;
+        size_t nsources;
+
+        CA::Unsigned operator()(CA_GRID grid, CA::Unsigned n) const
+        {
+            const std::ptrdiff_t c = cellIndex(grid);
+            const std::ptrdiff_t ns = nsIndex(grid);
+            const std::ptrdiff_t we = weIndex(grid);
+
+            WaterDepthRow r(args);
+            r.wd = WD + c;
+            r.outf1_we = OUTF1 + we;
+            r.outf1_ns = OUTF1 + ns;
+            r.outf2_we = OUTF2 + we;
+            r.outf2_ns = OUTF2 + ns;
+            r.mask = MASK + c;
+
+            // Compute the remaining cells with the CA function.
+            size_t work = 0;
+            _caGrid g(grid);
+            for (size_t i = kernel(r, n, work); i < n; ++i, ++work)
+            {
+                g.main_x = grid.main_x + i;
+                waterdepth(g, WD, OUTF1, OUTF2, MASK, dt);
+            }
+
+            // Apply the sources, in order, to the cells of the row with
+            // data as the addRain, addInflow and addRaise CA functions.
+            for (size_t k = 0; k < nsources; ++k)
+            {
+                const CA::Box& box = sources[k].box;
+                if (grid.main_y < box.top() || grid.main_y >= box.bottom())
+                    continue;
+
+                const CA::Unsigned lx = std::max(box.left(), grid.main_x);
+                const CA::Unsigned rx = std::min(box.right(), grid.main_x + n);
+                const CA::Real value = sources[k].value;
+
+                for (CA::Unsigned x = lx; x < rx; ++x)
+                {
+                    const std::ptrdiff_t i = c + (x - grid.main_x);
+                    if (!caMaskData(MASK[i], 0))
+                        continue;
+
+                    switch (sources[k].type)
+                    {
+                    case WDSource::ADD:    WD[i] = WD[i] + value; break;
+                    case WDSource::VOLUME: WD[i] = WD[i] + (value / args.area); break;
+                    case WDSource::LEVEL:  WD[i] = value - ELV[i]; break;
+                    }
+                }
+            }
+
+            return work;
+        }
+    };
+
+
+    //! The row function that executes velocityDiffusive. It returns the number of
+    //! computed cells.
+    struct VelocityDiffusiveRows
+    {
+        size_t(*kernel)(const VelocityDiffusiveRow& r, size_t n, size_t& work);
+        VelocityDiffusiveRow args;
+        CA::Real* V;
+        CA::Real* A;
+        CA::Real* WD;
+        CA::Real* ELV;
+        CA::Real* OUTF;
+        CA::Mask* MASK;
+        char* ALARMS;
+        CA::Real* VAMAX;
+        CA::Real* DTMIN;
+
+        CA::Unsigned operator()(CA_GRID grid, CA::Unsigned n) const
+        {
+            const std::ptrdiff_t c = cellIndex(grid);
+            const std::ptrdiff_t ns = nsIndex(grid);
+            const std::ptrdiff_t we = weIndex(grid);
+
+            // The maximum velocity, minimum possible dt and alarm of
+            // the cells computed by the kernel.
+            float vamax = -std::numeric_limits<float>::max();
+            float dtmin = std::numeric_limits<float>::max();
+            char alarm = 0;
+
+            VelocityDiffusiveRow r(args);
+            r.v = V + c;
+            r.a = A + c;
+            r.vamax = &vamax;
+            r.dtmin = &dtmin;
+            r.wd = WD + c;
+            r.elv = ELV + c;
+            r.outf_we = OUTF + we;
+            r.outf_ns = OUTF + ns;
+            r.mask = MASK + c;
+            r.alarm = &alarm;
+
+            // Compute the remaining cells with the CA function.
+            size_t work = 0;
+            _caGrid g(grid);
+            for (size_t i = kernel(r, n, work); i < n; ++i, ++work)
+            {
+                g.main_x = grid.main_x + i;
+                velocityDiffusive(g, V, A, WD, ELV, OUTF, MASK, ALARMS, VAMAX, DTMIN,
+                    args.tol_wd, args.tol_slope, args.prev_dt, args.irough, args.upstr_elv);
+            }
+
+            caReduceMaxReal(grid, VAMAX, vamax);
+            caReduceMinReal(grid, DTMIN, dtmin);
+
+            if (alarm)
+                caActivateAlarm(grid, ALARMS, 0);
+
+            return work;
+        }
+    };
+
+
+    //! Return the row function that executes outflowWCA2Dv2 with the
+    //! given kernel.
+    OutflowWCA2Dv2Rows outflowWCA2Dv2Rows(size_t(*kernel)(const OutflowWCA2Dv2Row&, size_t, size_t&),
+        CA::Grid& GRID, CA::EdgeBuffReal& OUTF1, CA::EdgeBuffReal& OUTF2,
+        CA::CellBuffReal& ELV, CA::CellBuffReal& WD,
+        CA::CellBuffMask& MASK, CA::Alarms& ALARMS,
+        CA::Real ignore_wd, CA::Real tol_delwl,
+        CA::Real dt, CA::Real ratio_dt, CA::Real irough)
+    {
+        const _caGrid& grid = GRID;
+
+        OutflowWCA2Dv2Rows f;
+        f.kernel = kernel;
+        f.args.cb_x_pitch = grid.cb_x_pitch;
+        f.args.eb_ns_x_pitch = grid.eb_ns_x_pitch;
+        f.args.ignore_wd = ignore_wd;
+        f.args.tol_delwl = tol_delwl;
+        f.args.dt = dt;
+        f.args.ratio_dt = ratio_dt;
+        f.args.irough = irough;
+        f.args.area = caArea(grid, 0);
+        f.args.length = caLength(grid, 0, 1);
+        f.args.distance = caDistance(grid, 1);
+        f.OUTF1 = OUTF1;
+        f.OUTF2 = OUTF2;
+        f.ELV = ELV;
+        f.WD = WD;
+        f.MASK = MASK;
+        f.ALARMS = ALARMS;
+
+        return f;
+    }
+
+
+    //! Return the row function that executes waterdepth with the given
+    //! kernel.
+    WaterDepthRows waterdepthRows(size_t(*kernel)(const WaterDepthRow&, size_t, size_t&),
+        CA::Grid& GRID, CA::CellBuffReal& WD, CA::EdgeBuffReal& OUTF1, CA::EdgeBuffReal& OUTF2,
+        CA::CellBuffReal& ELV, CA::CellBuffMask& MASK, CA::Real dt, const WDSources& sources)
+    {
+        const _caGrid& grid = GRID;
+
+        WaterDepthRows f;
+        f.kernel = kernel;
+        f.args.eb_ns_x_pitch = grid.eb_ns_x_pitch;
+        f.args.area = caArea(grid, 0);
+        f.WD = WD;
+        f.OUTF1 = OUTF1;
+        f.OUTF2 = OUTF2;
+        f.ELV = ELV;
+        f.MASK = MASK;
+        f.dt = dt;
+        f.sources = sources.empty() ? 0 : &sources[0];
+        f.nsources = sources.size();
+
+        return f;
+    }
+
+
+    //! Return the row function that executes velocityDiffusive with
+    //! the given kernel.
+    VelocityDiffusiveRows velocityDiffusiveRows(size_t(*kernel)(const VelocityDiffusiveRow&, size_t, size_t&),
+        CA::Grid& GRID, CA::CellBuffReal& V, CA::CellBuffReal& A,
+        CA::CellBuffReal& WD, CA::CellBuffReal& ELV,
+        CA::EdgeBuffReal& OUTF,
+        CA::CellBuffMask& MASK, CA::Alarms& ALARMS,
+        CA::ReductionReal& VAMAX, CA::ReductionReal& DTMIN,
+        CA::Real tol_wd, CA::Real tol_slope,
+        CA::Real prev_dt, CA::Real irough,
+        CA::Real upstr_elv)
+    {
+        const _caGrid& grid = GRID;
+
+        VelocityDiffusiveRows f;
+        f.kernel = kernel;
+        f.args.cb_x_pitch = grid.cb_x_pitch;
+        f.args.eb_ns_x_pitch = grid.eb_ns_x_pitch;
+        f.args.tol_wd = tol_wd;
+        f.args.tol_slope = tol_slope;
+        f.args.prev_dt = prev_dt;
+        f.args.irough = irough;
+        f.args.upstr_elv = upstr_elv;
+        f.args.area = caArea(grid, 0);
+        f.args.length = caLength(grid, 0, 1);
+        f.args.distance = caDistance(grid, 1);
+
+        // The velocity is computed if its absolute value is over the
+        // tolerance (as double). Find the largest float that is not
+        // over the tolerance.
+        f.args.tol_vel = static_cast<float>(0.0001);
+        if (f.args.tol_vel > 0.0001)
+            f.args.tol_vel = std::nextafter(f.args.tol_vel, 0.0f);
+
+        // The cosine and sine of the angle of each neighbour.
+        CA_REAL ANGLE[caNeighbours + 1];
+        caAngleCellArray(grid, ANGLE);
+        for (int k = 0; k <= caNeighbours; ++k)
+        {
+            f.args.cos[k] = caCosReal(ANGLE[k]);
+            f.args.sin[k] = caSinReal(ANGLE[k]);
+        }
+
+        f.V = V;
+        f.A = A;
+        f.WD = WD;
+        f.ELV = ELV;
+        f.OUTF = OUTF;
+        f.MASK = MASK;
+        f.ALARMS = ALARMS;
+        f.VAMAX = VAMAX;
+        f.DTMIN = DTMIN;
+
+        return f;
+    }
+
+
+    //! Return the sources whose box is inside the grid, the others are
+    //! ignored as by the CA functions.
+    WDSources gridSources(CA::Grid& GRID, const WDSources& sources)
+    {
+        WDSources inside;
+        for (size_t i = 0; i < sources.size(); ++i)
+        {
+            if (GRID.box().inside(sources[i].box))
+                inside.push_back(sources[i]);
+        }
+
+        return inside;
+    }
+
+
+    //! The kernel used when there are no SIMD kernels, all the cells
+    //! are computed by the CA function.
+    template<typename Row>
+    size_t scalarRow(const Row&, size_t, size_t&)
+    {
+        return 0;
+    }
+
+
+    //! Set the row functions of the steps of outflowWaterdepthStepsSIMD,
+    //! the sources of each step inside the grid are stored in inside.
+    //! It returns false if the sources of a step are not covered by the
+    //! box list, then each step must be computed by its own sweep.
+    bool stepsRows(SIMD::Type simd, const CA::BoxList& bl, CA::Grid& GRID,
+        CA::EdgeBuffReal& OUTF1, CA::EdgeBuffReal& OUTF2,
+        CA::CellBuffReal& ELV, CA::CellBuffReal& WD,
+        CA::CellBuffMask& MASK, CA::Alarms& ALARMS,
+        CA::Real ignore_wd, CA::Real tol_delwl,
+        CA::Real dt, CA::Real ratio_dt, CA::Real irough,
+        const std::vector<WDSources>& sources, std::vector<WDSources>& inside,
+        std::vector<OutflowWCA2Dv2Rows>& f1, std::vector<WaterDepthRows>& f2)
+    {
+        const size_t k = sources.size();
+
+        // The sources of all the steps must be applied by the water
+        // depth update.
+        for (size_t s = 0; s < k; ++s)
+        {
+            if (!coversSources(bl, GRID, sources[s]))
+                return false;
+        }
+
+        const WCA2DRowKernels* kernels = rowKernels(simd);
+
+        inside.resize(k);
+        for (size_t s = 0; s < k; ++s)
+            inside[s] = gridSources(GRID, sources[s]);
+
+        // The step s writes the outflux in OUTF1 and reads the previous
+        // one from OUTF2 if s is even, the opposite otherwise.
+        f1.clear();
+        f2.clear();
+        for (size_t s = 0; s < k; ++s)
+        {
+            CA::EdgeBuffReal& O1 = (s % 2 == 0) ? OUTF1 : OUTF2;
+            CA::EdgeBuffReal& O2 = (s % 2 == 0) ? OUTF2 : OUTF1;
+
+            f1.push_back(outflowWCA2Dv2Rows(kernels ? kernels->outflowWCA2Dv2 : &scalarRow<OutflowWCA2Dv2Row>,
+                GRID, O1, O2, ELV, WD, MASK, ALARMS, ignore_wd, tol_delwl, dt, (s == 0) ? ratio_dt : 1.0, irough));
+            f2.push_back(waterdepthRows(kernels ? kernels->waterdepth : &scalarRow<WaterDepthRow>,
+                GRID, WD, O1, O2, ELV, MASK, dt, inside[s]));
+        }
+
+        return true;
+    }
+
+
+    //! The row function that sets the flag of each cell of the row to
+    //! true if the cell is wet, i.e. it has data and at least the water
+    //! depth that can be ignored (the cells computed by outflowWCA2Dv2).
+    struct WetCellsRows
+    {
+        CA::Real* WD;
+        CA::Mask* MASK;
+        CA::Real ignore_wd;
+        char* wet;
+        CA::Unsigned width;
+
+        CA::Unsigned operator()(CA_GRID grid, CA::Unsigned n) const
+        {
+            const std::ptrdiff_t c = cellIndex(grid);
+            char* flags = wet + static_cast<std::ptrdiff_t>(grid.main_y) * width + grid.main_x;
+
+            for (CA::Unsigned i = 0; i < n; ++i)
+                flags[i] = caMaskData(MASK[c + i], 0) && !(WD[c + i] < ignore_wd);
+
+            return n;
+        }
+    };
+
+
+    //! The row function that clears the four edges of each cell of the
+    //! row.
+    struct ClearEdgesRows
+    {
+        CA::Real* E;
+
+        CA::Unsigned operator()(CA_GRID grid, CA::Unsigned n) const
+        {
+            const std::ptrdiff_t ns = nsIndex(grid);
+            const std::ptrdiff_t we = weIndex(grid);
+
+            std::fill(E + we, E + we + n + 1, static_cast<CA::Real>(0.0));
+            std::fill(E + ns, E + ns + n, static_cast<CA::Real>(0.0));
+            std::fill(E + ns + grid.eb_ns_x_pitch, E + ns + grid.eb_ns_x_pitch + n, static_cast<CA::Real>(0.0));
+
+            return n;
+        }
+    };
+
+
+    //! The row function that records the outflux of each cell of the
+    //! row as the lastOutflow CA function.
+    struct RecordOutflowRows
+    {
+        CA::Real* LAST;
+        CA::Real* OUTF;
+
+        CA::Unsigned operator()(CA_GRID grid, CA::Unsigned n) const
+        {
+            const std::ptrdiff_t ns = nsIndex(grid);
+            const std::ptrdiff_t we = weIndex(grid);
+
+            // The east and north edges have a positive outflux, the
+            // west and south ones a negative outflux. An edge is
+            // changed only by the cell that flows through it, thus the
+            // order of the edges does not matter.
+            record<true>(we + 1, n);
+            record<true>(ns, n);
+            record<false>(we, n);
+            record<false>(ns + grid.eb_ns_x_pitch, n);
+
+            return n;
+        }
+
+        //! Record the edges starting from the given index, which have
+        //! a positive outflux if east is true. Only comparisons are
+        //! used, the outflux can be denormal.
+        template<bool east>
+        void record(std::ptrdiff_t start, CA::Unsigned n) const
+        {
+            CA::Real* last = LAST + start;
+            const CA::Real* outf = OUTF + start;
+
+            for (CA::Unsigned i = 0; i < n; ++i)
+            {
+                const CA::Real flux = outf[i];
+                const CA::Real old = last[i];
+                const bool out = east ? (flux > 0) : (flux < 0);
+                const bool erase = (flux == 0) && (east ? (old > 0) : (old < 0));
+
+                last[i] = out ? flux : (erase ? 0 : old);
+            }
+        }
+    };
+
+}
+
+#endif
+
+
+// Execute the outflowWCA2Dv2 CA function using the given SIMD kernels. 
+void outflowWCA2Dv2SIMD(SIMD::Type simd, const CA::BoxList& bl, CA::Grid& GRID,
+    CA::EdgeBuffReal& OUTF1, CA::EdgeBuffReal& OUTF2,
+    CA::CellBuffReal& ELV, CA::CellBuffReal& WD,
+    CA::CellBuffMask& MASK, CA::Alarms& ALARMS,
+    CA::Real ignore_wd, CA::Real tol_delwl,
+    CA::Real dt, CA::Real ratio_dt, CA::Real irough)
+{
+#ifdef WCA2D_SIMD
+    const WCA2DRowKernels* kernels = rowKernels(simd);
+    if (kernels)
+    {
+        CA::executeRowFunction(bl, outflowWCA2Dv2Rows(kernels->outflowWCA2Dv2, GRID,
+            OUTF1, OUTF2, ELV, WD, MASK, ALARMS, ignore_wd, tol_delwl, dt, ratio_dt, irough), GRID);
+        return;
+    }
+#endif
+
+    CA::Execute::function(bl, outflowWCA2Dv2, GRID, OUTF1, OUTF2,
+        ELV, WD, MASK, ALARMS, ignore_wd, tol_delwl, dt, ratio_dt, irough);
+}
+
+
+// Execute the waterdepth CA function and apply the sources using the
+// given SIMD kernels. 
+void waterdepthSIMD(SIMD::Type simd, const CA::BoxList& bl, CA::Grid& GRID,
+    CA::CellBuffReal& WD, CA::EdgeBuffReal& OUTF1, CA::EdgeBuffReal& OUTF2,
+    CA::CellBuffReal& ELV, CA::CellBuffMask& MASK, CA::Real dt,
+    const WDSources& sources)
+{
+#ifdef WCA2D_SIMD
+    // The sources are applied by the water depth update when the box
+    // list covers them, otherwise they are applied on their boxes
+    // after it.
+    const WCA2DRowKernels* kernels = rowKernels(simd);
+    const bool merge = coversSources(bl, GRID, sources);
+    const WDSources inside(merge ? gridSources(GRID, sources) : WDSources());
+
+    CA::executeRowFunction(bl,
+        waterdepthRows(kernels ? kernels->waterdepth : &scalarRow<WaterDepthRow>, GRID,
+            WD, OUTF1, OUTF2, ELV, MASK, dt, inside),
+        GRID);
+
+    if (!merge)
+        applySources(GRID, WD, ELV, MASK, sources);
+#else
+    CA::Execute::function(bl, waterdepth, GRID, WD, OUTF1, OUTF2, MASK, dt);
+    applySources(GRID, WD, ELV, MASK, sources);
+#endif
+}
+
+
+// Execute the outflowWCA2Dv2 and waterdepth CA functions in a single
+// sweep using the given SIMD kernels.
+void outflowWaterdepthSIMD(SIMD::Type simd, const CA::BoxList& bl, CA::Grid& GRID,
+    CA::EdgeBuffReal& OUTF1, CA::EdgeBuffReal& OUTF2,
+    CA::CellBuffReal& ELV, CA::CellBuffReal& WD,
+    CA::CellBuffMask& MASK, CA::Alarms& ALARMS,
+    CA::Real ignore_wd, CA::Real tol_delwl,
+    CA::Real dt, CA::Real ratio_dt, CA::Real irough,
+    const WDSources& sources)
+{
+#ifdef WCA2D_SIMD
+    const WCA2DRowKernels* kernels = rowKernels(simd);
+    const bool merge = coversSources(bl, GRID, sources);
+    const WDSources inside(merge ? gridSources(GRID, sources) : WDSources());
+
+    CA::executeRowFunctions(bl,
+        outflowWCA2Dv2Rows(kernels ? kernels->outflowWCA2Dv2 : &scalarRow<OutflowWCA2Dv2Row>, GRID,
+            OUTF1, OUTF2, ELV, WD, MASK, ALARMS, ignore_wd, tol_delwl, dt, ratio_dt, irough),
+        waterdepthRows(kernels ? kernels->waterdepth : &scalarRow<WaterDepthRow>, GRID,
+            WD, OUTF1, OUTF2, ELV, MASK, dt, inside),
+        GRID);
+
+    if (!merge)
+        applySources(GRID, WD, ELV, MASK, sources);
+#else
+    outflowWCA2Dv2SIMD(simd, bl, GRID, OUTF1, OUTF2, ELV, WD, MASK, ALARMS,
+        ignore_wd, tol_delwl, dt, ratio_dt, irough);
+    waterdepthSIMD(simd, bl, GRID, WD, OUTF1, OUTF2, ELV, MASK, dt, sources);
+#endif
+}
+
+
+// Execute the outflowWCA2Dv2 and waterdepth CA functions for a number
+// of steps in a single sweep using the given SIMD kernels.
+void outflowWaterdepthStepsSIMD(SIMD::Type simd, const CA::BoxList& bl, CA::Grid& GRID,
+    CA::EdgeBuffReal& OUTF1, CA::EdgeBuffReal& OUTF2,
+    CA::CellBuffReal& ELV, CA::CellBuffReal& WD,
+    CA::CellBuffMask& MASK, CA::Alarms& ALARMS,
+    CA::Real ignore_wd, CA::Real tol_delwl,
+    CA::Real dt, CA::Real ratio_dt, CA::Real irough,
+    const std::vector<WDSources>& sources)
+{
+    const size_t k = sources.size();
+
+#ifdef WCA2D_SIMD
+    std::vector<WDSources> inside;
+    std::vector<OutflowWCA2Dv2Rows> f1;
+    std::vector<WaterDepthRows> f2;
+
+    if (stepsRows(simd, bl, GRID, OUTF1, OUTF2, ELV, WD, MASK, ALARMS,
+            ignore_wd, tol_delwl, dt, ratio_dt, irough, sources, inside, f1, f2))
+    {
+        CA::executeRowSteps(bl, f1, f2, GRID);
+        return;
+    }
+#endif
+
+    for (size_t s = 0; s < k; ++s)
+    {
+        CA::EdgeBuffReal& O1 = (s % 2 == 0) ? OUTF1 : OUTF2;
+        CA::EdgeBuffReal& O2 = (s % 2 == 0) ? OUTF2 : OUTF1;
+
+        outflowWaterdepthSIMD(simd, bl, GRID, O1, O2, ELV, WD, MASK, ALARMS,
+            ignore_wd, tol_delwl, dt, (s == 0) ? ratio_dt : 1.0, irough, sources[s]);
+    }
+}
+
+
+// Execute the outflowWCA2Dv2 and waterdepth CA functions for a number
+// of steps and then the velocityDiffusive CA function in a single
+// sweep using the given SIMD kernels.
+void outflowWaterdepthVelocitySIMD(SIMD::Type simd, const CA::BoxList& bl, CA::Grid& GRID,
+    CA::EdgeBuffReal& OUTF1, CA::EdgeBuffReal& OUTF2,
+    CA::CellBuffReal& ELV, CA::CellBuffReal& WD,
+    CA::CellBuffMask& MASK, CA::Alarms& OUTFALARMS,
+    CA::Real ignore_wd, CA::Real tol_delwl,
+    CA::Real dt, CA::Real ratio_dt, CA::Real irough,
+    const std::vector<WDSources>& sources,
+    CA::CellBuffReal& V, CA::CellBuffReal& A,
+    CA::Alarms& VELALARMS,
+    CA::ReductionReal& VAMAX, CA::ReductionReal& DTMIN,
+    CA::Real tol_va, CA::Real tol_slope,
+    CA::Real upstr_elv)
+{
+    // The last step writes the outflux in OUTF1 if it is even.
+    CA::EdgeBuffReal& OUTF = (sources.size() % 2 == 1) ? OUTF1 : OUTF2;
+
+#ifdef WCA2D_SIMD
+    std::vector<WDSources> inside;
+    std::vector<OutflowWCA2Dv2Rows> f1;
+    std::vector<WaterDepthRows> f2;
+
+    if (stepsRows(simd, bl, GRID, OUTF1, OUTF2, ELV, WD, MASK, OUTFALARMS,
+            ignore_wd, tol_delwl, dt, ratio_dt, irough, sources, inside, f1, f2))
+    {
+        const WCA2DRowKernels* kernels = rowKernels(simd);
+
+        CA::executeRowSteps(bl, f1, f2,
+            velocityDiffusiveRows(kernels ? kernels->velocityDiffusive : &scalarRow<VelocityDiffusiveRow>, GRID,
+                V, A, WD, ELV, OUTF, MASK, VELALARMS, VAMAX, DTMIN, tol_va, tol_slope, dt, irough, upstr_elv),
+            GRID);
+        return;
+    }
+#endif
+
+    outflowWaterdepthStepsSIMD(simd, bl, GRID, OUTF1, OUTF2, ELV, WD, MASK, OUTFALARMS,
+        ignore_wd, tol_delwl, dt, ratio_dt, irough, sources);
+    velocityDiffusiveSIMD(simd, bl, GRID, V, A, WD, ELV, OUTF, MASK, VELALARMS,
+        VAMAX, DTMIN, tol_va, tol_slope, dt, irough, upstr_elv);
+}
+
+
+// Execute the velocityDiffusive CA function using the given SIMD kernels. 
+void velocityDiffusiveSIMD(SIMD::Type simd, const CA::BoxList& bl, CA::Grid& GRID,
+    CA::CellBuffReal& V, CA::CellBuffReal& A,
+    CA::CellBuffReal& WD, CA::CellBuffReal& ELV,
+    CA::EdgeBuffReal& OUTF,
+    CA::CellBuffMask& MASK, CA::Alarms& ALARMS,
+    CA::ReductionReal& VAMAX, CA::ReductionReal& DTMIN,
+    CA::Real tol_wd, CA::Real tol_slope,
+    CA::Real prev_dt, CA::Real irough,
+    CA::Real upstr_elv)
+{
+#ifdef WCA2D_SIMD
+    const WCA2DRowKernels* kernels = rowKernels(simd);
+    if (kernels)
+    {
+        CA::executeRowFunction(bl, velocityDiffusiveRows(kernels->velocityDiffusive, GRID, V, A,
+            WD, ELV, OUTF, MASK, ALARMS, VAMAX, DTMIN, tol_wd, tol_slope, prev_dt, irough, upstr_elv), GRID);
+        return;
+    }
+#endif
+
+    CA::Execute::function(bl, velocityDiffusive, GRID, V, A,
+        WD, ELV, OUTF, MASK, ALARMS, VAMAX, DTMIN, tol_wd, tol_slope, prev_dt, irough, upstr_elv);
+}
+
+
+// Execute the outflowWCA2Dv2 CA function on a list of rows using the
+// given SIMD kernels.
+void outflowWCA2Dv2SIMD(SIMD::Type simd, const CA::RowList& rl, CA::Grid& GRID,
+    CA::EdgeBuffReal& OUTF1, CA::EdgeBuffReal& OUTF2,
+    CA::CellBuffReal& ELV, CA::CellBuffReal& WD,
+    CA::CellBuffMask& MASK, CA::Alarms& ALARMS,
+    CA::Real ignore_wd, CA::Real tol_delwl,
+    CA::Real dt, CA::Real ratio_dt, CA::Real irough)
+{
+#ifdef WCA2D_SIMD
+    const WCA2DRowKernels* kernels = rowKernels(simd);
+
+    CA::executeRowList(rl,
+        outflowWCA2Dv2Rows(kernels ? kernels->outflowWCA2Dv2 : &scalarRow<OutflowWCA2Dv2Row>, GRID,
+            OUTF1, OUTF2, ELV, WD, MASK, ALARMS, ignore_wd, tol_delwl, dt, ratio_dt, irough),
+        GRID);
+#else
+    for (CA::RowList::ConstIter ir = rl.begin(); ir != rl.end(); ++ir)
+        CA::Execute::function(CA::BoxList(CA::Box(ir->x, ir->y, ir->w, 1)), outflowWCA2Dv2, GRID, OUTF1, OUTF2,
+            ELV, WD, MASK, ALARMS, ignore_wd, tol_delwl, dt, ratio_dt, irough);
+#endif
+}
+
+
+// Execute the waterdepth CA function on a list of rows using the
+// given SIMD kernels and apply the sources in the same sweep.
+void waterdepthSIMD(SIMD::Type simd, const CA::RowList& rl, CA::Grid& GRID,
+    CA::CellBuffReal& WD, CA::EdgeBuffReal& OUTF1, CA::EdgeBuffReal& OUTF2,
+    CA::CellBuffReal& ELV, CA::CellBuffMask& MASK, CA::Real dt,
+    const WDSources& sources)
+{
+#ifdef WCA2D_SIMD
+    const WCA2DRowKernels* kernels = rowKernels(simd);
+    const WDSources inside(gridSources(GRID, sources));
+
+    CA::executeRowList(rl,
+        waterdepthRows(kernels ? kernels->waterdepth : &scalarRow<WaterDepthRow>, GRID,
+            WD, OUTF1, OUTF2, ELV, MASK, dt, inside),
+        GRID);
+#else
+    for (CA::RowList::ConstIter ir = rl.begin(); ir != rl.end(); ++ir)
+        CA::Execute::function(CA::BoxList(CA::Box(ir->x, ir->y, ir->w, 1)), waterdepth, GRID,
+            WD, OUTF1, OUTF2, MASK, dt);
+    applySources(GRID, WD, ELV, MASK, sources);
+#endif
+}
+
+
+// Set the flag of the wet cells of a list of rows.
+void findWetCells(const CA::RowList& rl, CA::Grid& GRID,
+    CA::CellBuffReal& WD, CA::CellBuffMask& MASK, CA::Real ignore_wd,
+    std::vector<char>& wet)
+{
+    const CA::Unsigned width = GRID.box().w();
+
+#ifdef WCA2D_SIMD
+    WetCellsRows f;
+    f.WD = WD;
+    f.MASK = MASK;
+    f.ignore_wd = ignore_wd;
+    f.wet = &wet[0];
+    f.width = width;
+
+    CA::executeRowList(rl, f, GRID);
+#else
+    std::vector<CA::Real> wd;
+    std::vector<CA::Mask> mask;
+    for (CA::RowList::ConstIter ir = rl.begin(); ir != rl.end(); ++ir)
+    {
+        const CA::Box box(ir->x, ir->y, ir->w, 1);
+        wd.resize(ir->w);
+        mask.resize(ir->w);
+        WD.retrieveData(box, &wd[0], ir->w, 1);
+        MASK.retrieveData(box, &mask[0], ir->w, 1);
+
+        for (CA::Unsigned i = 0; i < ir->w; ++i)
+            wet[ir->y * width + ir->x + i] = caMaskData(mask[i], 0) && !(wd[i] < ignore_wd);
+    }
+#endif
+}
+
+
+// Clear the edges of the cells of a list of rows.
+void clearEdges(const CA::RowList& rl, CA::Grid& GRID, CA::EdgeBuffReal& E)
+{
+#ifdef WCA2D_SIMD
+    ClearEdgesRows f;
+    f.E = E;
+
+    CA::executeRowList(rl, f, GRID);
+#else
+    for (CA::RowList::ConstIter ir = rl.begin(); ir != rl.end(); ++ir)
+        E.fill(CA::BoxList(CA::Box(ir->x, ir->y, ir->w, 1)), 0.0);
+#endif
+}
+
+
+// Record the outflux of the cells of the boxes.
+void recordOutflow(const CA::BoxList& bl, CA::Grid& GRID, CA::EdgeBuffReal& LAST, CA::EdgeBuffReal& OUTF)
+{
+#ifdef WCA2D_SIMD
+    RecordOutflowRows f;
+    f.LAST = LAST;
+    f.OUTF = OUTF;
+
+    CA::executeRowFunction(bl, f, GRID);
+#else
+    CA::Execute::function(bl, lastOutflow, GRID, LAST, OUTF);
+#endif
+}
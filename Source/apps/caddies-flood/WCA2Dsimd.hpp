@@ -0,0 +1,189 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef _WCA2DSIMD_HPP_
+#define _WCA2DSIMD_HPP_
+
+
+//! \file WCA2Dsimd.hpp
+//! Contains the explicitly vectorised (SIMD) execution of the
+//! outflowWCA2Dv2, waterdepth and velocityDiffusive CA functions. The
+//! instruction set (SSE4.2, AVX2, AVX-512) is selected at run time
+//! and the results are the same of the scalar CA functions. The
+//! outflowWCA2Dv2 and waterdepth CA functions can be executed on a
+//! list of rows (RowList) instead than on the boxes.
+//! \attention The SIMD kernels are available only with single
+//! precision real, with the row-major cell buffers and with an
+//! implementation that can execute a row function (CA2D_ROWS),
+//! otherwise the scalar CA functions are used (a box for each row of
+//! a list).
+//! \date 2026-10
+
+
+#include"ca2D.hpp"
+#include"BaseTypes.hpp"
+#include"ArgsData.hpp"
+#include"Sources.hpp"
+#include"RowList.hpp"
+#include<vector>
+
+
+//! Return the SIMD kernels to use given the requested one. The
+//! widest instruction set that is not wider than the requested one
+//! and that is supported by both the processor and the build is
+//! returned (AUTO requests the widest one). NONE is returned if the SIMD
+//! kernels cannot be used.
+SIMD::Type selectSIMD(SIMD::Type request);
+
+
+//! Execute the outflowWCA2Dv2 CA function using the given SIMD kernels. 
+void outflowWCA2Dv2SIMD(SIMD::Type simd, const CA::BoxList& bl, CA::Grid& GRID,
+    CA::EdgeBuffReal& OUTF1, CA::EdgeBuffReal& OUTF2,
+    CA::CellBuffReal& ELV, CA::CellBuffReal& WD,
+    CA::CellBuffMask& MASK, CA::Alarms& ALARMS,
+    CA::Real ignore_wd, CA::Real tol_delwl,
+    CA::Real dt, CA::Real ratio_dt, CA::Real irough);
+
+
+//! Execute the waterdepth CA function using the given SIMD kernels
+//! and apply the sources. When the box list covers the sources (see
+//! coversSources) they are applied in the same sweep, otherwise they
+//! are applied on their boxes after it (see applySources).
+void waterdepthSIMD(SIMD::Type simd, const CA::BoxList& bl, CA::Grid& GRID,
+    CA::CellBuffReal& WD, CA::EdgeBuffReal& OUTF1, CA::EdgeBuffReal& OUTF2,
+    CA::CellBuffReal& ELV, CA::CellBuffMask& MASK, CA::Real dt,
+    const WDSources& sources);
+
+
+//! Execute the outflowWCA2Dv2 and waterdepth CA functions in a single
+//! sweep of each box using the given SIMD kernels (NONE uses the
+//! scalar CA functions). The waterdepth of a row is computed as soon as
+//! the outflow of the rows around it is computed. The result is the
+//! same of outflowWCA2Dv2SIMD followed by waterdepthSIMD.
+//! \attention The boxes must not be adjacent or overlapping.
+void outflowWaterdepthSIMD(SIMD::Type simd, const CA::BoxList& bl, CA::Grid& GRID,
+    CA::EdgeBuffReal& OUTF1, CA::EdgeBuffReal& OUTF2,
+    CA::CellBuffReal& ELV, CA::CellBuffReal& WD,
+    CA::CellBuffMask& MASK, CA::Alarms& ALARMS,
+    CA::Real ignore_wd, CA::Real tol_delwl,
+    CA::Real dt, CA::Real ratio_dt, CA::Real irough,
+    const WDSources& sources);
+
+
+//! Execute the outflowWCA2Dv2 and waterdepth CA functions for a number
+//! of steps with the same dt in a single sweep of each box (see
+//! outflowWaterdepthSIMD), the number of steps is the size of the
+//! list of the sources of each step. The step s is computed on a row
+//! as soon as the step s-1 was computed on the rows around it. The
+//! buffers of the double buffer are swapped after each step, thus
+//! OUTF1 has the outflux of the last step if the number of steps is
+//! odd, OUTF2 otherwise. The ratio_dt is used by the first step. The
+//! result is the same of outflowWaterdepthSIMD executed for each step.
+//! \attention The boxes must not be adjacent or overlapping.
+void outflowWaterdepthStepsSIMD(SIMD::Type simd, const CA::BoxList& bl, CA::Grid& GRID,
+    CA::EdgeBuffReal& OUTF1, CA::EdgeBuffReal& OUTF2,
+    CA::CellBuffReal& ELV, CA::CellBuffReal& WD,
+    CA::CellBuffMask& MASK, CA::Alarms& ALARMS,
+    CA::Real ignore_wd, CA::Real tol_delwl,
+    CA::Real dt, CA::Real ratio_dt, CA::Real irough,
+    const std::vector<WDSources>& sources);
+
+
+//! Execute the velocityDiffusive CA function using the given SIMD
+//! kernels. The maximum velocity and the minimum possible dt are
+//! reduced into VAMAX and DTMIN.
+void velocityDiffusiveSIMD(SIMD::Type simd, const CA::BoxList& bl, CA::Grid& GRID,
+    CA::CellBuffReal& V, CA::CellBuffReal& A,
+    CA::CellBuffReal& WD, CA::CellBuffReal& ELV,
+    CA::EdgeBuffReal& OUTF,
+    CA::CellBuffMask& MASK, CA::Alarms& ALARMS,
+    CA::ReductionReal& VAMAX, CA::ReductionReal& DTMIN,
+    CA::Real tol_wd, CA::Real tol_slope,
+    CA::Real prev_dt, CA::Real irough,
+    CA::Real upstr_elv);
+
+
+//! Execute the steps of outflowWaterdepthStepsSIMD and then the
+//! velocityDiffusive CA function in a single sweep of each box, the
+//! velocity of a row is computed as soon as the last step was computed
+//! on the rows around it. The velocity uses the outflux of the last
+//! step and dt as the previous dt. The result is the same of
+//! outflowWaterdepthStepsSIMD followed by velocityDiffusiveSIMD.
+//! \attention The boxes must not be adjacent or overlapping.
+void outflowWaterdepthVelocitySIMD(SIMD::Type simd, const CA::BoxList& bl, CA::Grid& GRID,
+    CA::EdgeBuffReal& OUTF1, CA::EdgeBuffReal& OUTF2,
+    CA::CellBuffReal& ELV, CA::CellBuffReal& WD,
+    CA::CellBuffMask& MASK, CA::Alarms& OUTFALARMS,
+    CA::Real ignore_wd, CA::Real tol_delwl,
+    CA::Real dt, CA::Real ratio_dt, CA::Real irough,
+    const std::vector<WDSources>& sources,
+    CA::CellBuffReal& V, CA::CellBuffReal& A,
+    CA::Alarms& VELALARMS,
+    CA::ReductionReal& VAMAX, CA::ReductionReal& DTMIN,
+    CA::Real tol_va, CA::Real tol_slope,
+    CA::Real upstr_elv);
+
+
+//! Execute the outflowWCA2Dv2 CA function on the cells of a list of
+//! rows using the given SIMD kernels. The box of the CA function is
+//! the full grid.
+void outflowWCA2Dv2SIMD(SIMD::Type simd, const CA::RowList& rl, CA::Grid& GRID,
+    CA::EdgeBuffReal& OUTF1, CA::EdgeBuffReal& OUTF2,
+    CA::CellBuffReal& ELV, CA::CellBuffReal& WD,
+    CA::CellBuffMask& MASK, CA::Alarms& ALARMS,
+    CA::Real ignore_wd, CA::Real tol_delwl,
+    CA::Real dt, CA::Real ratio_dt, CA::Real irough);
+
+
+//! Execute the waterdepth CA function on the cells of a list of rows
+//! using the given SIMD kernels and apply the sources in the same
+//! sweep.
+//! \attention The list must contain the data cells of the boxes of
+//! the sources.
+void waterdepthSIMD(SIMD::Type simd, const CA::RowList& rl, CA::Grid& GRID,
+    CA::CellBuffReal& WD, CA::EdgeBuffReal& OUTF1, CA::EdgeBuffReal& OUTF2,
+    CA::CellBuffReal& ELV, CA::CellBuffMask& MASK, CA::Real dt,
+    const WDSources& sources);
+
+
+//! Set the flag of each cell of a list of rows to true if the cell is
+//! wet, i.e. it has data and at least the water depth that can be
+//! ignored, otherwise to false. The flags are indexed by the position
+//! of the cell in the grid (y * width + x).
+void findWetCells(const CA::RowList& rl, CA::Grid& GRID,
+    CA::CellBuffReal& WD, CA::CellBuffMask& MASK, CA::Real ignore_wd,
+    std::vector<char>& wet);
+
+
+//! Clear the four edges of each cell of a list of rows.
+void clearEdges(const CA::RowList& rl, CA::Grid& GRID, CA::EdgeBuffReal& E);
+
+
+//! Record the outflux of the cells of the boxes into LAST as the
+//! lastOutflow CA function, i.e. an edge keeps the last outflux
+//! through it, in either direction.
+void recordOutflow(const CA::BoxList& bl, CA::Grid& GRID, CA::EdgeBuffReal& LAST, CA::EdgeBuffReal& OUTF);
+
+#endif
@@ -0,0 +1,485 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef _WCA2DSIMDKERNELS_HPP_
+#define _WCA2DSIMDKERNELS_HPP_
+
+
+//! \file WCA2DsimdKernels.hpp
+//! Contains the row kernels of the explicitly vectorised (SIMD)
+//! version of the outflowWCA2Dv2, waterdepth and velocityDiffusive CA
+//! functions. The kernels are written once as templates over a vector
+//! type and they are instantiated by the specific instruction set files
+//! (WCA2Dsimd_sse42.cpp, WCA2Dsimd_avx2.cpp, WCA2Dsimd_avx512.cpp).
+//! \attention This file is included by files compiled with specific
+//! instruction set flags, thus it must not use (or include) any inline
+//! function which is shared with the rest of the code. The transcendental
+//! functions are called from the C math library for each cell.
+//! \date 2026-10
+
+
+#include<math.h>
+#include<stddef.h>
+
+
+//! The arguments of a row of the outflowWCA2Dv2 function.  All the
+//! pointers identify the value of the first cell of the row.
+struct OutflowWCA2Dv2Row
+{
+    float*       outf1_we;      //!< OUTF1 west/east sub-buffer (edge 3).
+    float*       outf1_ns;      //!< OUTF1 north/south sub-buffer (edge 2).
+    const float* outf2_we;      //!< OUTF2 west/east sub-buffer (edge 3).
+    const float* outf2_ns;      //!< OUTF2 north/south sub-buffer (edge 2).
+    const float* elv;           //!< The elevation.
+    const float* wd;            //!< The water depth.
+    const unsigned char* mask;  //!< The mask (8 bits per cell).
+    char*        alarm;         //!< The box alarms, one for each side (1-4).
+    ptrdiff_t    cb_x_pitch;    //!< The row pitch of the cell buffer.
+    ptrdiff_t    eb_ns_x_pitch; //!< The row pitch of the north/south sub-buffer.
+    bool         box_top;       //!< True if the row is the top one of the box.
+    bool         box_bottom;    //!< True if the row is the bottom one of the box.
+    bool         box_left;      //!< True if the first cell is in the left border of the box.
+    bool         box_right;     //!< True if the last cell is in the right border of the box.
+    float        ignore_wd;
+    float        tol_delwl;
+    float        dt;
+    float        ratio_dt;
+    float        irough;
+    float        area;
+    float        length;
+    float        distance;
+};
+
+
+//! The arguments of a row of the waterdepth function. All the
+//! pointers identify the value of the first cell of the row.
+struct WaterDepthRow
+{
+    float*       wd;            //!< The water depth.
+    const float* outf1_we;      //!< OUTF1 west/east sub-buffer (edge 3).
+    const float* outf1_ns;      //!< OUTF1 north/south sub-buffer (edge 2).
+    float*       outf2_we;      //!< OUTF2 west/east sub-buffer (edge 3).
+    float*       outf2_ns;      //!< OUTF2 north/south sub-buffer (edge 2).
+    const unsigned char* mask;  //!< The mask (8 bits per cell).
+    ptrdiff_t    eb_ns_x_pitch; //!< The row pitch of the north/south sub-buffer.
+    float        area;
+};
+
+
+//! The arguments of a row of the velocityDiffusive function. All the
+//! pointers identify the value of the first cell of the row.
+struct VelocityDiffusiveRow
+{
+    float*       v;             //!< The velocity.
+    float*       a;             //!< The angle.
+    float*       vamax;         //!< The maximum velocity of the row (reduced).
+    float*       dtmin;         //!< The minimum possible time step of the row (reduced).
+    const float* wd;            //!< The water depth.
+    const float* elv;           //!< The elevation.
+    const float* outf_we;       //!< OUTF west/east sub-buffer (edge 3).
+    const float* outf_ns;       //!< OUTF north/south sub-buffer (edge 2).
+    const unsigned char* mask;  //!< The mask (8 bits per cell).
+    char*        alarm;         //!< The upstream alarm.
+    ptrdiff_t    cb_x_pitch;    //!< The row pitch of the cell buffer.
+    ptrdiff_t    eb_ns_x_pitch; //!< The row pitch of the north/south sub-buffer.
+    float        tol_wd;
+    float        tol_slope;
+    float        prev_dt;
+    float        irough;
+    float        upstr_elv;
+    float        area;
+    float        length;
+    float        distance;
+    float        tol_vel;       //!< The largest float not over the velocity tolerance.
+    float        cos[5];        //!< The cosine of the angle of each neighbour.
+    float        sin[5];        //!< The sine of the angle of each neighbour.
+};
+
+
+//! The row kernels of a specific instruction set. Each kernel
+//! computes the first cells of the row which are a multiple of the
+//! vector width and it returns their number. The remaining cells have
+//! to be computed by the scalar CA function. The number of cells that
+//! were computed, i.e. not skipped (e.g. the wet cells of the
+//! outflow), is added to work.
+struct WCA2DRowKernels
+{
+    const char* name;
+    size_t (*outflowWCA2Dv2)(const OutflowWCA2Dv2Row& r, size_t n, size_t& work);
+    size_t (*waterdepth)(const WaterDepthRow& r, size_t n, size_t& work);
+    size_t (*velocityDiffusive)(const VelocityDiffusiveRow& r, size_t n, size_t& work);
+};
+
+
+//! Return the row kernels compiled with the specific instruction
+//! set or a null pointer if the instruction set was not available
+//! at compile time.
+const WCA2DRowKernels* rowKernelsSSE42();
+const WCA2DRowKernels* rowKernelsAVX2();
+const WCA2DRowKernels* rowKernelsAVX512();
+
+
+// ---- KERNELS ----
+//
+// The vector type V must define:
+// R, M        the vector of reals and the mask types.
+// W           the number of lanes.
+// load, store, set1, zero, add, sub, mul, div, sqrt, abs, neg.
+// min(a,b)    with the semantic of std::min, i.e. (b<a)?b:a.
+// max(a,b)    with the semantic of std::max, i.e. (a<b)?b:a.
+// cmpgt, cmpge, cmplt, cmple  ordered comparisons.
+// mand, mor, mandnot(a,b)     mask operations (a and not b).
+// blend(m,a,b)                b where m is set, otherwise a.
+// bits(m)                     the mask as integer bits.
+// maskstore(p,m,v)            store only the lanes where m is set.
+// data(p), boundary(p)        test the data bit (bit 0) and the boundary
+//                             bit (bit 7) of the 8-bit masks.
+
+
+//! Return the number of bits set.
+inline static unsigned wca2dCount(unsigned bits)
+{
+    bits = bits - ((bits >> 1) & 0x55555555u);
+    bits = (bits & 0x33333333u) + ((bits >> 2) & 0x33333333u);
+    return (((bits + (bits >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24;
+}
+
+
+//! The maximum velocity of the outflowWCA2Dv2 function, i.e. the
+//! Manning and critical velocity limited to 20 m/s (see caFlowVelocity).
+inline static float wca2dMaxVelocity(float irough, float S, float wd)
+{
+    float vc = sqrtf(static_cast<float>(9.81*wd));
+    float vm = irough*powf(wd, static_cast<float>(2.0 / 3.0))*sqrtf(S);
+    float fv = (vm < vc) ? vm : vc;
+    return (fv < 20.0f) ? fv : 20.0f;
+}
+
+
+//! Compute a row of the outflowWCA2Dv2 function.
+template<typename V>
+size_t outflowWCA2Dv2Row(const OutflowWCA2Dv2Row& r, size_t n, size_t& work)
+{
+    typedef typename V::R R;
+    typedef typename V::M M;
+
+    const ptrdiff_t cbx = r.cb_x_pitch;
+    const ptrdiff_t ebx = r.eb_ns_x_pitch;
+
+    const R zero = V::zero();
+    const R ignore_wd = V::set1(r.ignore_wd);
+    const R tol_delwl = V::set1(r.tol_delwl);
+    const R ratio_dt = V::set1(r.ratio_dt);
+    const R dt = V::set1(r.dt);
+    const R area = V::set1(r.area);
+    const R length = V::set1(r.length);
+    const R distance = V::set1(r.distance);
+
+    size_t i = 0;
+    for (; i + V::W <= n; i += V::W)
+    {
+        const float* WD = r.wd + i;
+        const float* ELV = r.elv + i;
+
+        // The cell is computed if it has data and enough water.
+        R wdmain = V::load(WD);
+        M active = V::mandnot(V::data(r.mask + i), V::cmplt(wdmain, ignore_wd));
+        unsigned wet = V::bits(active);
+        if (!wet)
+            continue;
+
+        work += wca2dCount(wet);
+
+        // The water level of the main cell and the difference in water
+        // level with each neighbour (not more than the water available).
+        R wl0 = V::add(wdmain, V::load(ELV));
+        R WATER[4];
+        WATER[0] = V::min(V::sub(wl0, V::add(V::load(WD + 1), V::load(ELV + 1))), wdmain);
+        WATER[1] = V::min(V::sub(wl0, V::add(V::load(WD - cbx), V::load(ELV - cbx))), wdmain);
+        WATER[2] = V::min(V::sub(wl0, V::add(V::load(WD - 1), V::load(ELV - 1))), wdmain);
+        WATER[3] = V::min(V::sub(wl0, V::add(V::load(WD + cbx), V::load(ELV + cbx))), wdmain);
+
+        // The previous fluxes, each outflux is positive.
+        R PFLUXES[4];
+        PFLUXES[0] = V::load(r.outf2_we + i + 1);
+        PFLUXES[1] = V::load(r.outf2_ns + i);
+        PFLUXES[2] = V::neg(V::load(r.outf2_we + i));
+        PFLUXES[3] = V::neg(V::load(r.outf2_ns + i + ebx));
+
+        R WEIGHT[4];
+        R mindelwv = V::set1(10000.0f);
+        R totalw = zero;
+        R totalinw = zero;
+        R weight_max = zero;
+        R delwl_max = zero;
+
+        for (int k = 0; k < 4; ++k)
+        {
+            M down = V::cmpgt(WATER[k], tol_delwl);
+            WEIGHT[k] = V::blend(down, zero, V::mul(WATER[k], area));
+            mindelwv = V::blend(down, mindelwv, V::min(mindelwv, WEIGHT[k]));
+
+            M inw = V::mand(V::cmpgt(PFLUXES[k], zero), V::cmpgt(WEIGHT[k], zero));
+            totalinw = V::add(totalinw, V::blend(inw, zero, V::mul(PFLUXES[k], ratio_dt)));
+
+            totalw = V::add(totalw, WEIGHT[k]);
+
+            M wmax = V::cmpgt(WEIGHT[k], weight_max);
+            weight_max = V::blend(wmax, weight_max, WEIGHT[k]);
+            delwl_max = V::blend(wmax, delwl_max, WATER[k]);
+        }
+
+        // Skip the cells without any downstream neighbour.
+        M flow = V::mandnot(active, V::cmple(totalw, zero));
+        unsigned bits = V::bits(flow);
+        if (!bits)
+            continue;
+
+        totalw = V::add(totalw, mindelwv);
+
+        // The maximum velocity is computed cell by cell.
+        float S[V::W], H[V::W], VH[V::W];
+        V::store(S, V::div(delwl_max, distance));
+        V::store(H, wdmain);
+        for (unsigned l = 0; l < V::W; ++l)
+            VH[l] = ((bits >> l) & 1) ? wca2dMaxVelocity(r.irough, S[l], H[l]) : 0.0f;
+
+        R max_flux = V::mul(V::mul(V::mul(V::load(VH), wdmain), dt), length);
+        R outwv = V::min(V::min(V::add(mindelwv, totalinw), V::mul(max_flux, V::div(totalw, weight_max))),
+            V::mul(wdmain, area));
+
+        // Write the fluxes of the downstream cells. The east edge is
+        // written before the west one since the same edge is shared by
+        // two consecutive cells.
+        V::maskstore(r.outf1_we + i + 1, V::mand(flow, V::cmpgt(WEIGHT[0], zero)),
+            V::mul(outwv, V::div(WEIGHT[0], totalw)));
+        V::maskstore(r.outf1_ns + i, V::mand(flow, V::cmpgt(WEIGHT[1], zero)),
+            V::mul(outwv, V::div(WEIGHT[1], totalw)));
+        V::maskstore(r.outf1_we + i, V::mand(flow, V::cmpgt(WEIGHT[2], zero)),
+            V::neg(V::mul(outwv, V::div(WEIGHT[2], totalw))));
+        V::maskstore(r.outf1_ns + i + ebx, V::mand(flow, V::cmpgt(WEIGHT[3], zero)),
+            V::neg(V::mul(outwv, V::div(WEIGHT[3], totalw))));
+
+        // Set the alarm of a side of the box if there is an outflux
+        // through it.
+        if (r.box_top && V::bits(V::mand(flow, V::cmpgt(WEIGHT[1], zero))))
+            r.alarm[2] = 1;
+        if (r.box_bottom && V::bits(V::mand(flow, V::cmpgt(WEIGHT[3], zero))))
+            r.alarm[4] = 1;
+        if (r.box_left && i == 0 && (V::bits(V::mand(flow, V::cmpgt(WEIGHT[2], zero))) & 1))
+            r.alarm[3] = 1;
+        if (r.box_right && n - i == V::W &&
+            ((V::bits(V::mand(flow, V::cmpgt(WEIGHT[0], zero))) >> (V::W - 1)) & 1))
+            r.alarm[1] = 1;
+    }
+
+    return i;
+}
+
+
+//! Compute a row of the waterdepth function.
+template<typename V>
+size_t waterdepthRow(const WaterDepthRow& r, size_t n, size_t& work)
+{
+    typedef typename V::R R;
+    typedef typename V::M M;
+
+    const ptrdiff_t ebx = r.eb_ns_x_pitch;
+
+    const R zero = V::zero();
+    const R area = V::set1(r.area);
+
+    size_t i = 0;
+    for (; i + V::W <= n; i += V::W)
+    {
+        // Erase the outflow buffer 2.
+        V::store(r.outf2_we + i + 1, zero);
+        V::store(r.outf2_ns + i, zero);
+
+        // Skip the cells with no data and without a neighbour with data.
+        M data = V::mor(V::data(r.mask + i), V::boundary(r.mask + i));
+        unsigned cells = V::bits(data);
+        if (!cells)
+            continue;
+
+        work += wca2dCount(cells);
+
+        R outflux = V::add(zero, V::load(r.outf1_we + i + 1));
+        outflux = V::add(outflux, V::load(r.outf1_ns + i));
+        outflux = V::sub(outflux, V::load(r.outf1_we + i));
+        outflux = V::sub(outflux, V::load(r.outf1_ns + i + ebx));
+
+        R wd = V::load(r.wd + i);
+        V::store(r.wd + i, V::blend(data, wd, V::sub(wd, V::div(outflux, area))));
+    }
+
+    return i;
+}
+
+
+//! Compute a row of the velocityDiffusive function.
+template<typename V>
+size_t velocityDiffusiveRow(const VelocityDiffusiveRow& r, size_t n, size_t& work)
+{
+    typedef typename V::R R;
+    typedef typename V::M M;
+
+    const ptrdiff_t cbx = r.cb_x_pitch;
+    const ptrdiff_t ebx = r.eb_ns_x_pitch;
+    const ptrdiff_t offset[4] = { 1, -cbx, -1, cbx };
+
+    const R zero = V::zero();
+    const R tol_wd = V::set1(r.tol_wd);
+    const R tol_slope = V::set1(r.tol_slope);
+    const R tol_vel = V::set1(r.tol_vel);
+    const R upstr_elv = V::set1(r.upstr_elv);
+    const R distance = V::set1(r.distance);
+    const R length = V::set1(r.length);
+    const R prev_dt = V::set1(r.prev_dt);
+    const R quarter_area = V::set1(r.area / 4);
+    const float ir2 = 2 * 1 / r.irough;
+
+    // The maximum velocity and minimum possible time step of each lane.
+    const R vamax0 = V::set1(*r.vamax);
+    const R dtmin0 = V::set1(*r.dtmin);
+    R vamax = vamax0;
+    R dtmin = dtmin0;
+
+    size_t i = 0;
+    for (; i + V::W <= n; i += V::W)
+    {
+        const float* WD = r.wd + i;
+        const float* ELV = r.elv + i;
+
+        // Skip the cells with no data.
+        M data = V::data(r.mask + i);
+        unsigned cells = V::bits(data);
+        if (!cells)
+            continue;
+
+        work += wca2dCount(cells);
+
+        R wdmain = V::load(WD);
+        R elv0 = V::load(ELV);
+        R wl0 = V::add(wdmain, elv0);
+
+        // The fluxes, each outflux is positive.
+        R FLUXES[4];
+        FLUXES[0] = V::load(r.outf_we + i + 1);
+        FLUXES[1] = V::load(r.outf_ns + i);
+        FLUXES[2] = V::neg(V::load(r.outf_we + i));
+        FLUXES[3] = V::neg(V::load(r.outf_ns + i + ebx));
+
+        R x = zero;
+        R y = zero;
+        R totflux = zero;
+        float alpha[V::W];
+        for (unsigned l = 0; l < V::W; ++l)
+            alpha[l] = 1000;
+
+        for (int e = 0; e < 4; ++e)
+        {
+            R elve = V::load(ELV + offset[e]);
+            R wle = V::add(V::load(WD + offset[e]), elve);
+
+            R Hf = V::sub(V::max(wl0, wle), V::max(elv0, elve));
+            R delwl = V::abs(V::sub(wl0, wle));
+
+            totflux = V::add(totflux, V::abs(FLUXES[e]));
+
+            M vel = V::mand(V::cmpgt(FLUXES[e], zero), V::cmpge(Hf, tol_wd));
+            if (!V::bits(vel))
+                continue;
+
+            R S = V::div(delwl, distance);
+            R vh = V::div(FLUXES[e], V::mul(V::mul(wdmain, length), prev_dt));
+
+            // The alpha of the time step is computed cell by cell.
+            unsigned bits = V::bits(V::mand(vel, V::cmpge(S, tol_slope)));
+            if (bits)
+            {
+                float HS[V::W], SS[V::W];
+                V::store(HS, Hf);
+                V::store(SS, S);
+                for (unsigned l = 0; l < V::W; ++l)
+                {
+                    if (!((bits >> l) & 1))
+                        continue;
+                    float va = (ir2 / powf(HS[l], static_cast<float>(5.0 / 3.0)))*sqrtf(SS[l]);
+                    alpha[l] = (va < alpha[l]) ? va : alpha[l];
+                }
+            }
+
+            x = V::blend(vel, x, V::add(x, V::mul(vh, V::set1(r.cos[e + 1]))));
+            y = V::blend(vel, y, V::add(y, V::mul(vh, V::set1(r.sin[e + 1]))));
+        }
+
+        R dt = V::min(V::set1(60.0f), V::mul(quarter_area, V::load(alpha)));
+
+        // Compute magnitude and direction.
+        M moving = V::mor(V::cmpgt(V::abs(x), tol_vel), V::cmpgt(V::abs(y), tol_vel));
+        R speed = V::blend(moving, zero, V::sqrt(V::add(V::mul(x, x), V::mul(y, y))));
+
+        float angle[V::W];
+        unsigned bits = V::bits(V::mand(data, moving));
+        if (bits)
+        {
+            float xs[V::W], ys[V::W];
+            V::store(xs, x);
+            V::store(ys, y);
+            for (unsigned l = 0; l < V::W; ++l)
+                angle[l] = ((bits >> l) & 1) ? static_cast<float>(atan2(static_cast<double>(ys[l]), static_cast<double>(xs[l]))) : 0.0f;
+        }
+        else
+        {
+            for (unsigned l = 0; l < V::W; ++l)
+                angle[l] = 0.0f;
+        }
+
+        V::store(r.v + i, V::blend(data, V::load(r.v + i), speed));
+        V::store(r.a + i, V::blend(data, V::load(r.a + i), V::load(angle)));
+        vamax = V::max(vamax, V::blend(data, vamax0, speed));
+        dtmin = V::min(dtmin, V::blend(data, dtmin0, dt));
+
+        // Set the alarm if there is some in/out flux and the water
+        // level is over the upstream elevation.
+        if (V::bits(V::mand(data, V::mand(V::cmpgt(totflux, zero), V::cmpgt(wl0, upstr_elv)))))
+            r.alarm[0] = 1;
+    }
+
+    // Reduce the lanes.
+    float vas[V::W], dts[V::W];
+    V::store(vas, vamax);
+    V::store(dts, dtmin);
+    for (unsigned l = 0; l < V::W; ++l)
+    {
+        *r.vamax = (vas[l] > *r.vamax) ? vas[l] : *r.vamax;
+        *r.dtmin = (dts[l] < *r.dtmin) ? dts[l] : *r.dtmin;
+    }
+
+    return i;
+}
+
+#endif
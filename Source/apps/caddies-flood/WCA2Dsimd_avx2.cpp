@@ -0,0 +1,121 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+//! \file WCA2Dsimd_avx2.cpp
+//! Contains the AVX2 (8 lanes) row kernels of the WCA2D model.
+//! \attention This file must be compiled with the AVX2 instruction set.
+//! \date 2026-10
+
+
+#include"WCA2DsimdKernels.hpp"
+
+#if defined __AVX2__
+
+#include<immintrin.h>
+
+namespace {
+
+    //! The AVX2 vector type.
+    struct VAVX2
+    {
+        typedef __m256 R;
+        typedef __m256 M;
+        static const unsigned W = 8;
+
+        static R load(const float* p) { return _mm256_loadu_ps(p); }
+        static void store(float* p, R v) { _mm256_storeu_ps(p, v); }
+        static R set1(float v) { return _mm256_set1_ps(v); }
+        static R zero() { return _mm256_setzero_ps(); }
+        static R add(R a, R b) { return _mm256_add_ps(a, b); }
+        static R sub(R a, R b) { return _mm256_sub_ps(a, b); }
+        static R mul(R a, R b) { return _mm256_mul_ps(a, b); }
+        static R div(R a, R b) { return _mm256_div_ps(a, b); }
+        static R sqrt(R a) { return _mm256_sqrt_ps(a); }
+        static R abs(R a) { return _mm256_and_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF))); }
+        static R neg(R a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+        static R min(R a, R b) { return _mm256_min_ps(b, a); }
+        static R max(R a, R b) { return _mm256_max_ps(b, a); }
+        static M cmpgt(R a, R b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+        static M cmpge(R a, R b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+        static M cmplt(R a, R b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+        static M cmple(R a, R b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+        static M mand(M a, M b) { return _mm256_and_ps(a, b); }
+        static M mor(M a, M b) { return _mm256_or_ps(a, b); }
+        static M mandnot(M a, M b) { return _mm256_andnot_ps(b, a); }
+        static R blend(M m, R a, R b) { return _mm256_blendv_ps(a, b, m); }
+        static unsigned bits(M m) { return static_cast<unsigned>(_mm256_movemask_ps(m)); }
+
+        static void maskstore(float* p, M m, R v)
+        {
+            _mm256_maskstore_ps(p, _mm256_castps_si256(m), v);
+        }
+
+        static M bits8(const unsigned char* p, int bit)
+        {
+            __m256i b = _mm256_set1_epi32(bit);
+            __m256i s = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+            return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(s, b), b));
+        }
+
+        static M data(const unsigned char* p) { return bits8(p, 0x01); }
+        static M boundary(const unsigned char* p) { return bits8(p, 0x80); }
+    };
+
+
+    size_t outflowWCA2Dv2AVX2(const OutflowWCA2Dv2Row& r, size_t n, size_t& work)
+    {
+        return outflowWCA2Dv2Row<VAVX2>(r, n, work);
+    }
+
+    size_t waterdepthAVX2(const WaterDepthRow& r, size_t n, size_t& work)
+    {
+        return waterdepthRow<VAVX2>(r, n, work);
+    }
+
+    size_t velocityDiffusiveAVX2(const VelocityDiffusiveRow& r, size_t n, size_t& work)
+    {
+        return velocityDiffusiveRow<VAVX2>(r, n, work);
+    }
+
+    const WCA2DRowKernels kernelsAVX2 =
+    {
+        "avx2", outflowWCA2Dv2AVX2, waterdepthAVX2, velocityDiffusiveAVX2
+    };
+}
+
+
+const WCA2DRowKernels* rowKernelsAVX2()
+{
+    return &kernelsAVX2;
+}
+
+#else
+
+const WCA2DRowKernels* rowKernelsAVX2()
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,122 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+//! \file WCA2Dsimd_avx512.cpp
+//! Contains the AVX-512 (16 lanes) row kernels of the WCA2D model.
+//! \attention This file must be compiled with the AVX-512F instruction set.
+//! \date 2026-10
+
+
+#include"WCA2DsimdKernels.hpp"
+
+#if defined __AVX512F__
+
+#include<immintrin.h>
+
+namespace {
+
+    //! The AVX-512 vector type, it uses only AVX-512F instructions.
+    struct VAVX512
+    {
+        typedef __m512    R;
+        typedef __mmask16 M;
+        static const unsigned W = 16;
+
+        static R load(const float* p) { return _mm512_loadu_ps(p); }
+        static void store(float* p, R v) { _mm512_storeu_ps(p, v); }
+        static R set1(float v) { return _mm512_set1_ps(v); }
+        static R zero() { return _mm512_setzero_ps(); }
+        static R add(R a, R b) { return _mm512_add_ps(a, b); }
+        static R sub(R a, R b) { return _mm512_sub_ps(a, b); }
+        static R mul(R a, R b) { return _mm512_mul_ps(a, b); }
+        static R div(R a, R b) { return _mm512_div_ps(a, b); }
+        static R sqrt(R a) { return _mm512_sqrt_ps(a); }
+        static R abs(R a) { return _mm512_abs_ps(a); }
+
+        static R neg(R a)
+        {
+            return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a),
+                _mm512_set1_epi32(static_cast<int>(0x80000000))));
+        }
+
+        static R min(R a, R b) { return _mm512_min_ps(b, a); }
+        static R max(R a, R b) { return _mm512_max_ps(b, a); }
+        static M cmpgt(R a, R b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+        static M cmpge(R a, R b) { return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ); }
+        static M cmplt(R a, R b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+        static M cmple(R a, R b) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+        static M mand(M a, M b) { return static_cast<M>(a & b); }
+        static M mor(M a, M b) { return static_cast<M>(a | b); }
+        static M mandnot(M a, M b) { return static_cast<M>(a & ~b); }
+        static R blend(M m, R a, R b) { return _mm512_mask_blend_ps(m, a, b); }
+        static unsigned bits(M m) { return static_cast<unsigned>(m); }
+        static void maskstore(float* p, M m, R v) { _mm512_mask_storeu_ps(p, m, v); }
+
+        static M bits8(const unsigned char* p, int bit)
+        {
+            __m512i s = _mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+            return _mm512_test_epi32_mask(s, _mm512_set1_epi32(bit));
+        }
+
+        static M data(const unsigned char* p) { return bits8(p, 0x01); }
+        static M boundary(const unsigned char* p) { return bits8(p, 0x80); }
+    };
+
+
+    size_t outflowWCA2Dv2AVX512(const OutflowWCA2Dv2Row& r, size_t n, size_t& work)
+    {
+        return outflowWCA2Dv2Row<VAVX512>(r, n, work);
+    }
+
+    size_t waterdepthAVX512(const WaterDepthRow& r, size_t n, size_t& work)
+    {
+        return waterdepthRow<VAVX512>(r, n, work);
+    }
+
+    size_t velocityDiffusiveAVX512(const VelocityDiffusiveRow& r, size_t n, size_t& work)
+    {
+        return velocityDiffusiveRow<VAVX512>(r, n, work);
+    }
+
+    const WCA2DRowKernels kernelsAVX512 =
+    {
+        "avx512", outflowWCA2Dv2AVX512, waterdepthAVX512, velocityDiffusiveAVX512
+    };
+}
+
+
+const WCA2DRowKernels* rowKernelsAVX512()
+{
+    return &kernelsAVX512;
+}
+
+#else
+
+const WCA2DRowKernels* rowKernelsAVX512()
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,131 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+//! \file WCA2Dsimd_sse42.cpp
+//! Contains the SSE4.2 (4 lanes) row kernels of the WCA2D model.
+//! \attention This file must be compiled with the SSE4.2 instruction set.
+//! \date 2026-10
+
+
+#include"WCA2DsimdKernels.hpp"
+
+#if defined __SSE4_2__ || defined _M_X64 || defined _M_AMD64
+
+#include<nmmintrin.h>
+#include<string.h>
+
+namespace {
+
+    //! The SSE4.2 vector type.
+    struct VSSE42
+    {
+        typedef __m128 R;
+        typedef __m128 M;
+        static const unsigned W = 4;
+
+        static R load(const float* p) { return _mm_loadu_ps(p); }
+        static void store(float* p, R v) { _mm_storeu_ps(p, v); }
+        static R set1(float v) { return _mm_set1_ps(v); }
+        static R zero() { return _mm_setzero_ps(); }
+        static R add(R a, R b) { return _mm_add_ps(a, b); }
+        static R sub(R a, R b) { return _mm_sub_ps(a, b); }
+        static R mul(R a, R b) { return _mm_mul_ps(a, b); }
+        static R div(R a, R b) { return _mm_div_ps(a, b); }
+        static R sqrt(R a) { return _mm_sqrt_ps(a); }
+        static R abs(R a) { return _mm_and_ps(a, _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF))); }
+        static R neg(R a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+        static R min(R a, R b) { return _mm_min_ps(b, a); }
+        static R max(R a, R b) { return _mm_max_ps(b, a); }
+        static M cmpgt(R a, R b) { return _mm_cmpgt_ps(a, b); }
+        static M cmpge(R a, R b) { return _mm_cmpge_ps(a, b); }
+        static M cmplt(R a, R b) { return _mm_cmplt_ps(a, b); }
+        static M cmple(R a, R b) { return _mm_cmple_ps(a, b); }
+        static M mand(M a, M b) { return _mm_and_ps(a, b); }
+        static M mor(M a, M b) { return _mm_or_ps(a, b); }
+        static M mandnot(M a, M b) { return _mm_andnot_ps(b, a); }
+        static R blend(M m, R a, R b) { return _mm_blendv_ps(a, b, m); }
+        static unsigned bits(M m) { return static_cast<unsigned>(_mm_movemask_ps(m)); }
+
+        static void maskstore(float* p, M m, R v)
+        {
+            unsigned b = bits(m);
+            if (!b)
+                return;
+            float tmp[W];
+            store(tmp, v);
+            for (unsigned l = 0; l < W; ++l)
+                if ((b >> l) & 1)
+                    p[l] = tmp[l];
+        }
+
+        static M bits8(const unsigned char* p, int bit)
+        {
+            int v;
+            memcpy(&v, p, sizeof(v));
+            __m128i b = _mm_set1_epi32(bit);
+            __m128i s = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(v));
+            return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(s, b), b));
+        }
+
+        static M data(const unsigned char* p) { return bits8(p, 0x01); }
+        static M boundary(const unsigned char* p) { return bits8(p, 0x80); }
+    };
+
+
+    size_t outflowWCA2Dv2SSE42(const OutflowWCA2Dv2Row& r, size_t n, size_t& work)
+    {
+        return outflowWCA2Dv2Row<VSSE42>(r, n, work);
+    }
+
+    size_t waterdepthSSE42(const WaterDepthRow& r, size_t n, size_t& work)
+    {
+        return waterdepthRow<VSSE42>(r, n, work);
+    }
+
+    size_t velocityDiffusiveSSE42(const VelocityDiffusiveRow& r, size_t n, size_t& work)
+    {
+        return velocityDiffusiveRow<VSSE42>(r, n, work);
+    }
+
+    const WCA2DRowKernels kernelsSSE42 =
+    {
+        "sse4.2", outflowWCA2Dv2SSE42, waterdepthSSE42, velocityDiffusiveSSE42
+    };
+}
+
+
+const WCA2DRowKernels* rowKernelsSSE42()
+{
+    return &kernelsSSE42;
+}
+
+#else
+
+const WCA2DRowKernels* rowKernelsSSE42()
+{
+    return 0;
+}
+
+#endif
@@ -38,7 +38,6 @@ THE SOFTWARE.
 // Include the CA 2D functions //
 // -------------------------//
 #include CA_2D_INCLUDE(computeArea)
-#include CA_2D_INCLUDE(addRaise)
 
 
 int initWLEventFromCSV(const std::string& filename, WLEvent& wle)
@@ -175,7 +174,7 @@ void WaterLevelManager::addDomain(CA::BoxList& compdomain)
 }
 
 
-void WaterLevelManager::analyseArea(CA::CellBuffReal& TMP, CA::CellBuffState& MASK, CA::BoxList&  domain)
+void WaterLevelManager::analyseArea(CA::CellBuffReal& TMP, CA::CellBuffMask& MASK, CA::BoxList&  domain)
 {
     for (size_t i = 0; i < _datas.size(); ++i)
     {
@@ -247,8 +246,7 @@ CA::Real WaterLevelManager::volume()
 }
 
 
-void WaterLevelManager::add(CA::CellBuffReal& WD, CA::CellBuffReal& ELV,
-    CA::CellBuffState& MASK, CA::Real t, CA::Real next_dt)
+void WaterLevelManager::add(WDSources& sources, CA::Real t, CA::Real next_dt)
 {
     // Loop through the WaterLevel event(s).
     for (size_t i = 0; i < _wles.size(); ++i)
@@ -264,7 +262,7 @@ void WaterLevelManager::add(CA::CellBuffReal& WD, CA::CellBuffReal& ELV,
             // depth instead of the water level. Thus the water depth value
             // at specific location is the value of the water level event
             // minus the elevation.
-            CA::Execute::function(_datas[i].box_area, addRaise, _grid, WD, ELV, MASK, level);
+            sources.push_back(WDSource(_datas[i].box_area, WDSource::LEVEL, level));
             continue;
         }
 
@@ -296,7 +294,7 @@ void WaterLevelManager::add(CA::CellBuffReal& WD, CA::CellBuffReal& ELV,
         // depth instead of the water level. Thus the water depth value
         // at specific location is the value of the water level event
         // minus the elevation.
-        CA::Execute::function(_datas[i].box_area, addRaise, _grid, WD, ELV, MASK, level);
+        sources.push_back(WDSource(_datas[i].box_area, WDSource::LEVEL, level));
 
         // Check if the simulation time now is equal or higher than the
         // time of the NEXT index.
@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include"ca2D.hpp"
 #include"BaseTypes.hpp"
 #include"Box.hpp"
+#include"Sources.hpp"
 #include<string>
 #include<vector>
 
@@ -106,7 +107,7 @@ public:
     void addDomain(CA::BoxList& compdomain);
 
     //! Analyse the area where the various WaterLevel event will happen.
-    void analyseArea(CA::CellBuffReal& TMP, CA::CellBuffState& MASK, CA::BoxList&  domain);
+    void analyseArea(CA::CellBuffReal& TMP, CA::CellBuffMask& MASK, CA::BoxList&  domain);
 
     //! Retrieve the minimum elevation of the given area.
     void getElevation(CA::CellBuffReal& Ele);
@@ -120,8 +121,8 @@ public:
     //! \attention This is the PERIOD volume.
     CA::Real volume();
 
-    //! Add the amount of WaterLevel 
-    void add(CA::CellBuffReal& WD, CA::CellBuffReal& ELV, CA::CellBuffState& MASK, CA::Real t, CA::Real next_dt);
+    //! Add the WaterLevel of the next time step into the sources.
+    void add(WDSources& sources, CA::Real t, CA::Real next_dt);
 
     //! Compute the potential velocity that could happen in the next
     //! update/period step.
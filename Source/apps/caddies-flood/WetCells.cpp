@@ -0,0 +1,356 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+//! \file WetCells.cpp
+//! Contains the management of the compact list of the wet cells.
+//! \date 2026-10
+
+
+#include"WetCells.hpp"
+#include"WCA2Dsimd.hpp"
+#include<algorithm>
+
+
+namespace {
+
+    //! An interval [a,b) of the cells of a line.
+    struct Interval
+    {
+        CA::Unsigned y;
+        CA::Unsigned a;
+        CA::Unsigned b;
+
+        bool operator<(const Interval& i) const
+        {
+            return (y < i.y) || (y == i.y && a < i.a);
+        }
+    };
+
+}
+
+
+WetCells::WetCells(CA::Grid& GRID, CA::CellBuffMask& MASK, const CA::BoxList& domain, CA::Unsigned halo) :
+    _grid(GRID),
+    _mask(&MASK),
+    _fullbox(GRID.box()),
+    _domain(domain),
+    _halo(std::max(halo, static_cast<CA::Unsigned>(1))),
+    _datacells(0),
+    _data(_fullbox.size(), 0),
+    _used(),
+    _line(),
+    _pinned(),
+    _flags(_fullbox.size(), 0),
+    _wet(),
+    _rows(),
+    _added(),
+    _removed()
+{
+    setMask(MASK);
+}
+
+
+void WetCells::setMask(CA::CellBuffMask& MASK)
+{
+    _mask = &MASK;
+
+    std::vector<CA::Mask> mask(_fullbox.size());
+    MASK.retrieveData(_fullbox, &mask[0], _fullbox.w(), _fullbox.h());
+
+    // The cells of the domain.
+    std::vector<char> inside(_fullbox.size(), 0);
+    for (CA::BoxList::ConstIter ibox = _domain.begin(); ibox != _domain.end(); ++ibox)
+    {
+        CA::Box box(*ibox);
+        box.limit(_fullbox);
+        for (CA::Unsigned j = box.top(); j < box.bottom(); ++j)
+            std::fill(inside.begin() + j * _fullbox.w() + box.left(), inside.begin() + j * _fullbox.w() + box.right(), 1);
+    }
+
+    _used.clear();
+    _line.assign(_fullbox.h() + 1, 0);
+    _datacells = 0;
+    std::fill(_data.begin(), _data.end(), 0);
+
+    for (CA::Unsigned j = 0; j < _fullbox.h(); ++j)
+    {
+        _line[j] = _used.size();
+
+        for (CA::Unsigned i = 0; i < _fullbox.w(); ++i)
+        {
+            const CA::Mask m = mask[j * _fullbox.w() + i];
+
+            // The data bit is true if the cell has data, the boundary
+            // bit if the cell is a boundary cell.
+            const bool bit0 = caMaskData(m, 0) != 0;
+            const bool bit31 = caMaskBoundary(m) != 0;
+
+            if (!inside[j * _fullbox.w() + i] || (!bit0 && !bit31))
+                continue;
+
+            if (bit0)
+            {
+                _data[j * _fullbox.w() + i] = 1;
+                ++_datacells;
+            }
+
+            if (!_used.empty() && _used.back().y == j && _used.back().x + _used.back().w == i)
+            {
+                ++_used.back().w;
+            }
+            else
+            {
+                CA::RowList::Row r = { i, j, 1 };
+                _used.push_back(r);
+            }
+        }
+    }
+    _line[_fullbox.h()] = _used.size();
+}
+
+
+void WetCells::removeCells(const CA::PointList& pl)
+{
+    for (CA::PointList::ConstIter ip = pl.begin(); ip != pl.end(); ++ip)
+    {
+        const CA::Unsigned k = (ip->y() - _fullbox.y()) * _fullbox.w() + ip->x() - _fullbox.x();
+        if (_data[k])
+        {
+            _data[k] = 0;
+            --_datacells;
+        }
+    }
+}
+
+
+void WetCells::pin(const CA::BoxList& bl)
+{
+    for (CA::BoxList::ConstIter ibox = bl.begin(); ibox != bl.end(); ++ibox)
+    {
+        CA::Box box(*ibox);
+        box.limit(_fullbox);
+        if (!box.empty())
+            _pinned.push_back(box);
+    }
+}
+
+
+void WetCells::unpin()
+{
+    _pinned.clear();
+}
+
+
+void WetCells::update(CA::CellBuffReal& WD, CA::Real ignore_wd, const CA::BoxList& domain)
+{
+    CA::RowList scan;
+    usedRows(domain, scan);
+
+    rebuild(WD, ignore_wd, scan, scan);
+}
+
+
+void WetCells::update(CA::CellBuffReal& WD, CA::Real ignore_wd)
+{
+    const CA::RowList previous(_rows);
+
+    rebuild(WD, ignore_wd, previous, previous);
+}
+
+
+void WetCells::rebuild(CA::CellBuffReal& WD, CA::Real ignore_wd, const CA::RowList& scan, const CA::RowList& previous)
+{
+    const CA::Unsigned width = _fullbox.w();
+    const CA::Unsigned height = _fullbox.h();
+
+    // Find the wet cells of the scanned rows, their flags are reset
+    // once read, thus only the flags of the list are ever touched.
+    findWetCells(scan, _grid, WD, *_mask, ignore_wd, _flags);
+
+    _wet.clear();
+    for (CA::RowList::ConstIter ir = scan.begin(); ir != scan.end(); ++ir)
+    {
+        const CA::Unsigned start = ir->y * width + ir->x;
+        for (CA::Unsigned i = start; i < start + ir->w; ++i)
+        {
+            if (_flags[i])
+            {
+                _wet.push_back(i);
+                _flags[i] = 0;
+            }
+        }
+    }
+
+    // The intervals of the halo around each run of wet cells and
+    // around the pinned boxes.
+    std::vector<Interval> intervals;
+    for (size_t k = 0; k < _wet.size();)
+    {
+        const CA::Unsigned y = _wet[k] / width;
+        const CA::Unsigned x = _wet[k] % width;
+        size_t e = k + 1;
+        while (e < _wet.size() && _wet[e] == _wet[e - 1] + 1 && _wet[e] / width == y)
+            ++e;
+
+        const CA::Unsigned ty = (y > _halo) ? y - _halo : 0;
+        const CA::Unsigned by = std::min(y + _halo + 1, height);
+        Interval iv;
+        iv.a = (x > _halo) ? x - _halo : 0;
+        iv.b = std::min(x + static_cast<CA::Unsigned>(e - k) + _halo, width);
+        for (iv.y = ty; iv.y < by; ++iv.y)
+            intervals.push_back(iv);
+
+        k = e;
+    }
+
+    for (size_t k = 0; k < _pinned.size(); ++k)
+    {
+        const CA::Box& box = _pinned[k];
+        const CA::Unsigned ty = (box.top() > _halo) ? box.top() - _halo : 0;
+        const CA::Unsigned by = std::min(box.bottom() + _halo, height);
+        Interval iv;
+        iv.a = (box.left() > _halo) ? box.left() - _halo : 0;
+        iv.b = std::min(box.right() + _halo, width);
+        for (iv.y = ty; iv.y < by; ++iv.y)
+            intervals.push_back(iv);
+    }
+
+    std::sort(intervals.begin(), intervals.end());
+
+    // Merge the intervals of each line and keep only their data and
+    // boundary cells.
+    CA::RowList rows;
+    for (size_t k = 0; k < intervals.size();)
+    {
+        const CA::Unsigned y = intervals[k].y;
+        CA::Unsigned a = intervals[k].a;
+        CA::Unsigned b = intervals[k].b;
+        CA::Unsigned u = _line[y];
+
+        for (++k; ; ++k)
+        {
+            if (k < intervals.size() && intervals[k].y == y && intervals[k].a <= b)
+            {
+                b = std::max(b, intervals[k].b);
+                continue;
+            }
+
+            // Intersect the interval [a,b) with the used rows of the
+            // line.
+            for (; u < _line[y + 1] && _used[u].x < b; ++u)
+            {
+                const CA::Unsigned l = std::max(a, _used[u].x);
+                const CA::Unsigned r = std::min(b, _used[u].x + _used[u].w);
+                if (l < r)
+                    rows.add(l, y, r - l);
+                if (_used[u].x + _used[u].w > b)
+                    break;
+            }
+
+            if (k < intervals.size() && intervals[k].y == y)
+            {
+                a = intervals[k].a;
+                b = intervals[k].b;
+                continue;
+            }
+
+            break;
+        }
+    }
+
+    _added.clear();
+    _removed.clear();
+    difference(rows, previous, _added);
+    difference(previous, rows, _removed);
+
+    _rows = rows;
+}
+
+
+void WetCells::usedRows(const CA::BoxList& bl, CA::RowList& rl) const
+{
+    // The intervals of the lines of each box.
+    std::vector<Interval> intervals;
+    for (CA::BoxList::ConstIter ibox = bl.begin(); ibox != bl.end(); ++ibox)
+    {
+        CA::Box box(*ibox);
+        box.limit(_fullbox);
+        if (box.empty())
+            continue;
+
+        Interval iv;
+        iv.a = box.left();
+        iv.b = box.right();
+        for (iv.y = box.top(); iv.y < box.bottom(); ++iv.y)
+            intervals.push_back(iv);
+    }
+
+    std::sort(intervals.begin(), intervals.end());
+
+    // The boxes do not overlap, thus neither the intervals.
+    rl.clear();
+    for (size_t k = 0; k < intervals.size(); ++k)
+    {
+        const Interval& iv = intervals[k];
+        for (CA::Unsigned u = _line[iv.y]; u < _line[iv.y + 1] && _used[u].x < iv.b; ++u)
+        {
+            const CA::Unsigned l = std::max(iv.a, _used[u].x);
+            const CA::Unsigned r = std::min(iv.b, _used[u].x + _used[u].w);
+            if (l < r)
+                rl.add(l, iv.y, r - l);
+        }
+    }
+}
+
+
+void WetCells::difference(const CA::RowList& a, const CA::RowList& b, CA::RowList& c)
+{
+    // Both lists are sorted, the rows of b before the current row of a
+    // are skipped.
+    CA::Unsigned j = 0;
+    for (CA::RowList::ConstIter ia = a.begin(); ia != a.end(); ++ia)
+    {
+        const CA::Unsigned end = ia->x + ia->w;
+
+        while (j < b.size() && (b[j].y < ia->y || (b[j].y == ia->y && b[j].x + b[j].w <= ia->x)))
+            ++j;
+
+        CA::Unsigned x = ia->x;
+        for (CA::Unsigned k = j; x < end; ++k)
+        {
+            if (k < b.size() && b[k].y == ia->y && b[k].x < end)
+            {
+                if (b[k].x > x)
+                    c.add(x, ia->y, b[k].x - x);
+                x = std::max(x, b[k].x + b[k].w);
+            }
+            else
+            {
+                c.add(x, ia->y, end - x);
+                x = end;
+            }
+        }
+    }
+}
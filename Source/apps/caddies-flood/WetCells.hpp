@@ -0,0 +1,179 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef _WETCELLS_HPP_
+#define _WETCELLS_HPP_
+
+
+//! \file WetCells.hpp
+//! Contains the class that manages the compact list of the wet cells
+//! of the grid, and of the cells around them, used to compute the
+//! outflow and the water depth when only a small fraction of the grid
+//! is wet.
+//! \date 2026-10
+
+
+#include"ca2D.hpp"
+#include"BaseTypes.hpp"
+#include"Box.hpp"
+#include"BoxList.hpp"
+#include"RowList.hpp"
+#include"PointList.hpp"
+#include<vector>
+
+
+//! Manage the sorted list of the indices of the wet cells, i.e. the
+//! data cells with at least the water depth that can be ignored, and
+//! the list of rows of the cells to compute: the wet cells (or pinned
+//! by an event) plus a halo of the given number of cells around them.
+//! The water moves at most one cell per time step, thus if the list is
+//! updated at least once every halo iterations, the water cannot leave
+//! it between two updates. Only the data and boundary cells are in the
+//! list.
+class WetCells
+{
+public:
+
+    //! Create the list of the grid with the given halo (in cells). The
+    //! MASK is used to identify the data and boundary cells, only the
+    //! cells inside the given domain can be in the list.
+    WetCells(CA::Grid& GRID, CA::CellBuffMask& MASK, const CA::BoxList& domain, CA::Unsigned halo);
+
+    //! Read again the data cells from the MASK.
+    void setMask(CA::CellBuffMask& MASK);
+
+    //! Remove the given data cells, e.g. the upstream cells removed
+    //! from the MASK. They are not counted as data cells anymore, but
+    //! they can stay in the rows of the list, where the CA functions
+    //! skip them, until the next setMask.
+    void removeCells(const CA::PointList& pl);
+
+    //! Pin the cells of the given boxes, e.g. the areas of the events.
+    //! A pinned cell is always in the list as a wet one.
+    void pin(const CA::BoxList& bl);
+
+    //! Unpin all the cells.
+    void unpin();
+
+    //! Find the wet cells of the given domain and rebuild the list. The
+    //! cells of the domain not in the new list are the removed ones.
+    void update(CA::CellBuffReal& WD, CA::Real ignore_wd, const CA::BoxList& domain);
+
+    //! Find the wet cells of the list and rebuild it.
+    void update(CA::CellBuffReal& WD, CA::Real ignore_wd);
+
+    //! Return the sorted indices (y * width + x) of the wet cells.
+    const std::vector<CA::Unsigned>& wet() const;
+
+    //! Return the rows of the cells to compute.
+    const CA::RowList& rows() const;
+
+    //! Return the rows of the cells added by the last update.
+    const CA::RowList& added() const;
+
+    //! Return the rows of the cells removed by the last update.
+    const CA::RowList& removed() const;
+
+    //! Return the fraction of the data cells that are wet.
+    CA::Real wetFraction() const;
+
+    //! Return the halo, which is also the maximum number of iterations
+    //! between two updates.
+    CA::Unsigned halo() const;
+
+protected:
+
+    //! Find the wet cells of the given rows and rebuild the list, the
+    //! added and removed cells are the difference with the previous
+    //! rows.
+    void rebuild(CA::CellBuffReal& WD, CA::Real ignore_wd, const CA::RowList& scan, const CA::RowList& previous);
+
+    //! Create the rows of the data and boundary cells of the boxes.
+    void usedRows(const CA::BoxList& bl, CA::RowList& rl) const;
+
+    //! Add to c the rows of the cells of a that are not in b.
+    static void difference(const CA::RowList& a, const CA::RowList& b, CA::RowList& c);
+
+private:
+
+    CA::Grid&          _grid;       //!< The grid.
+    CA::CellBuffMask* _mask;        //!< The mask.
+    CA::Box            _fullbox;    //!< The box of the grid.
+    CA::BoxList        _domain;     //!< The domain of the list.
+    CA::Unsigned       _halo;       //!< The halo around the wet cells.
+    CA::Unsigned       _datacells;  //!< The number of data cells.
+    std::vector<char>  _data;       //!< True if a cell of the grid is a data cell of the domain.
+
+    std::vector<CA::RowList::Row> _used;    //!< The rows of the data and boundary cells of the domain.
+    std::vector<CA::Unsigned>     _line;    //!< The first row of _used of each line.
+    std::vector<CA::Box>          _pinned;  //!< The pinned boxes.
+    std::vector<char>             _flags;   //!< The wet flag of each cell of the grid.
+
+    std::vector<CA::Unsigned> _wet; //!< The sorted indices of the wet cells.
+    CA::RowList  _rows;             //!< The rows of the cells to compute.
+    CA::RowList  _added;            //!< The cells added by the last update.
+    CA::RowList  _removed;          //!< The cells removed by the last update.
+};
+
+
+/// ----- Inline implementation ----- ///
+
+
+inline const std::vector<CA::Unsigned>& WetCells::wet() const
+{
+    return _wet;
+}
+
+
+inline const CA::RowList& WetCells::rows() const
+{
+    return _rows;
+}
+
+
+inline const CA::RowList& WetCells::added() const
+{
+    return _added;
+}
+
+
+inline const CA::RowList& WetCells::removed() const
+{
+    return _removed;
+}
+
+
+inline CA::Real WetCells::wetFraction() const
+{
+    return (_datacells > 0) ? static_cast<CA::Real>(_wet.size()) / _datacells : 0.0;
+}
+
+
+inline CA::Unsigned WetCells::halo() const
+{
+    return _halo;
+}
+
+#endif
@@ -68,6 +68,20 @@ inline void version()
 int preProc(const ArgsData& ad, const Setup& setup, const std::string& ele_file);
 
 
+//! Perform the pre-processing of the reachable domain using the given
+//! parameters (see pre_proc.cpp).
+//! \param[in] ad       The arguments data.
+//! \param[in] setup    The setup of the simulation.
+//! \param[in] eg       The elevation grid.
+//! \param[in] res      The list of rain event inputs.
+//! \param[in] wles     The list of water level event inputs.
+//! \param[in] ies      The list of inflow event inputs.
+//! \return A non-zero value if there was an error.
+int preProcReach(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Real>& eg,
+    const std::vector<RainEvent>& res, const std::vector<WLEvent>& wles,
+    const std::vector<IEvent>& ies);
+
+
 //! Perform the post processing of the data for a CA 2D model. 
 //! \param[in] ad       The arguments data.
 //! \param[in] setup    The setup of the simulation.
@@ -310,8 +324,21 @@ int main(int argc, char* argv[])
         std::cout << "Raster Decimal Places     : " << setup.rast_places << std::endl;
         std::cout << "Update Peak Every DT      : " << setup.update_peak_dt << std::endl;
         std::cout << "Expand Domain             : " << setup.expand_domain << std::endl;
+        std::cout << "Domain Tile Size          : " << setup.domain_tile << std::endl;
+        std::cout << "Decomposition Efficiency  : " << setup.decomp_eff << std::endl;
+        std::cout << "Decomposition Min Lines   : " << setup.decomp_lines << std::endl;
+        std::cout << "Wet Cells Fraction        : " << setup.wet_fraction << std::endl;
+        std::cout << "Wet Cells Halo            : " << setup.wet_halo << std::endl;
         std::cout << "Ignore Upstream           : " << setup.ignore_upstream << std::endl;
         std::cout << "Upstream Reduction        : " << setup.upstream_reduction << std::endl;
+        std::cout << "Reach Domain              : " << setup.reach_domain << std::endl;
+        std::cout << "Reach Head Tolerance      : " << setup.reach_tol << std::endl;
+        std::cout << "Local Time Step Levels    : " << setup.lts_levels << std::endl;
+        std::cout << "Local Time Step Tile Size : " << setup.lts_tile << std::endl;
+        std::cout << "SIMD Kernels              : " << setup.simd_kernels << std::endl;
+        std::cout << "Fused Sweep               : " << setup.fused_sweep << std::endl;
+        std::cout << "Temporal Block Steps      : " << setup.block_steps << std::endl;
+        std::cout << "Pipelined Update          : " << setup.pipelined_update << std::endl;
     }
 
     setup.terrain_info = false;
@@ -544,6 +571,18 @@ int main(int argc, char* argv[])
             }
         }
 
+        //! The reachable domain depends on the events, thus it is
+        //! computed for every simulation, also when the other
+        //! pre-processed data are not pre-processed again.
+        if (setup.reach_domain && !ad.model.empty())
+        {
+            if (preProcReach(ad, setup, eg, res, wles, ies) != 0)
+            {
+                std::cerr << "Error while performing pre-processing of the reachable domain" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
         //! Now display the terrain info
         if (ad.terrain_info)
         {
@@ -155,7 +155,7 @@ int postProc(const ArgsData& ad, const Setup& setup, CA::AsciiGrid<CA::Real>& eg
     // Create the MASK cell buffer. The mask is useful to check which
     // cell has data and nodata and which cell has neighbourhood with
     // data.
-    CA::CellBuffState MASK(GRID);
+    CA::CellBuffMask MASK(GRID);
 
     // ---- SCALAR VALUES ----
 
@@ -545,6 +545,10 @@ int postProc(const ArgsData& ad, const Setup& setup, CA::AsciiGrid<CA::Real>& eg
         // Remove Elevation data.
         CA::CellBuffReal::removeData(ad.data_dir, setup.preproc_name + "_ELV", "0");
 
+        // Remove Reachable domain data.
+        if (setup.reach_domain)
+            CA::CellBuffState::removeData(ad.data_dir, setup.preproc_name + "_REACH", "0");
+
         // Remove Grid data.
         CA::Grid::remove(ad.data_dir, setup.preproc_name + "_Grid", "0");
     }
@@ -663,7 +667,7 @@ int postProc_2(const std::string& data_dir, const Setup& setup, CA::AsciiGrid<CA
     // Create the MASK cell buffer. The mask is useful to check which
     // cell has data and nodata and which cell has neighbourhood with
     // data.
-    CA::CellBuffState MASK(GRID);
+    CA::CellBuffMask MASK(GRID);
 
     // ---- SCALAR VALUES ----
 
@@ -995,6 +999,10 @@ int postProc_2(const std::string& data_dir, const Setup& setup, CA::AsciiGrid<CA
     // Remove Elevation data.
     CA::CellBuffReal::removeData(data_dir, setup.preproc_name + "_ELV", "0");
 
+    // Remove Reachable domain data.
+    if (setup.reach_domain)
+        CA::CellBuffState::removeData(data_dir, setup.preproc_name + "_REACH", "0");
+
     // Remove Grid data.
     CA::Grid::remove(data_dir, setup.preproc_name + "_Grid", "0");
 
@@ -30,8 +30,13 @@ THE SOFTWARE.
 
 
 #include"ca2D.hpp"
+#include"Masks.hpp"
 #include"ArgsData.hpp"
 #include"Setup.hpp"
+#include"Rain.hpp"
+#include"Inflow.hpp"
+#include"WaterLevel.hpp"
+#include"ReachDomain.hpp"
 
 
 //! Perform the pre processing of the data for a CA 2D model. It
@@ -263,3 +268,82 @@ int preProc_2(const std::string& data_dir, const Setup& setup, const CA::AsciiGr
     return 0;
 }
 
+
+
+//! Find the cells that the water of the events can reach and save
+//! them in the REACH buffer. The grid and the elevation must be
+//! already pre-processed.
+//! \return A non-zero value if there was an error.
+static int reachProc(CA::Grid& GRID, const Setup& setup, CA::Real nodata,
+    const std::vector<RainEvent>& res, const std::vector<WLEvent>& wles,
+    const std::vector<IEvent>& ies, CA::Unsigned& cells)
+{
+    CA::BoxList  fulldomain;
+    CA::Box      fullbox = GRID.box();
+    fulldomain.add(fullbox);
+
+    CA::Borders borders;
+
+    // Load the elevation.
+    CA::CellBuffReal  ELV(GRID);
+    ELV.bordersValue(borders, nodata);
+    ELV.fill(fulldomain, nodata);
+
+    if (!ELV.loadData(setup.preproc_name + "_ELV", "0"))
+    {
+        std::cerr << "Error while loading the Elevation pre-processed file" << std::endl;
+        return 1;
+    }
+
+    // The data cells.
+    CA::CellBuffMask MASK(GRID);
+    CA::createCellMask(fulldomain, GRID, ELV, MASK, nodata);
+
+    // The areas of the events are the sources of the water.
+    CA::BoxList sources;
+
+    WaterLevelManager wl_manager(GRID, wles);
+    wl_manager.addDomain(sources);
+
+    RainManager rain_manager(GRID, res);
+    rain_manager.addDomain(sources);
+
+    InflowManager inflow_manager(GRID, ies);
+    inflow_manager.addDomain(sources);
+
+    CA::CellBuffState REACH(GRID);
+    cells = ReachDomain::compute(GRID, ELV, MASK, sources, setup.reach_tol, REACH);
+
+    if (!REACH.saveData(setup.preproc_name + "_REACH", "0"))
+    {
+        std::cerr << "Error while saving the Reachable domain data" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+
+//! Perform the pre processing of the reachable domain, i.e. the cells
+//! that the water of the events can reach. It is computed every time
+//! since it depends on the events.
+int preProcReach(const ArgsData& ad, const Setup& setup, const CA::AsciiGrid<CA::Real>& eg,
+    const std::vector<RainEvent>& res, const std::vector<WLEvent>& wles,
+    const std::vector<IEvent>& ies)
+{
+    // Load the CA Grid from the DataDir.
+    CA::Grid  GRID(ad.data_dir, setup.preproc_name + "_Grid", "0", ad.args.active(), 9999);
+    GRID.setCAPrint(false);
+
+    CA::Unsigned cells = 0;
+    if (reachProc(GRID, setup, eg.nodata, res, wles, ies, cells) != 0)
+        return 1;
+
+    if (setup.output_console)
+    {
+        std::cout << "Saved Reachable domain data : " << cells << " cells" << std::endl;
+        std::cout << "------------------------------------------" << std::endl;
+    }
+
+    return 0;
+}
@@ -127,7 +127,7 @@ int terrainInfo(const ArgsData& ad, Setup& setup, const CA::AsciiGrid<CA::Real>&
     // Create the MASK cell buffer. The mask is useful to check which
     // cell has data and nodata and which cell has neighbourhood with
     // data.
-    CA::CellBuffState MASK(GRID);
+    CA::CellBuffMask MASK(GRID);
 
 
     // ----  SCALAR VALUES ----
@@ -157,7 +157,7 @@ int terrainInfo(const ArgsData& ad, Setup& setup, const CA::AsciiGrid<CA::Real>&
     //***********************//
 
     // The MASK is used to check if a cell with nodata has a neighbour
-    // with data (Bit 31 set to true in the MASK). This kind of cells
+    // with data (boundary bit set to true in the MASK). This kind of cells
     // are called boundary cells and they are ignored by the computation
     // (not visited), i.e. the rain is not added into them, the outflow
     // are not computed. However, these boundary cells are used as
@@ -38,6 +38,9 @@ THE SOFTWARE.
 #include"BaseTypes.hpp"
 #include"Box.hpp"
 #include<list>
+#include<map>
+#include<vector>
+#include<algorithm>
 
 
 namespace CA {
@@ -51,6 +54,11 @@ namespace CA {
     //! \warning The position (0,0) in the Grid correspond to the
     //! top-left corner of the grid.
 
+    //! The boxes are indexed by their top line, thus only the boxes
+    //! with the top line in the interval of the lines that can
+    //! intersect a new box are checked when it is added, instead of the
+    //! whole list.
+
     class BoxList
     {
     private:
@@ -60,6 +68,9 @@ namespace CA {
         //! Identifies the interator.
         typedef Boxes::iterator Iter;
 
+        //! Identifies the index of the boxes by their top line.
+        typedef std::multimap<Unsigned, Iter> Index;
+
     public:
         //! Identifies the constant interator.
         typedef Boxes::const_iterator ConstIter;
@@ -70,9 +81,15 @@ namespace CA {
         //! Create a Boxlist from a single box.
         BoxList(const Box& box);
 
+        //! Copy a BoxList.
+        BoxList(const BoxList& bl);
+
         //! Destroy the BoxList.
         ~BoxList();
 
+        //! Copy a BoxList.
+        BoxList& operator=(const BoxList& bl);
+
         // --- METHODS --- 
 
         //! Return the extent of the boxlist, i.e. the largest box that
@@ -81,11 +98,18 @@ namespace CA {
 
         //! Add a box into the list. The list should not contain two
         //! boxes that overlap (intersect). Thus when a box is added, the
-        //! method checks if it is overlapping with an existing box. If
-        //! there is overlap between two boxes, the algorithm substitute
-        //! the two boxes with smaller non overlapping one.
+        //! parts of it that overlap the existing boxes are removed and
+        //! only the remaining parts, at most four for each existing box
+        //! intersected, are added. The existing boxes are not changed.
         void add(const Box& box);
 
+        //! Merge the boxes that share a whole side into larger boxes,
+        //! until no two boxes can be merged. The region of the list and
+        //! its extent do not change. The efficiency of a merged box is
+        //! the mean of the efficiency of its boxes weighted by their
+        //! size.
+        void coalesce();
+
         //! Clear all the element in the box list.
         void clear();
 
@@ -96,6 +120,7 @@ namespace CA {
         ConstIter end() const;
 
         //! Return the iterator to the first box in the list.
+        //! \attention The lines of a box must not be changed.
         Iter begin();
 
         //! Return the iterator to the end of the list.
@@ -104,10 +129,42 @@ namespace CA {
         //! The number of boxes in the list.
         Unsigned size() const;
 
+    protected:
+
+        //! Return the first box of the list that intersect the given
+        //! box, or the end of the list.
+        Iter findIntersect(const Box& box);
+
+        //! Add to the list a box that does not intersect any box of it.
+        void insert(const Box& box);
+
+        //! Build the index of the boxes of the list.
+        void buildIndex();
+
+        //! Merge the boxes with the same lines that share their left
+        //! and right sides (horizontal) or the boxes with the same
+        //! columns that share their top and bottom sides (vertical).
+        //! Return true if at least two boxes were merged.
+        bool merge(bool horizontal);
+
+        //! Order the boxes by top line, height and left column.
+        static bool lessLines(const Iter& a, const Iter& b);
+
+        //! Order the boxes by left column, width and top line.
+        static bool lessColumns(const Iter& a, const Iter& b);
+
     private:
         //! The list of boxes.
         Boxes  _boxes;
 
+        //! The index of the boxes by their top line.
+        Index  _index;
+
+        //! The maximum height of the boxes of the list, the boxes with
+        //! the top line over this height from the top of a box cannot
+        //! intersect it.
+        Unsigned _maxh;
+
         //! The extent of the BoxList, i.e. the largest box that contains
         //! all the boxes in the list.
         Box    _extent;
@@ -118,14 +175,24 @@ namespace CA {
 
 
     inline BoxList::BoxList() :
-        _boxes(), _extent(Box::Empty())
+        _boxes(), _index(), _maxh(0), _extent(Box::Empty())
     {
     }
 
 
     inline BoxList::BoxList(const Box& box) :
-        _boxes(1, box), _extent(box)
+        _boxes(1, box), _index(), _maxh(0), _extent(box)
+    {
+        buildIndex();
+    }
+
+
+    inline BoxList::BoxList(const BoxList& bl) :
+        _boxes(bl._boxes), _index(), _maxh(bl._maxh), _extent(bl._extent)
     {
+        // The index contains the iterators of the list, it cannot be
+        // copied.
+        buildIndex();
     }
 
 
@@ -134,6 +201,20 @@ namespace CA {
     }
 
 
+    inline BoxList& BoxList::operator=(const BoxList& bl)
+    {
+        if (this != &bl)
+        {
+            _boxes = bl._boxes;
+            _maxh = bl._maxh;
+            _extent = bl._extent;
+            buildIndex();
+        }
+
+        return *this;
+    }
+
+
     inline Box BoxList::extent() const
     {
         return _extent;
@@ -146,118 +227,80 @@ namespace CA {
         if (src.empty())
             return;
 
-        // NOTe: caution is required, I'm not sure this logic is complete. it's ambitious
+        // The parts of the box still to add.
+        std::vector<Box> toadd(1, src);
 
-        // Create a list of boxes to add.
-        Boxes toadd;
+        while (!toadd.empty())
+        {
+            Box part(toadd.back());
+            toadd.pop_back();
 
-        // Add the given box to the list.
-        toadd.push_back(src);
+            Iter iorg = findIntersect(part);
 
-        // Cycle through all the boxes in the existing list.
-        for (Boxes::iterator iorg = _boxes.begin(); iorg != _boxes.end(); ++iorg)
-        {
-            // Cycle through all the boxes to add.
-            for (Boxes::iterator iadd = toadd.begin(); iadd != toadd.end() && !toadd.empty();)
+            // If the part does not intersect any box, add it.
+            if (iorg == _boxes.end())
             {
-                // if box to add is completely within an existing box, then remove it from the list to add, and move on
-                if ((*iorg).Union((*iadd), (*iorg)) == (*iorg))
-                {
-                    iadd = toadd.erase(iadd);
-                    continue;
-                }
-
-                // Check if they intersect.
-                if ((*iorg).intersect((*iadd)))
-                {
-                    // The boxes can be defined in terms of their spans on each
-                    // axis - It is possible find the interesting points on each
-                    // axis where a box starts or ends. This gives the
-                    // possibility of 9 possible sub-boxes of which between 7 to
-                    // 9 might exist. The boxes 2, 4, 5, 6 and 8 always exist.
-
-                    // . a b c d
-                    // e +-+-+-+
-                    // . |1|2|3|
-                    // f +-+-+-+
-                    // . |4|5|6|
-                    // g +-+-+-+
-                    // . |7|8|9|
-                    // h +-+-+-+
-
-                    // The 5 is the area of intersection.
-
-                    Unsigned a = std::min((*iorg).left(), (*iadd).left());
-                    Unsigned b = std::max((*iorg).left(), (*iadd).left());
-                    Unsigned c = std::min((*iorg).right(), (*iadd).right());
-                    Unsigned d = std::max((*iorg).right(), (*iadd).right());
-
-                    Unsigned e = std::min((*iorg).top(), (*iadd).top());
-                    Unsigned f = std::max((*iorg).top(), (*iadd).top());
-                    Unsigned g = std::min((*iorg).bottom(), (*iadd).bottom());
-                    Unsigned h = std::max((*iorg).bottom(), (*iadd).bottom());
-
-                    Point ae(a, e); Point be(b, e);  Point ce(c, e); Point de(d, e);
-                    Point af(a, f); Point bf(b, f);  Point cf(c, f); Point df(d, f);
-                    Point ag(a, g); Point bg(b, g);  Point cg(c, g); Point dg(d, g);
-                    Point ah(a, h); Point bh(b, h);  Point ch(c, h); Point dh(d, h);
-
-
-                    // We substitute the two boxes doing these steps:
-                    // (1) Add boxes 2,4,6, and 8 to the list of boxes to add.
-                    // (2) Check if sub-boxes 1,3,7,9 are inside iadd or iorg.
-                    //     and if it is the case add them to the list of boxes to add.
-                    // (3) Remove the iadd box from the list of boxes to add.
-                    // (4) Reduce the iorg box to be of the size of the intersect area (5). 
-
-                    // Step (1)
-                    toadd.push_back(Box(be, cf)); // Box 2
-                    toadd.push_back(Box(af, bg)); // Box 4
-                    toadd.push_back(Box(cf, dg)); // Box 6
-                    toadd.push_back(Box(bg, ch)); // Box 8
-
-                    // Step (2)
-                    if ((*iorg).inside(ae) || (*iadd).inside(ae))
-                        toadd.push_back(Box(ae, bf)); // Box 1
-
-                    if ((*iorg).inside(ce) || (*iadd).inside(ce))
-                        toadd.push_back(Box(ce, df)); // Box 3
-
-                    if ((*iorg).inside(ag) || (*iadd).inside(ag))
-                        toadd.push_back(Box(ag, bh)); // Box 7
-
-                    if ((*iorg).inside(cg) || (*iadd).inside(cg))
-                        toadd.push_back(Box(cg, dh)); // Box 9
-
-                    // Step (3)
-                    iadd = toadd.erase(iadd);
-
-                    // Step (4)
-                    (*iorg).setX(b);
-                    (*iorg).setY(f);
-                    (*iorg).setW(c - b);
-                    (*iorg).setH(g - f);
-                }
-                else
-                {
-                    // If does not intersect do nothing.
-                    ++iadd;
-                }
+                insert(part);
+                continue;
             }
-        }
 
-        // Now all the boxes in the toadd list shoud be guarantee not to
-        // overlapping. Thus add the new boxes into the BoxList.
-        _boxes.insert(_boxes.end(), toadd.begin(), toadd.end());
+            // The part is split in the parts outside the box that it
+            // intersects, which still need to be checked. The 5 is the
+            // area of intersection, which is removed.
+
+            // . a b c d
+            // e +-+-+-+
+            // . |1|2|3|
+            // f +-+-+-+
+            // . |4|5|6|
+            // g +-+-+-+
+            // . |7|8|9|
+            // h +-+-+-+
+
+            // The boxes 1-2-3 and 7-8-9 are taken as a whole, then the
+            // boxes 4 and 6.
+            const Box& org = *iorg;
+
+            Unsigned f = std::max(part.top(), org.top());
+            Unsigned g = std::min(part.bottom(), org.bottom());
+
+            if (part.top() < org.top())
+                toadd.push_back(Box(part.left(), part.top(), part.w(), org.top() - part.top(), part.e()));
+
+            if (part.bottom() > org.bottom())
+                toadd.push_back(Box(part.left(), org.bottom(), part.w(), part.bottom() - org.bottom(), part.e()));
+
+            if (part.left() < org.left())
+                toadd.push_back(Box(part.left(), f, org.left() - part.left(), g - f, part.e()));
+
+            if (part.right() > org.right())
+                toadd.push_back(Box(org.right(), f, part.right() - org.right(), g - f, part.e()));
+        }
 
         // Ok the box is added, update the extent. 
         _extent = Box::Union(_extent, src);
     }
 
 
+    inline void BoxList::coalesce()
+    {
+        bool merged = true;
+
+        // A merge can make possible a merge in the other direction.
+        while (merged)
+        {
+            merged = merge(true);
+            merged = merge(false) || merged;
+        }
+    }
+
+
     inline void BoxList::clear()
     {
         _boxes.clear();
+        _index.clear();
+        _maxh = 0;
+        _extent = Box::Empty();
     }
 
 
@@ -290,6 +333,113 @@ namespace CA {
         return _boxes.size();
     }
 
+
+    inline BoxList::Iter BoxList::findIntersect(const Box& box)
+    {
+        // A box with the top line before the top line of the given box
+        // minus the maximum height cannot reach it.
+        Unsigned first = (box.top() + 1 > _maxh) ? box.top() + 1 - _maxh : 0;
+
+        for (Index::iterator i = _index.lower_bound(first); i != _index.end() && i->first < box.bottom(); ++i)
+        {
+            if (i->second->intersect(box))
+                return i->second;
+        }
+
+        return _boxes.end();
+    }
+
+
+    inline void BoxList::insert(const Box& box)
+    {
+        Iter ibox = _boxes.insert(_boxes.end(), box);
+        _index.insert(Index::value_type(box.top(), ibox));
+        _maxh = std::max(_maxh, box.h());
+    }
+
+
+    inline void BoxList::buildIndex()
+    {
+        _index.clear();
+        _maxh = 0;
+        for (Iter ibox = _boxes.begin(); ibox != _boxes.end(); ++ibox)
+        {
+            _index.insert(Index::value_type(ibox->top(), ibox));
+            _maxh = std::max(_maxh, ibox->h());
+        }
+    }
+
+
+    inline bool BoxList::merge(bool horizontal)
+    {
+        if (_boxes.size() < 2)
+            return false;
+
+        // Sort the boxes thus the boxes that can be merged are next to
+        // each other.
+        std::vector<Iter> order;
+        order.reserve(_boxes.size());
+        for (Iter ibox = _boxes.begin(); ibox != _boxes.end(); ++ibox)
+            order.push_back(ibox);
+
+        std::sort(order.begin(), order.end(), horizontal ? lessLines : lessColumns);
+
+        bool merged = false;
+
+        // The box where the following boxes are merged.
+        Iter dst = order[0];
+        for (size_t k = 1; k < order.size(); ++k)
+        {
+            Iter src = order[k];
+
+            const bool join = horizontal ?
+                (src->top() == dst->top() && src->h() == dst->h() && src->left() == dst->right()) :
+                (src->left() == dst->left() && src->w() == dst->w() && src->top() == dst->bottom());
+
+            if (!join)
+            {
+                dst = src;
+                continue;
+            }
+
+            const Real size = static_cast<Real>(dst->size()) + static_cast<Real>(src->size());
+            dst->setE((dst->e() * dst->size() + src->e() * src->size()) / size);
+
+            if (horizontal)
+                dst->setW(dst->w() + src->w());
+            else
+                dst->setH(dst->h() + src->h());
+
+            _boxes.erase(src);
+            merged = true;
+        }
+
+        if (merged)
+            buildIndex();
+
+        return merged;
+    }
+
+
+    inline bool BoxList::lessLines(const Iter& a, const Iter& b)
+    {
+        if (a->top() != b->top())
+            return a->top() < b->top();
+        if (a->h() != b->h())
+            return a->h() < b->h();
+        return a->left() < b->left();
+    }
+
+
+    inline bool BoxList::lessColumns(const Iter& a, const Iter& b)
+    {
+        if (a->left() != b->left())
+            return a->left() < b->left();
+        if (a->w() != b->w())
+            return a->w() < b->w();
+        return a->top() < b->top();
+    }
+
 } // CA
 
 #endif  // _CA_BOXLIST_HPP_
@@ -41,7 +41,40 @@ namespace CA {
     //! Return a list of implementation specific Options  
     inline Options options()
     {
-        return Options();
+        Options options;
+
+        // Add the optional arguments. The tag start from 1000 for safety
+        // reason.
+        CA::Unsigned na = 1000;
+
+        options.push_back(new Arguments::Arg(na++, "row-streaming",
+            "Execute the CA functions row by row with hoisted buffers.", "", true, false, false));
+
+        options.push_back(new Arguments::Arg(na++, "tile-x",
+            "The X size of the tiles of a box executed by a thread (0 the box width).", "0", true, true, false));
+
+        options.push_back(new Arguments::Arg(na++, "tile-y",
+            "The Y size of the tiles of a box executed by a thread (0 one row).", "0", true, true, false));
+
+        options.push_back(new Arguments::Arg(na++, "tile-schedule",
+            "The schedule of the tiles between the threads: static, dynamic, guided or stealing.", "static", true, true, false));
+
+        options.push_back(new Arguments::Arg(na++, "numa",
+            "First touch the buffers with the threads that use them and pin the threads.", "", true, false, false));
+
+        options.push_back(new Arguments::Arg(na++, "row-skew",
+            "Skew the row pitch and the start of the buffers to avoid cache set aliasing.", "", true, false, false));
+
+        options.push_back(new Arguments::Arg(na++, "huge-pages",
+            "Allocate the large buffers at a huge page boundary and back them with huge pages.", "", true, false, false));
+
+        options.push_back(new Arguments::Arg(na++, "cell-record",
+            "The number of cell buffers of the same type with interleaved rows (1 separate buffers).", "1", true, true, false));
+
+        options.push_back(new Arguments::Arg(na++, "team-min-cells",
+            "The minimum number of cells of a task list executed by the team of threads.", "16384", true, true, false));
+
+        return options;
     }
 
 }
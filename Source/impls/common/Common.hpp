@@ -44,6 +44,7 @@ THE SOFTWARE.
 #include"BoxList.hpp"
 #include"Point.hpp"
 #include"PointList.hpp"
+#include"RowList.hpp"
 #include"Clock.hpp"
 #include"Utilities.hpp"
 
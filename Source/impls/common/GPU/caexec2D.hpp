@@ -36,6 +36,7 @@ THE SOFTWARE.
 
 #include"cabuffs2D.hpp"
 #include"Alarms.hpp"
+#include"Reduction.hpp"
 
 
 // Get rid of the annoying visual studio warning 4244 
@@ -87,6 +88,20 @@ namespace CA {
         }
 
 
+        // Template specialisation that set the given CellBuff as argument
+        // to the given kernel and retrieve the eventual event to wait.
+        template<>
+        inline void setKernelArg<CellBuffMask>(cl::Kernel& k, cl_uint index, CellBuffMask& a,
+            std::vector<cl::Event>* wait_events)
+        {
+            k.setArg(index, a.buffer());
+
+#ifdef  CA_OCL_USE_EVENTS
+            wait_events->push_back(a.event());
+#endif
+        }
+
+
         // Template specialisation that set the given EdgeBuff as argument
         // to the given kernel and retrieve the eventual event to wait.
         template<>
@@ -129,6 +144,20 @@ namespace CA {
         }
 
 
+        // Template specialisation that set the given ReductionReal as argument
+        // to the given kernel and retrieve the eventual event to wait.
+        template<>
+        inline void setKernelArg<ReductionReal>(cl::Kernel& k, cl_uint index, ReductionReal& a,
+            std::vector<cl::Event>* wait_events)
+        {
+            k.setArg(index, a.buffer());
+
+#ifdef  CA_OCL_USE_EVENTS
+            wait_events->push_back(a.event());
+#endif
+        }
+
+
         // Template specialisation that set the given TableReal as argument
         // to the given kernel and retrieve the eventual event to wait.
         template<>
@@ -183,6 +212,15 @@ namespace CA {
         }
 
 
+        // Template specialisation that set the given event into the 
+        // given CellBuffer arg.
+        template<>
+        inline void setEventArg<CellBuffMask>(cl::Event& e, CellBuffMask& a)
+        {
+            a.setEvent(e);
+        }
+
+
         // Template specialisation that set the given event into the 
         // given EdgeBuffer arg.
         template<>
@@ -210,6 +248,15 @@ namespace CA {
         }
 
 
+        // Template specialisation that set the given event into the 
+        // given ReductionReal arg.
+        template<>
+        inline void setEventArg<ReductionReal>(cl::Event& e, ReductionReal& a)
+        {
+            a.setEvent(e);
+        }
+
+
         // Template specialisation that set the given event into the 
         // given TableReal arg.
         template<>
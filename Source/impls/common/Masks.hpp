@@ -42,6 +42,7 @@ THE SOFTWARE.
 // -------------------------//
 #include CA_2D_INCLUDE(caFuncCreateCellMask)
 #include CA_2D_INCLUDE(caFuncCreateSimplerCellMask)
+#include CA_2D_INCLUDE(caFuncCreateCompactCellMask)
 
 
 namespace CA {
@@ -76,6 +77,23 @@ namespace CA {
     }
 
 
+    //! Special method that modifies the given mask cell buffer to be a
+    //! Mask with the same information of the state Mask above. The bits
+    //! are read with caMaskData (bit 0 and the neighbours), caMaskBorder
+    //! (bit 30) and caMaskBoundary (bit 31), their position depends on
+    //! the implementation.
+
+    //! \param bl     Identifies the region of the grid where to compute the mask.
+    //! \param g      The grid
+    //! \param src    The real cell buffer from where the mask is computed.
+    //! \param mask   The output mask.
+    //! \param nodata The value of the no-data in the real cell buffer.
+    inline void createCellMask(const BoxList& bl, Grid& g, CellBuffReal& src, CellBuffMask& mask, Real nodata)
+    {
+        CA::Execute::function(bl, caFuncCreateCompactCellMask, g, src, mask, nodata);
+    }
+
+
     //! Special method that modifies the given state cell buffer to be a
     //! simpler Mask (data or nodata) with various information about
     //! the given real cell buffer using nodata.
@@ -99,17 +117,14 @@ namespace CA {
     //! Read the value stored in the selected bits from the given value.
     inline State readBitsState(State value, int start, int stop)
     {
-        State ret = 0;
+        if (stop <= start)
+            return 0;
 
-        int b = 0;
-        int s = 0;
+        // The bits are shifted as unsigned, the width can be 32 bits.
+        const unsigned int bits = static_cast<unsigned int>(value) >> start;
+        const unsigned int width = static_cast<unsigned int>(stop - start);
 
-        for (b = 0, s = start; s < stop; b++, s++)
-        {
-            ret |= (value & (1 << s)) >> (s - b);
-        }
-
-        return ret;
+        return static_cast<State>((width >= 32) ? bits : bits & ((1u << width) - 1u));
     }
 
 
@@ -118,18 +133,14 @@ namespace CA {
     //! method.
     inline State writeBitsState(State value, State buffer, int start, int stop)
     {
-        int mask = 0;
-        int bits = 0;
-        int b = 0;
-        int s = 0;
-
-        for (b = 0, s = start; s < stop; b++, s++)
-        {
-            mask |= (1 << s);
-            bits |= (((1 << b)&value) >> b) << s;
-            buffer = (buffer&(~mask)) ^ bits;
-        }
-        return buffer;
+        if (stop <= start)
+            return buffer;
+
+        const unsigned int width = static_cast<unsigned int>(stop - start);
+        const unsigned int mask = ((width >= 32) ? ~0u : ((1u << width) - 1u)) << start;
+
+        return static_cast<State>((static_cast<unsigned int>(buffer) & ~mask) |
+            ((static_cast<unsigned int>(value) << start) & mask));
     }
 
 } // Namespace CA
@@ -0,0 +1,201 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef _CA_ROWLIST_HPP_
+#define _CA_ROWLIST_HPP_
+
+
+//! \file RowList.hpp
+//! Contains the class that contains a list of rows of cells. It can
+//! be used to identify a sparse region of the CA grid, e.g. the wet
+//! cells, without the cells around it that a box would contain.
+//! \date 2026-10
+
+
+#include"BaseTypes.hpp"
+#include"Box.hpp"
+#include<vector>
+
+
+namespace CA {
+
+    //! A RowList contains a list of rows, i.e. runs of consecutive
+    //! cells in the same line of the grid. It is the compact form of a
+    //! sorted list of cell indices.
+
+    //! \attention The rows are sorted by line and then by column, and
+    //! two rows never overlap.
+
+    //! \warning The position (0,0) in the Grid correspond to the
+    //! top-left corner of the grid.
+
+    class RowList
+    {
+    public:
+
+        //! A run of w consecutive cells starting from the cell (x,y).
+        struct Row
+        {
+            Unsigned x;
+            Unsigned y;
+            Unsigned w;
+        };
+
+    private:
+        //! Identifies the container of Rows.
+        typedef std::vector<Row> Rows;
+
+    public:
+
+        //! Identifies the constant interator.
+        typedef Rows::const_iterator ConstIter;
+
+        //! Create an empty RowList.
+        RowList();
+
+        //! Destroy the RowList.
+        ~RowList();
+
+        // --- METHODS --- 
+
+        //! Return the extent of the rowlist, i.e. the largest box that
+        //! contain all the rows in the list.
+        Box extent() const;
+
+        //! Add the run of w cells starting from the cell (x,y). The run
+        //! must be after the last row of the list. If it starts where
+        //! the last row ends, the two are merged.
+        void add(Unsigned x, Unsigned y, Unsigned w);
+
+        //! Clear all the rows in the list.
+        void clear();
+
+        //! Return the iterator to the first row in the list.
+        ConstIter begin() const;
+
+        //! Return the iterator to the end of the list.
+        ConstIter end() const;
+
+        //! Return the given row.
+        const Row& operator[](Unsigned i) const;
+
+        //! The number of rows in the list.
+        Unsigned size() const;
+
+        //! The number of cells in the list.
+        Unsigned cells() const;
+
+    private:
+        //! The list of rows.
+        Rows     _rows;
+
+        //! The number of cells.
+        Unsigned _cells;
+
+        //! The extent of the RowList.
+        Box      _extent;
+    };
+
+
+    /// ----- Inline implementation ----- ///
+
+
+    inline RowList::RowList() :
+        _rows(), _cells(0), _extent(Box::Empty())
+    {
+    }
+
+
+    inline RowList::~RowList()
+    {
+    }
+
+
+    inline Box RowList::extent() const
+    {
+        return _extent;
+    }
+
+
+    inline void RowList::add(Unsigned x, Unsigned y, Unsigned w)
+    {
+        if (w == 0)
+            return;
+
+        if (!_rows.empty() && _rows.back().y == y && _rows.back().x + _rows.back().w == x)
+        {
+            _rows.back().w += w;
+        }
+        else
+        {
+            Row r = { x, y, w };
+            _rows.push_back(r);
+        }
+
+        _cells += w;
+        _extent = Box::Union(_extent, Box(x, y, w, 1));
+    }
+
+
+    inline void RowList::clear()
+    {
+        _rows.clear();
+        _cells = 0;
+        _extent = Box::Empty();
+    }
+
+
+    inline RowList::ConstIter RowList::begin() const
+    {
+        return _rows.begin();
+    }
+
+
+    inline RowList::ConstIter RowList::end() const
+    {
+        return _rows.end();
+    }
+
+
+    inline const RowList::Row& RowList::operator[](Unsigned i) const
+    {
+        return _rows[i];
+    }
+
+
+    inline Unsigned RowList::size() const
+    {
+        return _rows.size();
+    }
+
+
+    inline Unsigned RowList::cells() const
+    {
+        return _cells;
+    }
+
+} // CA
+
+#endif  // _CA_ROWLIST_HPP_
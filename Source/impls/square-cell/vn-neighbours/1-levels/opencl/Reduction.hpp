@@ -0,0 +1,268 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef _CA_REDUCTION_HPP_
+#define _CA_REDUCTION_HPP_
+
+
+//! \file Reduction.hpp
+//! Define a global reduction of real values object.
+//! \author Michele Guidolin, University of Exeter, 
+//! contact: m.guidolin [at] exeter.ac.uk
+//! \date 2026-10
+
+
+#include"Grid.hpp"
+#include<limits>
+#include<vector>
+#include<algorithm>
+#include"caapi2D.hpp"
+
+
+namespace CA {
+
+    //! Define a global reduction of real values. The values can be
+    //! reduced (only) inside a CA function by using the
+    //! caReduceAddReal, caReduceMinReal and caReduceMaxReal methods,
+    //! however the result can be retrieved only in the main file.
+
+    //! Each work-group reduces the values into a partial value in the
+    //! device memory, the partial values are merged when the result is
+    //! retrieved.
+
+    //! \attention The CA function must use the method of the same
+    //! operator of the reduction (Add, Min or Max).
+
+    class ReductionReal : public CA::Uncopyable
+    {
+    public:
+
+        //! Create the reduction. It is possible to have implementation
+        //! specific options set by using the options list. \attention Do
+        //! not destroy the grid before destroying this object.
+        //! The reduction is reset to the identity of the operator.
+        //! \param grid    The Grid
+        //! \param op      The operator of the reduction (Add, Min or Max).
+        //! \param options The list of implementation specific options.
+        ReductionReal(Grid& grid, Seq::Operator op, const Options& options = Options());
+
+        //! Destroy the reduction.
+        virtual ~ReductionReal();
+
+        //! Return the specific options about the Reduction object and
+        //! this implementation.
+        static Options options();
+
+        //! Reset the reduction to the identity of the operator.
+        void reset();
+
+        //! Reset the reduction to the given value, i.e. the result is
+        //! the given value reduced with the values reduced by the CA
+        //! functions.
+        void reset(Real value);
+
+        //! Return the result of the reduction of the values reduced by
+        //! the CA functions executed after the last reset.
+        Real value();
+
+        // ---------  Implementation dependent --------------
+
+        //! Return the event that was generated by the last command that
+        //! used (or is using) the buffer.
+        cl::Event event() const;
+
+        //! Set the event that was generated by the last command.
+        void setEvent(cl::Event& event);
+
+        //! Return the OpenCl buffer.
+        cl::Buffer buffer() const;
+
+    private:
+
+        //! Return the identity of the operator.
+        _caReal identity() const;
+
+        //! The reference to the grid.
+        Grid& _grid;
+
+        //! The operator of the reduction.
+        Seq::Operator _op;
+
+        //! The local memory copy of the partial values.
+        std::vector<_caReal> _partials;
+
+        //! The size of the OnpeCL buffer in bytes.
+        _caUnsigned    _buff_size;
+
+        //! OpenCL buffer with the partial values.
+        cl::Buffer _buff;
+
+        //! The last event generated by a command that was using this
+        //! buffer. This can be used to synchonyse different command.
+        cl::Event  _event;
+    };
+
+
+    /// ----- Inline implementation ----- ///
+
+    inline ReductionReal::ReductionReal(Grid& grid, Seq::Operator op, const Options& options) :
+        _grid(grid),
+        _op(op),
+        _partials(_caReduceSlots),
+        _buff_size(),
+        _buff(),
+        _event()
+    {
+        // Create the buffer in the device memory.
+        _buff_size = sizeof(_caReal) * _caReduceSlots;
+        _buff = cl::Buffer(_grid.context(), CL_MEM_READ_WRITE, static_cast<std::size_t>(_buff_size));
+
+        reset();
+    }
+
+
+    inline ReductionReal::~ReductionReal()
+    {
+    }
+
+
+    inline Options ReductionReal::options()
+    {
+        Options options;
+
+        // Add the optional arguments. The tag start from higher number
+        // for safety reason.
+        CA::Unsigned na = 7000;
+
+        // Example
+        //options.push_back(new Arguments::Arg(na++,"option-name", "Option desctiption","value",true, true, false));
+
+        return options;
+    }
+
+
+    inline void ReductionReal::reset()
+    {
+        reset(identity());
+    }
+
+
+    inline void ReductionReal::reset(Real value)
+    {
+        // The first partial value starts from the given value, the
+        // others from the identity.
+        _partials.assign(_caReduceSlots, identity());
+        _partials[0] = static_cast<_caReal>(value);
+
+#ifdef  CA_OCL_USE_EVENTS 
+        // Create the list of event ot wait.
+        std::vector<cl::Event> wait_events(1, _event);
+
+        // Copy non-blocking the local memory partials into the device memory partials.
+        _grid.queue().enqueueWriteBuffer(_buff, CL_FALSE, 0, _buff_size, &_partials[0], &wait_events, &_event);
+#else
+        // Copy blocking the local memory partials into the device memory partials.
+        _grid.queue().enqueueWriteBuffer(_buff, CL_TRUE, 0, _buff_size, &_partials[0], NULL, NULL);
+#endif
+    }
+
+
+    inline Real ReductionReal::value()
+    {
+#ifdef  CA_OCL_USE_EVENTS     
+        // Create the list of event ot wait.
+        std::vector<cl::Event> wait_events(1, _event);
+
+        // Copy blocking the device memory partials into local memory partials.
+        _grid.queue().enqueueReadBuffer(_buff, CL_TRUE, 0, _buff_size, &_partials[0], &wait_events, &_event);
+#else
+        // Copy blocking the device memory partials into local memory partials.
+        _grid.queue().enqueueReadBuffer(_buff, CL_TRUE, 0, _buff_size, &_partials[0], NULL, NULL);
+#endif
+
+        Real result = _partials[0];
+
+        for (size_t i = 1; i < _partials.size(); ++i)
+        {
+            switch (_op)
+            {
+            case Seq::Add:
+                result += _partials[i];
+                break;
+            case Seq::Mul:
+                result *= _partials[i];
+                break;
+            case Seq::Min:
+            case Seq::MinAbs:
+                result = std::min<Real>(result, _partials[i]);
+                break;
+            case Seq::Max:
+            case Seq::MaxAbs:
+                result = std::max<Real>(result, _partials[i]);
+                break;
+            }
+        }
+
+        return result;
+    }
+
+
+    inline _caReal ReductionReal::identity() const
+    {
+        switch (_op)
+        {
+        case Seq::Mul:
+            return 1;
+        case Seq::Min:
+        case Seq::MinAbs:
+            return std::numeric_limits<_caReal>::max();
+        case Seq::Max:
+            return -std::numeric_limits<_caReal>::max();
+        default:
+            return 0;
+        }
+    }
+
+
+    inline cl::Event ReductionReal::event() const
+    {
+        return _event;
+    }
+
+
+    inline void ReductionReal::setEvent(cl::Event& event)
+    {
+        _event = event;
+    }
+
+
+    inline cl::Buffer ReductionReal::buffer() const
+    {
+        return _buff;
+    }
+
+}
+
+#endif  // _CA_REDUCTION_HPP_
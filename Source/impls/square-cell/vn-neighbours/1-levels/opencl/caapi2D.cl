@@ -36,6 +36,7 @@ THE SOFTWARE.
 // The OpenCL code needs 64 bit double operations.
 #if     CA_REAL_PRECISION == CA_REAL_DOUBLE
 #pragma OPENCL EXTENSION cl_khr_fp64 : enable 
+#pragma OPENCL EXTENSION cl_khr_int64_base_atomics : enable 
 #endif
 
 //#if !(defined(CL_VERSION_1_1) || defined(CL_VERSION_1_2)) 
@@ -66,6 +67,11 @@ typedef double          _caReal;
 //! Define the type of state values.
 typedef int             _caState;
 
+//! Define the type of the cell mask values, which has a bit for each
+//! cell of the neighbourhood and two flags (see caMaskData). The mask
+//! is stored as a state value.
+typedef int             _caMask;
+
 //! Define the type of a size value.
 typedef ulong           _caUnsigned;
 
@@ -162,6 +168,18 @@ const __constant _caInt caLevels = 1;
 //! Maximum number of neighbours in a level
 const __constant _caInt caMaxNeighboursLevel = 4;
 
+//! The bit of a mask which is true if the main cell has data and a
+//! neighbour cell has nodata.
+const __constant _caInt caMaskBorderBit = 30;
+
+//! The bit of a mask which is true if the main cell has nodata and a
+//! neighbour cell has data, i.e. a boundary cell.
+const __constant _caInt caMaskBoundaryBit = 31;
+
+//! The number of partial values of a reduction. Each work-group
+//! reduces its values into the partial value of its group id.
+const __constant _caInt _caReduceSlots = 256;
+
 // ---- CA FUNCTION DECLARATION METHODS ----
 
 //! \def CA_FUNCTION
@@ -184,6 +202,12 @@ typedef __global const _caState*     CA_CELLBUFF_STATE_I;
 //! Define the type of the read/write buffer with a state value in each cell.
 typedef __global _caState*           CA_CELLBUFF_STATE_IO;
 
+//! Define the type of the read only buffer with a mask in each cell.
+typedef __global const _caMask*      CA_CELLBUFF_MASK_I;
+
+//! Define the type of the read/write buffer with a mask in each cell.
+typedef __global _caMask*            CA_CELLBUFF_MASK_IO;
+
 //! Define the type of the read only buffer with a real value in each edge.
 typedef __global const _caReal*      CA_EDGEBUFF_REAL_I;
 
@@ -207,6 +231,11 @@ typedef const _caState               CA_GLOB_STATE_I;
 //! checked their status inside a CA function..
 typedef __global char*               CA_ALARMS_O;
 
+//! Define the type of a global reduction of real values. A value can
+//! be reduced (added, minimum, maximum) inside a CA function. However,
+//! the result can be retrieved only in the main file.
+typedef __global _caReal*            CA_GLOB_REDUCE_REAL;
+
 #if     CA_OCL_TABLE == CA_OCL_CONSTANT
 //! Define the type of a table with real data.
 typedef __constant  _caReal*         CA_TABLE_REAL_I;
@@ -229,6 +258,9 @@ typedef _caReal          CA_REAL;
 //! Define the type of a state value.
 typedef _caState         CA_STATE;
 
+//! Define the type of a mask value.
+typedef _caMask          CA_MASK;
+
 
 //! \def CA_GRID_INIT
 //! Intialise the grid structure.
@@ -768,17 +800,14 @@ inline void caCeilRealArray(_caReal values[], int n)
 //! Read the value stored in the selected bits from the given value.
 inline _caState caReadBitsState(_caState value, int start, int stop)
 {
-    _caState ret = 0;
-
-    int b = 0;
-    int s = 0;
+    if (stop <= start)
+        return 0;
 
-    for (b = 0, s = start; s < stop; b++, s++)
-    {
-        ret |= (value & (1 << s)) >> (s - b);
-    }
+    // The bits are shifted as unsigned, the width can be 32 bits.
+    uint bits  = ((uint)value) >> start;
+    uint width = (uint)(stop - start);
 
-    return ret;
+    return (_caState)((width >= 32) ? bits : bits & ((1u << width) - 1u));
 }
 
 
@@ -787,18 +816,59 @@ inline _caState caReadBitsState(_caState value, int start, int stop)
 //! method.
 inline _caState caWriteBitsState(_caState value, _caState buffer, int start, int stop)
 {
-    int mask = 0;
-    int bits = 0;
-    int b = 0;
-    int s = 0;
+    if (stop <= start)
+        return buffer;
 
-    for (b = 0, s = start; s < stop; b++, s++)
-    {
-        mask |= (1 << s);
-        bits |= (((1 << b)&value) >> b) << s;
-        buffer = (buffer&(~mask)) ^ bits;
-    }
-    return buffer;
+    uint width = (uint)(stop - start);
+    uint mask  = ((width >= 32) ? ~0u : ((1u << width) - 1u)) << start;
+
+    return (_caState)((((uint)buffer) & ~mask) | ((((uint)value) << start) & mask));
+}
+
+
+//! Return 1 if the given cell of the neighbourhood (0 is the main cell)
+//! has data in the given mask, 0 otherwise.
+inline _caState caMaskData(_caMask mask, int cell_number)
+{
+    return (((uint)mask) >> cell_number) & 1;
+}
+
+
+//! Return 1 if the main cell of the given mask has data and a neighbour
+//! cell has nodata, 0 otherwise.
+inline _caState caMaskBorder(_caMask mask)
+{
+    return (((uint)mask) >> caMaskBorderBit) & 1;
+}
+
+
+//! Return 1 if the main cell of the given mask has nodata and a
+//! neighbour cell has data, i.e. it is a boundary cell, 0 otherwise.
+inline _caState caMaskBoundary(_caMask mask)
+{
+    return (((uint)mask) >> caMaskBoundaryBit) & 1;
+}
+
+
+//! Return the given mask with the data bit of the given cell of the
+//! neighbourhood set to the given value (0 or 1).
+inline _caMask caMaskSetData(_caMask mask, int cell_number, _caState value)
+{
+    return (_caMask)((((uint)mask) & ~(1u << cell_number)) | ((((uint)value) & 1u) << cell_number));
+}
+
+
+//! Return the given mask with the border bit set to the given value.
+inline _caMask caMaskSetBorder(_caMask mask, _caState value)
+{
+    return caMaskSetData(mask, caMaskBorderBit, value);
+}
+
+
+//! Return the given mask with the boundary bit set to the given value.
+inline _caMask caMaskSetBoundary(_caMask mask, _caState value)
+{
+    return caMaskSetData(mask, caMaskBoundaryBit, value);
 }
 
 
@@ -852,6 +922,69 @@ inline void caActivateAlarmMask(CA_GRID grid, CA_ALARMS_O alarms, CA_STATE mask,
 }
 
 
+// ---- REDUCTIONS ----
+
+//! Return the partial value of the reduction of the work-group of
+//! the calling work-item.
+inline __global _caReal* _caReducePartial(CA_GLOB_REDUCE_REAL reduce)
+{
+    return reduce + (get_group_id(0) + get_group_id(1) * get_num_groups(0)) % _caReduceSlots;
+}
+
+
+//! Reduce the given value into the given partial value using the
+//! given operator (0 add, 1 minimum, 2 maximum). The work-items of a
+//! work-group share the partial value, it is updated atomically.
+inline void _caReduceAtomicReal(__global _caReal* partial, _caReal value, int op)
+{
+#if     CA_REAL_PRECISION == CA_REAL_FLOAT
+    union { uint i; float r; } prev, next;
+#else
+    union { ulong i; double r; } prev, next;
+#endif
+
+    do
+    {
+        prev.r = *partial;
+
+        // Nothing to do if the partial value does not change.
+        if ((op == 1 && !(value < prev.r)) || (op == 2 && !(value > prev.r)))
+            return;
+
+        next.r = (op == 0) ? prev.r + value : value;
+    }
+#if     CA_REAL_PRECISION == CA_REAL_FLOAT
+    while (atomic_cmpxchg((volatile __global uint*)partial, prev.i, next.i) != prev.i);
+#else
+    while (atom_cmpxchg((volatile __global ulong*)partial, prev.i, next.i) != prev.i);
+#endif
+}
+
+
+//! Add the given value into the reduction. \attention The reduction
+//! must use the Add operator.
+inline void caReduceAddReal(CA_GRID grid, CA_GLOB_REDUCE_REAL reduce, _caReal value)
+{
+    _caReduceAtomicReal(_caReducePartial(reduce), value, 0);
+}
+
+
+//! Reduce the given value into the reduction using the minimum.
+//! \attention The reduction must use the Min operator.
+inline void caReduceMinReal(CA_GRID grid, CA_GLOB_REDUCE_REAL reduce, _caReal value)
+{
+    _caReduceAtomicReal(_caReducePartial(reduce), value, 1);
+}
+
+
+//! Reduce the given value into the reduction using the maximum.
+//! \attention The reduction must use the Max operator.
+inline void caReduceMaxReal(CA_GRID grid, CA_GLOB_REDUCE_REAL reduce, _caReal value)
+{
+    _caReduceAtomicReal(_caReducePartial(reduce), value, 2);
+}
+
+
 // ---- CELL BUFFERS ----
 
 //! Read the real value of the cell from the given buffer at the given cell 
@@ -926,6 +1059,42 @@ inline void caWriteCellBuffState(CA_GRID grid, CA_CELLBUFF_STATE_IO dst, CA_GLOB
 }
 
 
+//! Read the mask of the cell from the given buffer at the given cell 
+inline _caMask caReadCellBuffMask(CA_GRID grid, CA_CELLBUFF_MASK_I src, int cell_number)
+{
+    long off = 0;
+    switch (cell_number)
+    {
+    case 0: break;
+    case 1: off += 1; break;
+    case 2: off -= grid.cb_stride; break;
+    case 3: off -= 1; break;
+    case 4: off += grid.cb_stride; break;
+    }
+
+    return src[grid.cb_index + off];
+}
+
+
+//! Set the given ca array with the masks of all the visible cells from
+//! the given buffer.
+inline void  caReadCellBuffMaskCellArray(CA_GRID grid, CA_CELLBUFF_MASK_I src, _caMask values[])
+{
+    values[0] = src[grid.cb_index];
+    values[1] = src[grid.cb_index + 1];
+    values[2] = src[grid.cb_index - grid.cb_stride];
+    values[3] = src[grid.cb_index - 1];
+    values[4] = src[grid.cb_index + grid.cb_stride];
+}
+
+
+//! Write the given mask of the cell into the given buffer at the main cell 
+inline void caWriteCellBuffMask(CA_GRID grid, CA_CELLBUFF_MASK_IO dst, _caMask value)
+{
+    dst[grid.cb_index] = value;
+}
+
+
 // ---- EDGE BUFFERS ----
 
 //! Read the real value of the edge from the given buffer at the given
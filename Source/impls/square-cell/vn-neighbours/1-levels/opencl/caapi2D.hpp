@@ -130,6 +130,10 @@ typedef cl_double           _caReal;
 //! Define the type of state values.
 typedef cl_int             _caState;
 
+//! Define the type of the cell mask values, which is stored as a state
+//! value (see caMaskData).
+typedef cl_int             _caMask;
+
 //! Define the type of a size value.
 typedef cl_ulong           _caUnsigned;
 
@@ -159,6 +163,18 @@ const int caLevels = 1;
 //! Maximum number of neighbours in a level
 const int caMaxNeighboursLevel = 4;
 
+//! The bit of a mask which is true if the main cell has data and a
+//! neighbour cell has nodata.
+const int caMaskBorderBit = 30;
+
+//! The bit of a mask which is true if the main cell has nodata and a
+//! neighbour cell has data, i.e. a boundary cell.
+const int caMaskBoundaryBit = 31;
+
+//! The number of partial values of a reduction. Each work-group
+//! reduces its values into the partial value of its group id.
+const int _caReduceSlots = 256;
+
 
 //! Contains the information about the grid which are used by the CA
 //! functions CA functions.  \attention position (0,0) is top left
@@ -374,18 +390,61 @@ inline _caUnsigned computeStride(_caUnsigned size, _caUnsigned alignment = 32)
 //! method.
 inline _caState caWriteBitsState(_caState value, _caState buffer, int start, int stop)
 {
-    int mask = 0;
-    int bits = 0;
-    int b = 0;
-    int s = 0;
-
-    for (b = 0, s = start; s < stop; b++, s++)
-    {
-        mask |= (1 << s);
-        bits |= (((1 << b)&value) >> b) << s;
-        buffer = (buffer&(~mask)) ^ bits;
-    }
-    return buffer;
+    if (stop <= start)
+        return buffer;
+
+    const unsigned int width = static_cast<unsigned int>(stop - start);
+    const unsigned int mask = ((width >= 32) ? ~0u : ((1u << width) - 1u)) << start;
+
+    return static_cast<_caState>((static_cast<unsigned int>(buffer) & ~mask) |
+        ((static_cast<unsigned int>(value) << start) & mask));
+}
+
+
+//! Return 1 if the given cell of the neighbourhood (0 is the main cell)
+//! has data in the given mask, 0 otherwise.
+inline _caState caMaskData(_caMask mask, int cell_number)
+{
+    return (static_cast<unsigned int>(mask) >> cell_number) & 1;
+}
+
+
+//! Return 1 if the main cell of the given mask has data and a neighbour
+//! cell has nodata, 0 otherwise.
+inline _caState caMaskBorder(_caMask mask)
+{
+    return (static_cast<unsigned int>(mask) >> caMaskBorderBit) & 1;
+}
+
+
+//! Return 1 if the main cell of the given mask has nodata and a
+//! neighbour cell has data, i.e. it is a boundary cell, 0 otherwise.
+inline _caState caMaskBoundary(_caMask mask)
+{
+    return (static_cast<unsigned int>(mask) >> caMaskBoundaryBit) & 1;
+}
+
+
+//! Return the given mask with the data bit of the given cell of the
+//! neighbourhood set to the given value (0 or 1).
+inline _caMask caMaskSetData(_caMask mask, int cell_number, _caState value)
+{
+    return static_cast<_caMask>((static_cast<unsigned int>(mask) & ~(1u << cell_number)) |
+        ((static_cast<unsigned int>(value) & 1u) << cell_number));
+}
+
+
+//! Return the given mask with the border bit set to the given value.
+inline _caMask caMaskSetBorder(_caMask mask, _caState value)
+{
+    return caMaskSetData(mask, caMaskBorderBit, value);
+}
+
+
+//! Return the given mask with the boundary bit set to the given value.
+inline _caMask caMaskSetBoundary(_caMask mask, _caState value)
+{
+    return caMaskSetData(mask, caMaskBoundaryBit, value);
 }
 
 
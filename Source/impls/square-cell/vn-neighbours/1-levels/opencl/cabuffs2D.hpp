@@ -83,6 +83,29 @@ namespace CA {
     };
 
 
+    //! Define the type of the mask of a cell.
+    typedef _caMask Mask;
+
+
+    //! Identifies the buffer which contains the mask of each cell in
+    //! the grid (see createCellMask), the flags of a mask are read with
+    //! caMaskData, caMaskBorder and caMaskBoundary. In this
+    //! implementation the mask is stored as a state value.
+    class CellBuffMask : public CellBuffState
+    {
+    public:
+        CellBuffMask(Grid& grid, const Options& options = Options()) :
+            CellBuffState(grid, options)
+        {
+        }
+
+        virtual ~CellBuffMask() {}
+
+    private:
+
+    };
+
+
     //! Identifies the buffer which contains a real value for each edge
     //! of each cell in the grid.
     class EdgeBuffReal : public EdgeBuff<Real>
@@ -53,6 +53,7 @@ THE SOFTWARE.
 #include"CellBuff.hpp"
 #include"EdgeBuff.hpp"
 #include"Alarms.hpp"
+#include"Reduction.hpp"
 #include"Functions.hpp"
 
 // The rest is the same of the simple implementation
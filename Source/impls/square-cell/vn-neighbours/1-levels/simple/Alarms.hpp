@@ -51,6 +51,12 @@ namespace CA {
     //! \attention The CA_GLOB_ALARMS used in the CA function can be
     //! different from this class. 
 
+    //! In the OpenMP implementation each thread activates the alarms in
+    //! its own cache line, the alarms of the threads are merged by the
+    //! get method. The sets are allocated for the largest team given by
+    //! Grid::maxThreads. \attention The OpenMP implementation supports
+    //! up to _caAlarmsStride (64) alarms in a set.
+
     class Alarms : public CA::Uncopyable
     {
     public:
@@ -62,6 +68,8 @@ namespace CA {
         //! \param grid    The Grid
         //! \param num     The number of alarms.
         //! \param options The list of implementation specific options.
+        //! \attention In the OpenMP implementation a std::runtime_error
+        //! is thrown if num is larger than _caAlarmsStride (64).
         Alarms(Grid& grid, Unsigned num, const Options& options = Options());
 
         //! Destroy the alarms.
@@ -99,12 +107,22 @@ namespace CA {
         // ---------  Implementation dependent --------------
 
         // Convert the set of allarms into the CA_GLOB_ALARMS used in the CA function
-        operator char*() { return &_alarms[0]; }
+        operator char*() { return _alarms; }
 
     private:
 
-        //! The set of alarms which is a vector of char.
-        std::vector<char> _alarms;
+        //! The number of alarms.
+        Unsigned _num;
+
+        //! The number of sets of alarms, one for each thread.
+        Unsigned _threads;
+
+        //! The distance between the alarms of two threads.
+        Unsigned _stride;
+
+        //! The sets of alarms of the threads. The first one contains the
+        //! merged alarms after the get method.
+        char* _alarms;
     };
 
 
@@ -112,14 +130,34 @@ namespace CA {
 
 
     inline Alarms::Alarms(Grid& grid, Unsigned num, const Options& options) :
-        _alarms(num)
+        _num(num),
+        _threads(1),
+        _stride(num),
+        _alarms()
     {
-        // GRID, FLAGS and OPTIONS are not used, it is just there for conformity.
+        // OPTIONS are not used, it is just there for conformity.
+
+#ifdef CA2D_OPENMP
+        if (_num > static_cast<Unsigned>(_caAlarmsStride))
+            throw std::runtime_error("Too many alarms in a set for the OpenMP implementation");
+
+        // A set of alarms for each thread of the largest team.
+        _threads = Grid::maxThreads();
+        _stride = _caAlarmsStride;
+#endif
+
+        // The alarms of each thread start at a cache line.
+        _alarms = static_cast<char*>(grid.allocBuffer(_threads * _stride + 1));
+        if (!_alarms)
+            throw std::runtime_error("Error allocating the alarms");
+
+        deactivateAll();
     }
 
 
     inline Alarms::~Alarms()
     {
+        Grid::freeBuffer(_alarms);
     }
 
 
@@ -140,16 +178,16 @@ namespace CA {
 
     inline void Alarms::deactivateAll()
     {
-        for (Unsigned i = 0; i < _alarms.size(); ++i)
-        {
-            _alarms[i] = 0;
-        }
+        memset(_alarms, 0, _threads * _stride);
     }
 
 
     inline void Alarms::deactivate(Unsigned n)
     {
-        _alarms[n] = 0;
+        for (Unsigned t = 0; t < _threads; ++t)
+        {
+            _alarms[t * _stride + n] = 0;
+        }
     }
 
 
@@ -161,7 +199,14 @@ namespace CA {
 
     inline void Alarms::get()
     {
-        // do nothing.
+        // Merge the alarms of the threads into the first set.
+        for (Unsigned t = 1; t < _threads; ++t)
+        {
+            for (Unsigned i = 0; i < _num; ++i)
+            {
+                _alarms[i] |= _alarms[t * _stride + i];
+            }
+        }
     }
 
 
@@ -173,7 +218,7 @@ namespace CA {
 
     inline bool Alarms::areAllActivated() const
     {
-        for (Unsigned i = 0; i < _alarms.size(); ++i)
+        for (Unsigned i = 0; i < _num; ++i)
         {
             if (_alarms[i] == 0)
                 return false;
@@ -183,7 +228,7 @@ namespace CA {
 
     inline const char* Alarms::isActivatedArray() const
     {
-        return &_alarms[0];
+        return _alarms;
     }
 }
 
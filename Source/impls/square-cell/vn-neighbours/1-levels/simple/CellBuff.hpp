@@ -40,6 +40,7 @@ THE SOFTWARE.
 #include<iostream>
 #include<cstdlib>
 #include<cstring>
+#include<vector>
 #include"caapi2D.hpp"
 
 
@@ -87,6 +88,12 @@ namespace CA {
         //! Copy all the value of the given buffer into the object buffer
         void copy(const CellBuff<T>& src);
 
+        //! Copy the values of the cells of the given region of the grid
+        //! from the given buffer into the object buffer. The region of
+        //! the grid is identifies by a list of boxes. The borders are not
+        //! copied.
+        void copy(const BoxList& bl, const CellBuff<T>& src);
+
         //! Read the values of the cells from a given region of the grid
         //! and upload the data into the given memory location. The region
         //! of the grid is identifies by a list of rectangular boxes where X and Y
@@ -255,8 +262,13 @@ namespace CA {
         _buff()
     {
         // Allocate the buffer for the cell.  
-        _buff_size = _cagrid.cb_x_size * _cagrid.cb_y_size * sizeof(T);
-        _buff = static_cast<T*>(calloc(_cagrid.cb_x_size * _cagrid.cb_y_size, sizeof(T)));
+        // Each row starts at the row pitch. The pages are first touched
+        // by the threads that use them in NUMA aware mode. With the cell
+        // records the rows are interleaved with the ones of the other
+        // buffers of the record, thus the buffer owns only the first
+        // part of each row pitch.
+        _buff_size = _cagrid.cb_x_pitch / _grid.cellRecord() * _grid.cellRows() * sizeof(T);
+        _buff = static_cast<T*>(_grid.allocCellBuffer(sizeof(T), typeid(T)));
     }
 
 
@@ -265,7 +277,7 @@ namespace CA {
     {
         if (_buff)
         {
-            free(_buff);
+            _grid.freeCellBuffer(_buff);
             _buff = 0;
         }
     }
@@ -290,7 +302,28 @@ namespace CA {
     template<typename T>
     inline void CellBuff<T>::clear(const T& value)
     {
-        std::fill(&_buff[0], &_buff[_cagrid.cb_x_size * _cagrid.cb_y_size], value);
+        // The part of each row pitch owned by the buffer.
+        const int x_pitch = static_cast<int>(_cagrid.cb_x_pitch);
+        const int x_size = static_cast<int>(_cagrid.cb_x_pitch / _grid.cellRecord());
+        const int y_size = static_cast<int>(_grid.cellRows());
+
+#ifdef CA2D_OPENMP
+        // Each thread clears a chunk of full rows (borders included).
+#pragma omp parallel for schedule(static)
+        for (int j = 0; j < y_size; ++j)
+        {
+            std::fill(&_buff[j * x_pitch], &_buff[j * x_pitch + x_size], value);
+        }
+#else
+        if (x_size == x_pitch)
+        {
+            std::fill(&_buff[0], &_buff[x_pitch * y_size], value);
+            return;
+        }
+
+        for (int j = 0; j < y_size; ++j)
+            std::fill(&_buff[j * x_pitch], &_buff[j * x_pitch + x_size], value);
+#endif
     }
 
 
@@ -306,8 +339,86 @@ namespace CA {
         if (!_buff || !src._buff)
             return;
 
+        // The part of each row pitch owned by the buffer.
+        const int x_pitch = static_cast<int>(_cagrid.cb_x_pitch);
+        const int x_size = static_cast<int>(_cagrid.cb_x_pitch / _grid.cellRecord());
+        const int y_size = static_cast<int>(_grid.cellRows());
+
+#ifdef CA2D_OPENMP
+        // Each thread copies a chunk of full rows (borders included).
+#pragma omp parallel for schedule(static)
+        for (int j = 0; j < y_size; ++j)
+        {
+            memcpy(&_buff[j * x_pitch], &src._buff[j * x_pitch], x_size * sizeof(T));
+        }
+#else
         // Copy the momory.
-        memcpy(_buff, src._buff, _buff_size);
+        if (x_size == x_pitch)
+        {
+            memcpy(_buff, src._buff, _buff_size);
+            return;
+        }
+
+        for (int j = 0; j < y_size; ++j)
+            memcpy(&_buff[j * x_pitch], &src._buff[j * x_pitch], x_size * sizeof(T));
+#endif
+    }
+
+
+    template<typename T>
+    inline void CellBuff<T>::copy(const BoxList& bl, const CellBuff<T>& src)
+    {
+        // The borders are not copied.
+
+        // Check that the two buffer belong to the same grid. If it not
+        // the case. Do nothing.
+        if (&_grid != &src._grid)
+            return;
+
+        // Check that both buffer are allocated.
+        if (!_buff || !src._buff)
+            return;
+
+        // Check that the extent of the boxlist is inside the domain of
+        // the grid.
+        if (!_grid.box().inside(bl.extent()))
+            return;
+
+        // Cycle through the boxes.
+        for (BoxList::ConstIter ibox = bl.begin(); ibox != bl.end(); ++ibox)
+        {
+            const Box box(*ibox);
+
+            const int j_start = static_cast<int>(box.y() + _cagrid.cb_border);
+            const int j_end = static_cast<int>(box.h() + box.y() + _cagrid.cb_border);
+            const int i_start = static_cast<int>(box.x() + _cagrid.cb_border);
+            const size_t row_size = box.w() * sizeof(T);
+
+#ifdef CA2D_OPENMP
+            // The size of the chunk for each thread.
+            Unsigned chunksize = box.h() / omp_get_num_procs() + 1;
+
+#pragma omp parallel for schedule(static,chunksize)
+#endif
+            for (int j_reg = j_start; j_reg < j_end; ++j_reg)
+            {
+                const Unsigned row = _caCellRow(_cagrid, j_reg);
+
+                // The cells of a row are contiguous only in row-major
+                // order.
+                if (_caCellTileY == 1)
+                {
+                    memcpy(&_buff[row + i_start], &src._buff[row + i_start], row_size);
+                    continue;
+                }
+
+                for (Unsigned i_reg = i_start; i_reg < i_start + box.w(); ++i_reg)
+                {
+                    const Unsigned i = row + _caCellCol(_cagrid, i_reg);
+                    _buff[i] = src._buff[i];
+                }
+            }
+        }
     }
 
 
@@ -325,16 +436,26 @@ namespace CA {
         if (box.w() > mem_x_size || box.h() > mem_y_size)
             return;
 
+#ifdef CA2D_OPENMP
+        // The size of the chunk for each thread.
+        Unsigned chunksize = box.h() / omp_get_num_procs() + 1;
+#endif
+
         // Cycle through the region of cells to read. i_reg and j_reg are
         // the region indices. i_mem and j_mem are the memory indices. The
-        // _border value is used to avoid reading the border.
-        for (Unsigned j_reg = box.y() + _cagrid.cb_border, j_mem = 0;
-            j_reg < box.h() + box.y() + _cagrid.cb_border; ++j_reg, ++j_mem)
+        // _border value is used to avoid reading the border. The rows
+        // are independent and j_mem is computed from j_reg.
+#ifdef CA2D_OPENMP
+#pragma omp parallel for schedule(static,chunksize)
+#endif
+        for (int j_mem = 0; j_mem < static_cast<int>(box.h()); ++j_mem)
         {
+            const Unsigned row = _caCellRow(_cagrid, box.y() + _cagrid.cb_border + j_mem);
+
             for (Unsigned i_reg = box.x() + _cagrid.cb_border, i_mem = 0;
                 i_reg < box.w() + box.x() + _cagrid.cb_border; ++i_reg, ++i_mem)
             {
-                mem[j_mem * mem_x_size + i_mem] = _buff[j_reg *_cagrid.cb_x_size + i_reg];
+                mem[j_mem * mem_x_size + i_mem] = _buff[row + _caCellCol(_cagrid, i_reg)];
             }
         }
     }
@@ -373,15 +494,24 @@ namespace CA {
             //std::cout << "x_scale: " << x_scale << std::endl;
             //std::cout << "y_scale: " << y_scale << std::endl;
 
+#ifdef CA2D_OPENMP
+            // The size of the chunk for each thread.
+            Unsigned chunksize = box.h() / omp_get_num_procs() + 1;
+#endif
+
             // Cycle through the region of cells to read. i_reg and j_reg are
             // the region indices. i_mem and j_mem are the memory indices. The
             // _border value is used to avoid reading the border.
-            // i_box and j_box, are the region indicies within the box locally
-            for (Unsigned j_reg = box.y() + _cagrid.cb_border, j_mem = 0, j_box = 0;
-                j_reg < box.h() + box.y() + _cagrid.cb_border; ++j_reg, ++j_box)
+            // i_box and j_box, are the region indicies within the box
+            // locally. The rows are independent and j_mem is computed
+            // from j_box.
+#ifdef CA2D_OPENMP
+#pragma omp parallel for schedule(static,chunksize)
+#endif
+            for (int j_box = 0; j_box < static_cast<int>(box.h()); ++j_box)
             {
-                if (j_box % y_scale == 0 && j_box != 0)
-                    ++j_mem;
+                const Unsigned row = _caCellRow(_cagrid, box.y() + _cagrid.cb_border + j_box);
+                const Unsigned j_mem = j_box / y_scale;
 
                 for (Unsigned i_reg = box.x() + _cagrid.cb_border, i_mem = 0, i_box = 0;
                     i_reg < box.w() + box.x() + _cagrid.cb_border; ++i_reg, ++i_box)
@@ -390,22 +520,32 @@ namespace CA {
                     if (i_box % x_scale == 0 && i_box != 0)
                         ++i_mem;
 
-                    _buff[j_reg * _cagrid.cb_x_size + i_reg] = mem[j_mem * mem_x_size + i_mem];
+                    _buff[row + _caCellCol(_cagrid, i_reg)] = mem[j_mem * mem_x_size + i_mem];
                 }
             }
         }
         else {
+#ifdef CA2D_OPENMP
+            // The size of the chunk for each thread.
+            Unsigned chunksize = box.h() / omp_get_num_procs() + 1;
+#endif
+
             // Cycle through the region of cells to read. i_reg and j_reg are
             // the region indices. i_mem and j_mem are the memory indices. The
-            // _border value is used to avoid reading the border.
-            for (Unsigned j_reg = box.y() + _cagrid.cb_border, j_mem = 0;
-                j_reg < box.h() + box.y() + _cagrid.cb_border; ++j_reg, ++j_mem)
+            // _border value is used to avoid reading the border. The rows
+            // are independent and j_mem is computed from j_reg.
+#ifdef CA2D_OPENMP
+#pragma omp parallel for schedule(static,chunksize)
+#endif
+            for (int j_mem = 0; j_mem < static_cast<int>(box.h()); ++j_mem)
             {
+                const Unsigned row = _caCellRow(_cagrid, box.y() + _cagrid.cb_border + j_mem);
+
                 for (Unsigned i_reg = box.x() + _cagrid.cb_border, i_mem = 0;
                     i_reg < box.w() + box.x() + _cagrid.cb_border; ++i_reg, ++i_mem)
 
                 {
-                    _buff[j_reg * _cagrid.cb_x_size + i_reg] = mem[j_mem * mem_x_size + i_mem];
+                    _buff[row + _caCellCol(_cagrid, i_reg)] = mem[j_mem * mem_x_size + i_mem];
                 }
             }
         }
@@ -429,8 +569,18 @@ namespace CA {
         unsigned int magic = CAAPI_2D_MAGIC;
         file.write(reinterpret_cast<char*>(&magic), sizeof(unsigned int));
 
-        // Write the file in a go!
-        file.write(reinterpret_cast<char*>(_buff), _buff_size);
+        // Write the file row by row in row-major order without the
+        // padding of the row pitch, so the file does not depend on the
+        // pitch and on the tiles.
+        std::vector<T> line(_cagrid.cb_x_size);
+        for (Unsigned j = 0; j < _cagrid.cb_y_size && file.good(); ++j)
+        {
+            const Unsigned row = _caCellRow(_cagrid, j);
+            for (Unsigned i = 0; i < _cagrid.cb_x_size; ++i)
+                line[i] = _buff[row + _caCellCol(_cagrid, i)];
+
+            file.write(reinterpret_cast<char*>(&line[0]), _cagrid.cb_x_size * sizeof(T));
+        }
         bool ret = file.good();
 
         return ret;
@@ -457,9 +607,21 @@ namespace CA {
         if (magic != CAAPI_2D_MAGIC)
             return false;
 
-        // Read the file in a go!
-        file.read(reinterpret_cast<char*>(_buff), _buff_size);
-        bool ret = file.good() && (_buff_size == file.gcount()) && (file.peek() == EOF);
+        // Read the file row by row in row-major order, each row is
+        // placed at the row pitch and in the tiles of the buffer.
+        const std::streamsize row_size = _cagrid.cb_x_size * sizeof(T);
+        std::vector<T> line(_cagrid.cb_x_size);
+        bool ret = true;
+        for (Unsigned j = 0; j < _cagrid.cb_y_size && ret; ++j)
+        {
+            file.read(reinterpret_cast<char*>(&line[0]), row_size);
+            ret = file.good() && (row_size == file.gcount());
+
+            const Unsigned row = _caCellRow(_cagrid, j);
+            for (Unsigned i = 0; i < _cagrid.cb_x_size && ret; ++i)
+                _buff[row + _caCellCol(_cagrid, i)] = line[i];
+        }
+        ret = ret && (file.peek() == EOF);
 
         // If the operation was succesful and the file need to be removed,
         // then delete the file.
@@ -522,7 +684,7 @@ namespace CA {
             Unsigned x = (*i_p).x() + _cagrid.cb_border;
             Unsigned y = (*i_p).y() + _cagrid.cb_border;
 
-            mem[i_mem] = _buff[y*_cagrid.cb_x_size + x];
+            mem[i_mem] = _buff[_caCellRow(_cagrid, y) + _caCellCol(_cagrid, x)];
 
             i_mem++;
         }
@@ -548,7 +710,7 @@ namespace CA {
             Unsigned x = (*i_p).x() + _cagrid.cb_border;
             Unsigned y = (*i_p).y() + _cagrid.cb_border;
 
-            _buff[y*_cagrid.cb_x_size + x] = mem[i_mem];
+            _buff[_caCellRow(_cagrid, y) + _caCellCol(_cagrid, x)] = mem[i_mem];
 
             i_mem++;
         }
@@ -621,9 +783,11 @@ namespace CA {
 #pragma omp for schedule(static,chunksize)
                 for (int j_reg = static_cast<int>(box.y() + _cagrid.cb_border); j_reg < box.h() + box.y() + _cagrid.cb_border; ++j_reg)
                 {
+                    const Unsigned row = _caCellRow(_cagrid, j_reg);
+
                     for (int i_reg = static_cast<int>(box.x() + _cagrid.cb_border); i_reg < box.w() + box.x() + _cagrid.cb_border; ++i_reg)
                     {
-                        T value = _buff[j_reg *_cagrid.cb_x_size + i_reg];
+                        T value = _buff[row + _caCellCol(_cagrid, i_reg)];
 
                         op(threadvalue, value);
                     }
@@ -639,9 +803,11 @@ namespace CA {
             // is used to avoid writing to the border.
             for (Unsigned j_reg = box.y() + _cagrid.cb_border; j_reg < box.h() + box.y() + _cagrid.cb_border; ++j_reg)
             {
+                const Unsigned row = _caCellRow(_cagrid, j_reg);
+
                 for (Unsigned i_reg = box.x() + _cagrid.cb_border; i_reg < box.w() + box.x() + _cagrid.cb_border; ++i_reg)
                 {
-                    T value = _buff[j_reg *_cagrid.cb_x_size + i_reg];
+                    T value = _buff[row + _caCellCol(_cagrid, i_reg)];
 
                     op(result, value);
                 }
@@ -665,13 +831,25 @@ namespace CA {
         {
             Box box(*ibox);
 
+#ifdef CA2D_OPENMP
+            // The size of the chunk for each thread.
+            Unsigned chunksize = box.h() / omp_get_num_procs() + 1;
+
+            // Cycle through the region of cells to read. The
+            // _border value is used to avoid writing the border.
+#pragma omp parallel for schedule(static,chunksize)
+            for (int j_reg = static_cast<int>(box.y() + _cagrid.cb_border); j_reg < box.h() + box.y() + _cagrid.cb_border; ++j_reg)
+#else
             // Cycle through the region of cells to read. The
             // _border value is used to avoid writing the border.
             for (Unsigned j_reg = box.y() + _cagrid.cb_border; j_reg < box.h() + box.y() + _cagrid.cb_border; ++j_reg)
+#endif
             {
+                const Unsigned row = _caCellRow(_cagrid, j_reg);
+
                 for (Unsigned i_reg = box.x() + _cagrid.cb_border; i_reg < box.w() + box.x() + _cagrid.cb_border; ++i_reg)
                 {
-                    _buff[j_reg *_cagrid.cb_x_size + i_reg] = value;
+                    _buff[row + _caCellCol(_cagrid, i_reg)] = value;
                 }
             }
         }
@@ -713,10 +891,10 @@ namespace CA {
     inline void CellBuff<T>::bordersValueOp(const Borders& bound, T value, Op op)
     {
         // Compute base index
-        const Unsigned top = 0;
-        const Unsigned bottom = (_cagrid.y_size + _cagrid.cb_border) * _cagrid.cb_x_size;
-        const Unsigned left = 0;
-        const Unsigned right = _cagrid.x_size + _cagrid.cb_border;
+        const Unsigned top = _caCellRow(_cagrid, 0);
+        const Unsigned bottom = _caCellRow(_cagrid, _cagrid.y_size + _cagrid.cb_border);
+        const Unsigned left = _caCellCol(_cagrid, 0);
+        const Unsigned right = _caCellCol(_cagrid, _cagrid.x_size + _cagrid.cb_border);
 
         // Cycle through the segments
         for (int s = 0; s < bound.numSegments(); ++s)
@@ -734,7 +912,7 @@ namespace CA {
 
                 // Set the value.
                 for (Unsigned i = seg.start + _cagrid.cb_border; i < seg.stop + _cagrid.cb_border; ++i)
-                    op(_buff[top + i], value);
+                    op(_buff[top + _caCellCol(_cagrid, i)], value);
                 break;
 
             case Bottom:
@@ -744,7 +922,7 @@ namespace CA {
 
                 // Set the value.	
                 for (Unsigned i = seg.start + _cagrid.cb_border; i < seg.stop + _cagrid.cb_border; ++i)
-                    op(_buff[bottom + i], value);
+                    op(_buff[bottom + _caCellCol(_cagrid, i)], value);
                 break;
 
             case Left:
@@ -754,7 +932,7 @@ namespace CA {
 
                 // Set the value.	
                 for (Unsigned j = seg.start + _cagrid.cb_border; j < seg.stop + _cagrid.cb_border; ++j)
-                    op(_buff[j*_cagrid.cb_x_size + left], value);
+                    op(_buff[_caCellRow(_cagrid, j) + left], value);
                 break;
 
             case Right:
@@ -764,7 +942,7 @@ namespace CA {
 
                 // Set the value.	
                 for (Unsigned j = seg.start + _cagrid.cb_border; j < seg.stop + _cagrid.cb_border; ++j)
-                    op(_buff[j*_cagrid.cb_x_size + right], value);
+                    op(_buff[_caCellRow(_cagrid, j) + right], value);
                 break;
             }
         }
@@ -802,13 +980,16 @@ namespace CA {
     inline void CellBuff<T>::bordersShift(const Borders& bound)
     {
         // Compute base index
-        const Unsigned top = 0;
-        const Unsigned bottom = (_cagrid.y_size + _cagrid.cb_border) * _cagrid.cb_x_size;
-        const Unsigned left = 0;
-        const Unsigned right = _cagrid.x_size + _cagrid.cb_border;
+        const Unsigned top = _caCellRow(_cagrid, 0);
+        const Unsigned bottom = _caCellRow(_cagrid, _cagrid.y_size + _cagrid.cb_border);
+        const Unsigned left = _caCellCol(_cagrid, 0);
+        const Unsigned right = _caCellCol(_cagrid, _cagrid.x_size + _cagrid.cb_border);
 
-        const Unsigned xone = 1;
-        const Unsigned yone = _cagrid.cb_x_size;
+        // The index of the rows and of the columns next to the borders.
+        const Unsigned top_in = _caCellRow(_cagrid, 1);
+        const Unsigned bottom_in = _caCellRow(_cagrid, _cagrid.y_size + _cagrid.cb_border - 1);
+        const Unsigned left_in = _caCellCol(_cagrid, 1);
+        const Unsigned right_in = _caCellCol(_cagrid, _cagrid.x_size + _cagrid.cb_border - 1);
 
         // Cycle through the segments
         for (int s = 0; s < bound.numSegments(); ++s)
@@ -826,7 +1007,7 @@ namespace CA {
 
                 // Set the value.
                 for (Unsigned i = seg.start + _cagrid.cb_border; i < seg.stop + _cagrid.cb_border; ++i)
-                    _buff[top + i] = _buff[top + yone + i];
+                    _buff[top + _caCellCol(_cagrid, i)] = _buff[top_in + _caCellCol(_cagrid, i)];
                 break;
 
             case Bottom:
@@ -836,7 +1017,7 @@ namespace CA {
 
                 // Set the value.	
                 for (Unsigned i = seg.start + _cagrid.cb_border; i < seg.stop + _cagrid.cb_border; ++i)
-                    _buff[bottom + i] = _buff[bottom - yone + i];
+                    _buff[bottom + _caCellCol(_cagrid, i)] = _buff[bottom_in + _caCellCol(_cagrid, i)];
                 break;
 
             case Left:
@@ -846,7 +1027,7 @@ namespace CA {
 
                 // Set the value.	
                 for (Unsigned j = seg.start + _cagrid.cb_border; j < seg.stop + _cagrid.cb_border; ++j)
-                    _buff[j*_cagrid.cb_x_size + left] = _buff[j*_cagrid.cb_x_size + left + xone];
+                    _buff[_caCellRow(_cagrid, j) + left] = _buff[_caCellRow(_cagrid, j) + left_in];
                 break;
 
             case Right:
@@ -856,7 +1037,7 @@ namespace CA {
 
                 // Set the value.	
                 for (Unsigned j = seg.start + _cagrid.cb_border; j < seg.stop + _cagrid.cb_border; ++j)
-                    _buff[j*_cagrid.cb_x_size + right] = _buff[j*_cagrid.cb_x_size + right - xone];
+                    _buff[_caCellRow(_cagrid, j) + right] = _buff[_caCellRow(_cagrid, j) + right_in];
                 break;
             }
         }
@@ -871,19 +1052,19 @@ namespace CA {
             switch (corner)
             {
             case TopLeft:
-                _buff[top + left] = _buff[top + yone + left + xone];
+                _buff[top + left] = _buff[top_in + left_in];
                 break;
 
             case TopRight:
-                _buff[top + right] = _buff[top + yone + right - xone];
+                _buff[top + right] = _buff[top_in + right_in];
                 break;
 
             case BottomLeft:
-                _buff[bottom + left] = _buff[bottom - yone + left + xone];;
+                _buff[bottom + left] = _buff[bottom_in + left_in];
                 break;
 
             case BottomRight:
-                _buff[bottom + right] = _buff[bottom - yone + right - xone];;
+                _buff[bottom + right] = _buff[bottom_in + right_in];
                 break;
             }
         }
@@ -898,7 +1079,7 @@ namespace CA {
         {
             for (Unsigned i_reg = 0; i_reg < _cagrid.cb_x_size; ++i_reg)
             {
-                out << _buff[j_reg *_cagrid.cb_x_size + i_reg];
+                out << _buff[_caCellRow(_cagrid, j_reg) + _caCellCol(_cagrid, i_reg)];
                 out << x_sep;
             }
             out << y_sep;
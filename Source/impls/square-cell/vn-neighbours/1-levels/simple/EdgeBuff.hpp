@@ -162,6 +162,14 @@ namespace CA {
         template<typename Op>
         void sequentialOperationOp(const BoxList& bl, std::vector<T>& values, Op op) const;
 
+        //! Write into the file the given rows of a sub-buffer starting at
+        //! the given element.
+        bool writeRows(std::ofstream& file, Unsigned start, Unsigned x_size, Unsigned pitch, Unsigned y_size) const;
+
+        //! Read from the file the given rows of a sub-buffer starting at
+        //! the given element.
+        bool readRows(std::ifstream& file, Unsigned start, Unsigned x_size, Unsigned pitch, Unsigned y_size);
+
     private:
 
         //! The reference to the grid.
@@ -212,19 +220,32 @@ namespace CA {
         _buff_size(),
         _buff()
     {
-        _ns_buff_num = _cagrid.eb_ns_x_size * _cagrid.eb_ns_y_size;
-        _we_buff_num = _cagrid.eb_we_x_size * _cagrid.eb_we_y_size;
+        _ns_buff_num = _cagrid.eb_ns_x_pitch * _cagrid.eb_ns_y_size;
+        _we_buff_num = _cagrid.eb_we_x_pitch * _cagrid.eb_we_y_size;
 
         _buff_num = _ns_buff_num + _we_buff_num;
 
 #ifdef CA2D_MOORE
         // Add the extra size for the two extra sub-buffer.
-        _diag_buff_num = _cagrid.eb_diag_x_size * _cagrid.eb_diag_y_size;
+        _diag_buff_num = _cagrid.eb_diag_x_pitch * _cagrid.eb_diag_y_size;
         _buff_num += _diag_buff_num * 2;
 #endif
 
         _buff_size = _buff_num * sizeof(T);
-        _buff = static_cast<T*>(calloc(_buff_num, sizeof(T)));
+
+        // Each row of a sub-buffer starts at the row pitch. The pages of
+        // each sub-buffer are first touched by the threads that use them
+        // in NUMA aware mode.
+        _buff = static_cast<T*>(_grid.allocBuffer(_buff_size));
+        if (_buff)
+        {
+            _grid.touchRows(&_buff[0], _cagrid.eb_ns_x_pitch * sizeof(T), _cagrid.eb_ns_y_size);
+            _grid.touchRows(&_buff[_cagrid.eb_we_start], _cagrid.eb_we_x_pitch * sizeof(T), _cagrid.eb_we_y_size);
+#ifdef CA2D_MOORE
+            _grid.touchRows(&_buff[_cagrid.eb_nwse_start], _cagrid.eb_diag_x_pitch * sizeof(T), _cagrid.eb_diag_y_size);
+            _grid.touchRows(&_buff[_cagrid.eb_nesw_start], _cagrid.eb_diag_x_pitch * sizeof(T), _cagrid.eb_diag_y_size);
+#endif
+        }
     }
 
 
@@ -232,7 +253,7 @@ namespace CA {
     inline EdgeBuff<T>::~EdgeBuff()
     {
         if (_buff)
-            free(_buff);
+            Grid::freeBuffer(_buff);
         _buff = 0;
     }
 
@@ -256,7 +277,20 @@ namespace CA {
     template<typename T>
     inline void EdgeBuff<T>::clear(const T& value)
     {
+#ifdef CA2D_OPENMP
+#pragma omp parallel default(shared)
+        {
+            // Each thread clears a contiguous chunk of the buffer.
+            const size_t nthreads = omp_get_num_threads();
+            const size_t tid = omp_get_thread_num();
+            const size_t start = _buff_num * tid / nthreads;
+            const size_t stop = _buff_num * (tid + 1) / nthreads;
+
+            std::fill(&_buff[start], &_buff[stop], value);
+        }
+#else
         std::fill(&_buff[0], &_buff[_buff_num], value);
+#endif
     }
 
 
@@ -272,8 +306,21 @@ namespace CA {
         if (!_buff || !src._buff)
             return;
 
+#ifdef CA2D_OPENMP
+#pragma omp parallel default(shared)
+        {
+            // Each thread copies a contiguous chunk of the buffer.
+            const size_t nthreads = omp_get_num_threads();
+            const size_t tid = omp_get_thread_num();
+            const size_t start = _buff_num * tid / nthreads;
+            const size_t stop = _buff_num * (tid + 1) / nthreads;
+
+            memcpy(&_buff[start], &src._buff[start], (stop - start) * sizeof(T));
+        }
+#else
         // Copy the momory.
         memcpy(_buff, src._buff, _buff_size);
+#endif
     }
 
 
@@ -294,14 +341,45 @@ namespace CA {
         unsigned int magic = CAAPI_2D_MAGIC;
         file.write(reinterpret_cast<char*>(&magic), sizeof(unsigned int));
 
-        // Write the file in a go!
-        file.write(reinterpret_cast<char*>(_buff), _buff_size);
-        bool ret = file.good();
+        // Write the sub-buffers row by row without the padding of the
+        // row pitch, so the file does not depend on it.
+        bool ret = writeRows(file, 0, _cagrid.eb_ns_x_size, _cagrid.eb_ns_x_pitch, _cagrid.eb_ns_y_size) &&
+            writeRows(file, _cagrid.eb_we_start, _cagrid.eb_we_x_size, _cagrid.eb_we_x_pitch, _cagrid.eb_we_y_size);
+#ifdef CA2D_MOORE
+        ret = ret && writeRows(file, _cagrid.eb_nwse_start, _cagrid.eb_diag_x_size, _cagrid.eb_diag_x_pitch, _cagrid.eb_diag_y_size) &&
+            writeRows(file, _cagrid.eb_nesw_start, _cagrid.eb_diag_x_size, _cagrid.eb_diag_x_pitch, _cagrid.eb_diag_y_size);
+#endif
 
         return ret;
     }
 
 
+    template<typename T>
+    inline bool EdgeBuff<T>::writeRows(std::ofstream& file, Unsigned start, Unsigned x_size, Unsigned pitch, Unsigned y_size) const
+    {
+        for (Unsigned j = 0; j < y_size && file.good(); ++j)
+            file.write(reinterpret_cast<const char*>(&_buff[start + j * pitch]), x_size * sizeof(T));
+
+        return file.good();
+    }
+
+
+    template<typename T>
+    inline bool EdgeBuff<T>::readRows(std::ifstream& file, Unsigned start, Unsigned x_size, Unsigned pitch, Unsigned y_size)
+    {
+        const std::streamsize row_size = x_size * sizeof(T);
+
+        for (Unsigned j = 0; j < y_size; ++j)
+        {
+            file.read(reinterpret_cast<char*>(&_buff[start + j * pitch]), row_size);
+            if (!file.good() || row_size != file.gcount())
+                return false;
+        }
+
+        return true;
+    }
+
+
     template<typename T>
     inline bool EdgeBuff<T>::loadData(const std::string& mainid, const std::string& subid, bool remove)
     {
@@ -322,9 +400,15 @@ namespace CA {
         if (magic != CAAPI_2D_MAGIC)
             return false;
 
-        // Read the file in a go!
-        file.read(reinterpret_cast<char*>(_buff), _buff_size);
-        bool ret = file.good() && (_buff_size == file.gcount()) && (file.peek() == EOF);
+        // Read the sub-buffers row by row, each row starts at the row
+        // pitch.
+        bool ret = readRows(file, 0, _cagrid.eb_ns_x_size, _cagrid.eb_ns_x_pitch, _cagrid.eb_ns_y_size) &&
+            readRows(file, _cagrid.eb_we_start, _cagrid.eb_we_x_size, _cagrid.eb_we_x_pitch, _cagrid.eb_we_y_size);
+#ifdef CA2D_MOORE
+        ret = ret && readRows(file, _cagrid.eb_nwse_start, _cagrid.eb_diag_x_size, _cagrid.eb_diag_x_pitch, _cagrid.eb_diag_y_size) &&
+            readRows(file, _cagrid.eb_nesw_start, _cagrid.eb_diag_x_size, _cagrid.eb_diag_x_pitch, _cagrid.eb_diag_y_size);
+#endif
+        ret = ret && (file.peek() == EOF);
 
         // If the operation was succesful and the file need to be removed,
         // then delete the file.
@@ -455,7 +539,7 @@ namespace CA {
                 {
                     for (int i = box.x(); i < box.w() + box.x(); ++i) // No X border for N/S buffer
                     {
-                        T buffvalue = _buff[j*_cagrid.eb_ns_x_size + i];
+                        T buffvalue = _buff[j*_cagrid.eb_ns_x_pitch + i];
 
                         op(threadvalues[idx_ns_1], buffvalue);
                         op(threadvalues[idx_ns_2], buffvalue);
@@ -468,7 +552,7 @@ namespace CA {
                 {
                     for (int i = box.x() + _cagrid.eb_we_x_border; i < box.w() + box.x() + _cagrid.eb_we_x_border + 1; ++i)
                     {
-                        T buffvalue = _buff[j*_cagrid.eb_we_x_size + i + _cagrid.eb_we_start];
+                        T buffvalue = _buff[j*_cagrid.eb_we_x_pitch + i + _cagrid.eb_we_start];
 
                         op(threadvalues[idx_we_1], buffvalue);
                         //op(threadvalues[idx_ns_2], buffvalue);
@@ -483,8 +567,8 @@ namespace CA {
                 {
                     for (Unsigned i = box.x() + _cagrid.eb_diag_x_border; i < box.w() + box.x() + _cagrid.eb_diag_x_border + 1; ++i)
                     {
-                        T buffvalue_nwse = _buff[j*_cagrid.eb_diag_x_size + i + _cagrid.eb_nwse_start];
-                        T buffvalue_nesw = _buff[j*_cagrid.eb_diag_x_size + i + _cagrid.eb_nesw_start];
+                        T buffvalue_nwse = _buff[j*_cagrid.eb_diag_x_pitch + i + _cagrid.eb_nwse_start];
+                        T buffvalue_nesw = _buff[j*_cagrid.eb_diag_x_pitch + i + _cagrid.eb_nesw_start];
                         op(threadvalues[4], buffvalue_nwse);
                         op(threadvalues[8], buffvalue_nwse);
                         op(threadvalues[2], buffvalue_nesw);
@@ -515,7 +599,7 @@ namespace CA {
             {
                 for (Unsigned i = box.x(); i < box.w() + box.x(); ++i) // No X border for N/S buffer
                 {
-                    T buffvalue = _buff[j*_cagrid.eb_ns_x_size + i];
+                    T buffvalue = _buff[j*_cagrid.eb_ns_x_pitch + i];
 
                     op(results[idx_ns_1], buffvalue);
                     op(results[idx_ns_2], buffvalue);
@@ -527,7 +611,7 @@ namespace CA {
             {
                 for (Unsigned i = box.x() + _cagrid.eb_we_x_border; i < box.w() + box.x() + _cagrid.eb_we_x_border + 1; ++i)
                 {
-                    T buffvalue = _buff[j*_cagrid.eb_we_x_size + i + _cagrid.eb_we_start];
+                    T buffvalue = _buff[j*_cagrid.eb_we_x_pitch + i + _cagrid.eb_we_start];
 
                     op(results[idx_we_1], buffvalue);
                     op(results[idx_we_2], buffvalue);
@@ -540,8 +624,8 @@ namespace CA {
             {
                 for (Unsigned i = box.x() + _cagrid.eb_diag_x_border; i < box.w() + box.x() + _cagrid.eb_diag_x_border + 1; ++i)
                 {
-                    T buffvalue_nwse = _buff[j*_cagrid.eb_diag_x_size + i + _cagrid.eb_nwse_start];
-                    T buffvalue_nesw = _buff[j*_cagrid.eb_diag_x_size + i + _cagrid.eb_nesw_start];
+                    T buffvalue_nwse = _buff[j*_cagrid.eb_diag_x_pitch + i + _cagrid.eb_nwse_start];
+                    T buffvalue_nesw = _buff[j*_cagrid.eb_diag_x_pitch + i + _cagrid.eb_nesw_start];
                     op(results[4], buffvalue_nwse);
                     op(results[8], buffvalue_nwse);
                     op(results[2], buffvalue_nesw);
@@ -570,35 +654,62 @@ namespace CA {
         {
             Box box(*ibox);
 
+#ifdef CA2D_OPENMP
+            // The size of the chunk for each thread.
+            Unsigned chunksize = box.h() / omp_get_num_procs() + 1;
+
+#pragma omp parallel default(shared)
+            {
+#endif
+
             // Min north/south edges.
+#ifdef CA2D_OPENMP
+#pragma omp for schedule(static,chunksize) nowait
+            for (int j = static_cast<int>(box.y() + _cagrid.eb_ns_y_border); j < box.h() + box.y() + _cagrid.eb_ns_y_border + 1; ++j)
+#else
             for (Unsigned j = box.y() + _cagrid.eb_ns_y_border; j < box.h() + box.y() + _cagrid.eb_ns_y_border + 1; ++j)
+#endif
             {
                 for (Unsigned i = box.x(); i < box.w() + box.x(); ++i) // No X border for N/S buffer
                 {
-                    _buff[j*_cagrid.eb_ns_x_size + i] = value;
+                    _buff[j*_cagrid.eb_ns_x_pitch + i] = value;
                 }
             }
 
             // Min west/east edges.
+#ifdef CA2D_OPENMP
+#pragma omp for schedule(static,chunksize) nowait
+            for (int j = static_cast<int>(box.y()); j < box.h() + box.y(); ++j) // No Y border for W/E buffer
+#else
             for (Unsigned j = box.y(); j < box.h() + box.y(); ++j) // No Y border for W/E buffer
+#endif
             {
                 for (Unsigned i = box.x() + _cagrid.eb_we_x_border; i < box.w() + box.x() + _cagrid.eb_we_x_border + 1; ++i)
                 {
-                    _buff[j*_cagrid.eb_we_x_size + i + _cagrid.eb_we_start] = value;
+                    _buff[j*_cagrid.eb_we_x_pitch + i + _cagrid.eb_we_start] = value;
                 }
             }
 
 #ifdef CA2D_MOORE
             // NWSE and NESW edges
+#ifdef CA2D_OPENMP
+#pragma omp for schedule(static,chunksize) nowait
+            for (int j = static_cast<int>(box.y() + _cagrid.eb_diag_y_border); j < box.h() + box.y() + _cagrid.eb_diag_y_border + 1; ++j)
+#else
             for (Unsigned j = box.y() + _cagrid.eb_diag_y_border; j < box.h() + box.y() + _cagrid.eb_diag_y_border + 1; ++j)
+#endif
             {
                 for (Unsigned i = box.x() + _cagrid.eb_diag_x_border; i < box.w() + box.x() + _cagrid.eb_diag_x_border + 1; ++i)
                 {
-                    _buff[j*_cagrid.eb_diag_x_size + i + _cagrid.eb_nwse_start] = value;
-                    _buff[j*_cagrid.eb_diag_x_size + i + _cagrid.eb_nesw_start] = value;
+                    _buff[j*_cagrid.eb_diag_x_pitch + i + _cagrid.eb_nwse_start] = value;
+                    _buff[j*_cagrid.eb_diag_x_pitch + i + _cagrid.eb_nesw_start] = value;
                 }
             }
 #endif
+
+#ifdef CA2D_OPENMP
+            } // end parallel.
+#endif
         }
     }
 
@@ -610,7 +721,7 @@ namespace CA {
         {
             for (Unsigned i_reg = 0; i_reg < _cagrid.eb_ns_x_size; ++i_reg)
             {
-                out << _buff[j_reg *_cagrid.eb_ns_x_size + i_reg];
+                out << _buff[j_reg *_cagrid.eb_ns_x_pitch + i_reg];
                 out << x_sep;
             }
             out << y_sep;
@@ -620,7 +731,7 @@ namespace CA {
         {
             for (Unsigned i_reg = 0; i_reg < _cagrid.eb_we_x_size; ++i_reg)
             {
-                out << _buff[j_reg *_cagrid.eb_we_x_size + i_reg + _cagrid.eb_we_start];
+                out << _buff[j_reg *_cagrid.eb_we_x_pitch + i_reg + _cagrid.eb_we_start];
                 out << x_sep;
             }
             out << y_sep;
@@ -631,7 +742,7 @@ namespace CA {
         {
             for (Unsigned i_reg = 0; i_reg < _cagrid.eb_diag_x_size; ++i_reg)
             {
-                out << _buff[j_reg *_cagrid.eb_diag_x_size + i_reg + _cagrid.eb_nwse_start];
+                out << _buff[j_reg *_cagrid.eb_diag_x_pitch + i_reg + _cagrid.eb_nwse_start];
                 out << x_sep;
             }
             out << y_sep;
@@ -642,7 +753,7 @@ namespace CA {
         {
             for (Unsigned i_reg = 0; i_reg < _cagrid.eb_diag_x_size; ++i_reg)
             {
-                out << _buff[j_reg *_cagrid.eb_diag_x_size + i_reg + _cagrid.eb_nesw_start];
+                out << _buff[j_reg *_cagrid.eb_diag_x_pitch + i_reg + _cagrid.eb_nesw_start];
                 out << x_sep;
             }
             out << y_sep;
@@ -36,6 +36,18 @@ THE SOFTWARE.
 
 
 #include"caapi2D.hpp"
+#include<cstring>
+#include<vector>
+#include<algorithm>
+#include<typeinfo>
+
+#if defined CA2D_OPENMP && defined __linux__
+#include<sched.h>
+#endif
+
+#if defined __linux__
+#include<sys/mman.h>
+#endif
 
 
 namespace CA {
@@ -135,6 +147,157 @@ namespace CA {
         //! Return the data directory.
         std::string dataDir() const;
 
+        //! If set to true, the CA functions are executed row by row
+        //! with the buffers and the grid values hoisted outside the
+        //! loop of the cells of a row. \attention This can be set also
+        //! with the "row-streaming" option.
+        void setRowStreaming(bool rows);
+
+        //! Return true if the CA functions are executed row by row.
+        bool rowStreaming() const;
+
+        //! Set the NUMA aware mode. The pages of the buffers created
+        //! after this call are first touched by the threads using the
+        //! same static partition of the rows of the execution of the CA
+        //! functions, and the threads are pinned to the cores (only on
+        //! Linux). \attention This can be set also with the "numa" option.
+        void setNuma(bool numa);
+
+        //! Return true if the buffers are allocated in NUMA aware mode.
+        bool numa() const;
+
+        //! Set to zero the given rows of a buffer. In NUMA aware mode
+        //! each row is set by the thread that executes it with the
+        //! static partition of the CA functions.
+        void touchRows(void* mem, size_t row_size, Unsigned rows) const;
+
+        //! Set the row skew mode. The row pitch of the buffers is
+        //! increased by a cache line when it is a multiple of 1024
+        //! cells and the start of each new buffer is moved by a
+        //! different number of cache lines, to avoid the cache set
+        //! aliasing between the rows and between the buffers.
+        //! \attention This must be set before the buffers are created.
+        //! \attention This can be set also with the "row-skew" option.
+        void setRowSkew(bool skew);
+
+        //! Return true if the rows and the buffers are skewed.
+        bool rowSkew() const;
+
+        //! Set the number of cell buffers in a cell record. The rows of
+        //! the given number of cell buffers with the same type, in the
+        //! order they are created, are interleaved in a single block of
+        //! memory, i.e. the row j of a buffer is followed by the row j of
+        //! the next one. Thus the buffers read together by a CA function
+        //! (e.g. the elevation and the water depth) share the hardware
+        //! prefetch streams and the pages. The row pitch of the cell
+        //! buffers (cb_x_pitch) is the number of buffers times the
+        //! pitch of a single row. One (the default) means a separate
+        //! block of memory for each buffer. The cell records are not
+        //! used when the cell buffers are stored by tiles (see
+        //! cellRows).
+        //! \attention This must be set before the buffers are created.
+        //! \attention This can be set also with the "cell-record" option.
+        void setCellRecord(Unsigned buffers);
+
+        //! Return the number of cell buffers in a cell record.
+        Unsigned cellRecord() const;
+
+        //! Return the number of rows of the memory of a cell buffer,
+        //! i.e. the Y size of a cell buffer rounded up to the rows of a
+        //! tile. The cell buffers are stored by tiles of 16 cells by
+        //! the number of rows set by the CAAPI_CELL_TILE option of
+        //! CMake (see _caCellRow), one row means the row-major order.
+        Unsigned cellRows() const;
+
+        //! Set the huge pages mode. The buffers larger than a huge page
+        //! (2 MiB) start at a huge page boundary and the system is asked
+        //! to back them with huge pages (only on Linux). Thus the rows
+        //! around a cell, e.g. the north and south neighbours, of a wide
+        //! grid share the same TLB entry.
+        //! \attention This must be set before the buffers are created.
+        //! \attention This can be set also with the "huge-pages" option.
+        void setHugePages(bool huge);
+
+        //! Return true if the buffers are allocated with huge pages.
+        bool hugePages() const;
+
+        //! Set the minimum number of cells of a TaskList executed by
+        //! the team of threads, a smaller list is executed by a single
+        //! thread. \attention This can be set also with the
+        //! "team-min-cells" option.
+        void setTeamMinCells(Unsigned cells);
+
+        //! Return the minimum number of cells of a TaskList executed by
+        //! the team of threads.
+        Unsigned teamMinCells() const;
+
+        //! Return the number of threads of the largest team that can
+        //! execute a CA function, i.e. the number of the per-thread
+        //! partial values of the alarms and of the reductions. It is the
+        //! number of threads of the next team, or the number of
+        //! processors if larger, bounded by the thread limit.
+        //! \attention The CA functions must not be executed by a larger
+        //! team, e.g. after setting more threads than processors.
+        static Unsigned maxThreads();
+
+        //! Allocate the memory of a buffer of the given size in bytes.
+        //! The start of the memory is aligned to the cache line, or to
+        //! the huge page in huge pages mode, and, in row skew mode,
+        //! moved by a number of cache lines. The memory is not
+        //! initialised.
+        //! \attention The memory must be released with freeBuffer.
+        void* allocBuffer(size_t size);
+
+        //! Release the memory allocated by allocBuffer.
+        static void freeBuffer(void* buff);
+
+        //! Allocate the memory of a cell buffer with elements of the
+        //! given type and size in bytes. The memory is set to zero. With
+        //! more than one buffer in a cell record, the buffer is the next
+        //! free slot of the current record of the same element type.
+        //! \attention The memory must be released with freeCellBuffer.
+        void* allocCellBuffer(size_t elem_size, const std::type_info& elem_type);
+
+        //! Release the memory allocated by allocCellBuffer. The memory of
+        //! a cell record is released with its last buffer.
+        void freeCellBuffer(void* buff);
+
+        //! The policies used to schedule the tiles of a box between
+        //! the threads. The stealing policy splits the tiles using their
+        //! cost in the previous execution of the same CA function and
+        //! then the idle threads steal tiles from the busy ones.
+        enum Schedule
+        {
+            Static = 0,
+            Dynamic,
+            Guided,
+            Stealing
+        };
+
+        //! Set the size of the tiles in which a box is split when the CA
+        //! functions are executed by multiple threads. A zero X size means
+        //! the width of the box and a zero Y size means one row.
+        //! \attention This can be set also with the "tile-x" and
+        //! "tile-y" options.
+        void setTiles(Unsigned tx, Unsigned ty);
+
+        //! Return the X size of the tiles.
+        Unsigned tileX() const;
+
+        //! Return the Y size of the tiles.
+        Unsigned tileY() const;
+
+        //! Set the policy used to schedule the tiles between the threads.
+        //! \attention This can be set also with the "tile-schedule" option.
+        void setSchedule(Schedule schedule);
+
+        //! Return the policy used to schedule the tiles between the threads.
+        Schedule schedule() const;
+
+        //! Return true if a box is split in tiles, i.e. the tile sizes
+        //! or the schedule policy were set.
+        bool tiled() const;
+
         //! Save the information of the Grid in the DataDir using an
         //! unique man id (filename/ grid type) and unique sub id (size of
         //! the grid / version of the grid).
@@ -167,6 +330,19 @@ namespace CA {
 
     protected:
 
+        //! Set the implementation specific options.
+        void manageOptions(const Options& options);
+
+        //! Set the row pitch of the cell and edge buffers and the
+        //! starting points of the sub-buffers of an edge buffer.
+        void setPitch();
+
+        //! Return the size of the part of _caGrid saved in the Grid
+        //! file, i.e. the fields up to print with the padding of a
+        //! structure that ends there. The row pitch is not saved, thus
+        //! the Grid file is the same of the versions without it.
+        static size_t fileSize();
+
     private:
 
         //! The CA_GRID used in the CA function.
@@ -175,12 +351,68 @@ namespace CA {
         //! String with the direcotry where the data is saved/loaded when
         //! using direct I/O.
         std::string _datadir;
+
+        //! If true the CA functions are executed row by row.
+        bool _row_streaming;
+
+        //! If true the buffers are first touched by the threads.
+        bool _numa;
+
+        //! If true the rows and the buffers are skewed.
+        bool _row_skew;
+
+        //! The number of buffers allocated, used to skew them.
+        Unsigned _buff_count;
+
+        //! The number of cell buffers in a cell record.
+        Unsigned _cell_record;
+
+        //! If true the large buffers are allocated with huge pages.
+        bool _huge_pages;
+
+        //! A block of memory with the interleaved rows of the cell
+        //! buffers with the same element type.
+        struct CellRecord
+        {
+            char*    mem;       //!< The memory of the record.
+            size_t   size;      //!< The size of the record in bytes.
+            size_t   elem_size; //!< The size of an element.
+            const std::type_info* elem_type; //!< The type of an element.
+            Unsigned slots;     //!< The number of slots used.
+            Unsigned live;      //!< The number of buffers not released.
+        };
+
+        //! The allocated cell records.
+        std::vector<CellRecord> _records;
+
+        //! The minimum number of cells executed by the team.
+        Unsigned _team_min_cells;
+
+        //! The size of the tiles.
+        Unsigned _tile_x;
+        Unsigned _tile_y;
+
+        //! The policy used to schedule the tiles.
+        Schedule _schedule;
     };
 
 
     /// ----- Inline implementation ----- ///
 
-    inline Grid::Grid()
+    inline Grid::Grid() :
+        _cagrid(),
+        _datadir(),
+        _row_streaming(false),
+        _numa(false),
+        _row_skew(false),
+        _buff_count(0),
+        _cell_record(1),
+        _huge_pages(false),
+        _records(),
+        _team_min_cells(16384),
+        _tile_x(0),
+        _tile_y(0),
+        _schedule(Static)
     {
     }
 
@@ -188,10 +420,21 @@ namespace CA {
         const Options& options) :
         _cagrid(),
 #if defined _WIN32 || defined __CYGWIN__   
-        _datadir(".\\")
+        _datadir(".\\"),
 #else
-        _datadir("./")
+        _datadir("./"),
 #endif
+        _row_streaming(false),
+        _numa(false),
+        _row_skew(false),
+        _buff_count(0),
+        _cell_record(1),
+        _huge_pages(false),
+        _records(),
+        _team_min_cells(16384),
+        _tile_x(0),
+        _tile_y(0),
+        _schedule(Static)
     {
         // This object initialise also the values needed by the
         // cell/edge/vertex buffers. These values are used to create these
@@ -249,9 +492,8 @@ namespace CA {
         _cagrid.eb_we_x_size = _cagrid.x_size + _cagrid.eb_we_x_border * 2 + 1;
         _cagrid.eb_we_y_size = _cagrid.y_size;
 
-        // Set the starting point for the two sub-buffers in the main buffer.
-        _cagrid.eb_ns_start = 0; // The north/South is first.
-        _cagrid.eb_we_start = _cagrid.eb_ns_x_size * _cagrid.eb_ns_y_size;
+        // The starting point for the two sub-buffers in the main buffer
+        // depends on the row pitch, which is set by setPitch.
 
 #ifdef CA2D_MOORE
         // Eventual Moore neighbourhood
@@ -269,14 +511,11 @@ namespace CA {
 
         _cagrid.eb_diag_x_size = _cagrid.x_size + _cagrid.eb_diag_x_border * 2 + 1; // Notice the +1.
         _cagrid.eb_diag_y_size = _cagrid.y_size + _cagrid.eb_diag_y_border * 2 + 1; // Notice the +1.
-
-        // Set the starting point for the two extra sub-buffers in the main buffer.
-        _cagrid.eb_nwse_start = _cagrid.eb_we_start + (_cagrid.eb_we_x_size * _cagrid.eb_we_y_size);
-        _cagrid.eb_nesw_start = _cagrid.eb_nwse_start + (_cagrid.eb_diag_x_size * _cagrid.eb_diag_y_size);
-
 #endif
 
         _cagrid.print = false;
+
+        manageOptions(options);
     }
 
 
@@ -284,7 +523,18 @@ namespace CA {
         const Options& options,
         int platform_index) :
         _cagrid(),
-        _datadir(datadir)
+        _datadir(datadir),
+        _row_streaming(false),
+        _numa(false),
+        _row_skew(false),
+        _buff_count(0),
+        _cell_record(1),
+        _huge_pages(false),
+        _records(),
+        _team_min_cells(16384),
+        _tile_x(0),
+        _tile_y(0),
+        _schedule(Static)
     {
         // Create the filename
         std::string filename = _datadir + mainid + "_" + subid + "_" + caImplShortName + ".GD";
@@ -303,20 +553,25 @@ namespace CA {
         if (magic != CAAPI_2D_MAGIC)
             throw std::runtime_error(std::string("Wrong type of Grid file: ") + filename);
 
-        // Read the file in a go!
-        file.read(reinterpret_cast<char*>(&_cagrid), sizeof(_caGrid));
-        bool ret = file.good() && (sizeof(_caGrid) == file.gcount()) && (file.peek() == EOF);
+        // Read the file in a go! The row pitch is set by manageOptions.
+        file.read(reinterpret_cast<char*>(&_cagrid), fileSize());
+        bool ret = file.good() && (static_cast<std::streamsize>(fileSize()) == file.gcount()) && (file.peek() == EOF);
 
         if (!ret)
             throw std::runtime_error(std::string("Error loading data from Grid file: ") + filename);
 
         // Close the file.
         file.close();
+
+        manageOptions(options);
     }
 
 
     inline Grid::~Grid()
     {
+        // The buffers should be destroyed before the grid.
+        for (size_t k = 0; k < _records.size(); ++k)
+            freeBuffer(_records[k].mem);
     }
 
 
@@ -451,6 +706,406 @@ namespace CA {
     }
 
 
+    inline void Grid::setRowStreaming(bool rows)
+    {
+        _row_streaming = rows;
+    }
+
+
+    inline bool Grid::rowStreaming() const
+    {
+        return _row_streaming;
+    }
+
+
+    inline void Grid::setNuma(bool numa)
+    {
+        _numa = numa;
+
+#if defined CA2D_OPENMP && defined __linux__
+        if (!_numa)
+            return;
+
+        // Pin each thread to one of the cores the process can run on,
+        // in order, so the pages first touched by a thread stay close
+        // to it.
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+            return;
+
+        std::vector<int> cores;
+        for (int c = 0; c < CPU_SETSIZE; ++c)
+        {
+            if (CPU_ISSET(c, &allowed))
+                cores.push_back(c);
+        }
+
+        if (cores.empty())
+            return;
+
+#pragma omp parallel default(shared)
+        {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cores[omp_get_thread_num() % cores.size()], &set);
+            sched_setaffinity(0, sizeof(set), &set);
+        }
+#endif
+    }
+
+
+    inline bool Grid::numa() const
+    {
+        return _numa;
+    }
+
+
+    inline void Grid::touchRows(void* mem, size_t row_size, Unsigned rows) const
+    {
+        char* buff = static_cast<char*>(mem);
+
+#ifdef CA2D_OPENMP
+        if (_numa)
+        {
+            // The same size of the chunk of the execution of the CA
+            // functions in the full domain.
+            Unsigned chunksize = yNum() / omp_get_num_procs() + 1;
+
+#pragma omp parallel for default(shared) schedule(static,chunksize)
+            for (int j = 0; j < static_cast<int>(rows); ++j)
+            {
+                memset(&buff[j * row_size], 0, row_size);
+            }
+            return;
+        }
+#endif
+        memset(buff, 0, row_size * rows);
+    }
+
+
+    inline void Grid::setRowSkew(bool skew)
+    {
+        _row_skew = skew;
+        setPitch();
+    }
+
+
+    inline bool Grid::rowSkew() const
+    {
+        return _row_skew;
+    }
+
+
+    inline void Grid::setCellRecord(Unsigned buffers)
+    {
+        _cell_record = (buffers > 0) ? buffers : 1;
+        setPitch();
+    }
+
+
+    inline Unsigned Grid::cellRecord() const
+    {
+        return (_caCellTileY > 1) ? 1 : _cell_record;
+    }
+
+
+    inline Unsigned Grid::cellRows() const
+    {
+        return (_cagrid.cb_y_size + _caCellTileY - 1) / _caCellTileY * _caCellTileY;
+    }
+
+
+    inline void Grid::setHugePages(bool huge)
+    {
+        _huge_pages = huge;
+    }
+
+
+    inline bool Grid::hugePages() const
+    {
+        return _huge_pages;
+    }
+
+
+    inline void Grid::setTeamMinCells(Unsigned cells)
+    {
+        _team_min_cells = cells;
+    }
+
+
+    inline Unsigned Grid::teamMinCells() const
+    {
+        return _team_min_cells;
+    }
+
+
+    inline Unsigned Grid::maxThreads()
+    {
+#ifdef CA2D_OPENMP
+        const int threads = std::max(omp_get_max_threads(), omp_get_num_procs());
+        return static_cast<Unsigned>(std::min(threads, omp_get_thread_limit()));
+#else
+        return 1;
+#endif
+    }
+
+
+    inline void* Grid::allocBuffer(size_t size)
+    {
+        const size_t line = 64;
+        const size_t huge = 2 * 1024 * 1024;
+
+        // Each new buffer is moved by a different number of cache lines.
+        size_t skew = 0;
+        if (_row_skew)
+            skew = (_buff_count++ % 8) * line;
+
+        // A buffer larger than a huge page starts at a huge page
+        // boundary in huge pages mode.
+        const size_t align = (_huge_pages && size >= huge) ? huge : line;
+
+        // The pointer to the allocated memory is kept just before the
+        // aligned start of the buffer.
+        char* mem = static_cast<char*>(malloc(size + sizeof(void*) + align + skew));
+        if (!mem)
+            return 0;
+
+        char* buff = mem + sizeof(void*);
+        buff += (align - reinterpret_cast<size_t>(buff) % align) % align;
+
+#if defined __linux__ && defined MADV_HUGEPAGE
+        // The advice is only a hint, the buffer is valid also when the
+        // huge pages are not available.
+        if (align == huge)
+            madvise(buff, size + skew, MADV_HUGEPAGE);
+#endif
+
+        buff += skew;
+        reinterpret_cast<void**>(buff)[-1] = mem;
+
+        return buff;
+    }
+
+
+    inline void Grid::freeBuffer(void* buff)
+    {
+        if (buff)
+            free(reinterpret_cast<void**>(buff)[-1]);
+    }
+
+
+    inline void* Grid::allocCellBuffer(size_t elem_size, const std::type_info& elem_type)
+    {
+        const size_t size = _cagrid.cb_x_pitch * cellRows() * elem_size;
+        const Unsigned record = cellRecord();
+
+        if (record <= 1)
+        {
+            void* buff = allocBuffer(size);
+            if (buff)
+                touchRows(buff, _cagrid.cb_x_pitch * elem_size, cellRows());
+            return buff;
+        }
+
+        // Find the last record of the same element type with a free
+        // slot, otherwise create a new one.
+        CellRecord* rec = 0;
+        for (size_t k = _records.size(); k-- > 0;)
+        {
+            if (*_records[k].elem_type == elem_type)
+            {
+                if (_records[k].slots < record)
+                    rec = &_records[k];
+                break;
+            }
+        }
+
+        if (!rec)
+        {
+            CellRecord nrec = { 0, size, elem_size, &elem_type, 0, 0 };
+            nrec.mem = static_cast<char*>(allocBuffer(size));
+            if (!nrec.mem)
+                return 0;
+            touchRows(nrec.mem, _cagrid.cb_x_pitch * elem_size, cellRows());
+
+            _records.push_back(nrec);
+            rec = &_records.back();
+        }
+
+        // The slot k starts at the k-th row of the record.
+        char* buff = rec->mem + rec->slots * (_cagrid.cb_x_pitch / record) * elem_size;
+        ++rec->slots;
+        ++rec->live;
+
+        return buff;
+    }
+
+
+    inline void Grid::freeCellBuffer(void* buff)
+    {
+        if (!buff)
+            return;
+
+        char* p = static_cast<char*>(buff);
+        for (size_t k = 0; k < _records.size(); ++k)
+        {
+            CellRecord& rec = _records[k];
+            if (p >= rec.mem && p < rec.mem + rec.size)
+            {
+                if (--rec.live == 0)
+                {
+                    freeBuffer(rec.mem);
+                    _records.erase(_records.begin() + k);
+                }
+                return;
+            }
+        }
+
+        freeBuffer(buff);
+    }
+
+
+    inline void Grid::setPitch()
+    {
+        // The rows are aligned to 16 cells, i.e. 64 bytes with single
+        // precision real and states.
+        const _caUnsigned align = 16;
+
+        _caUnsigned* sizes[] = {
+            &_cagrid.cb_x_size, &_cagrid.eb_ns_x_size, &_cagrid.eb_we_x_size,
+#ifdef CA2D_MOORE
+            &_cagrid.eb_diag_x_size,
+#endif
+        };
+        _caUnsigned* pitches[] = {
+            &_cagrid.cb_x_pitch, &_cagrid.eb_ns_x_pitch, &_cagrid.eb_we_x_pitch,
+#ifdef CA2D_MOORE
+            &_cagrid.eb_diag_x_pitch,
+#endif
+        };
+
+        for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); ++k)
+        {
+            _caUnsigned pitch = (*sizes[k] + align - 1) / align * align;
+
+            // Avoid a pitch multiple of a large power of two.
+            if (_row_skew && pitch % 1024 == 0)
+                pitch += align;
+
+            *pitches[k] = pitch;
+        }
+
+        // The rows of the buffers of a cell record are interleaved.
+        _cagrid.cb_x_pitch *= cellRecord();
+
+        // Set the starting point for the two sub-buffers in the main buffer.
+        _cagrid.eb_ns_start = 0; // The north/South is first.
+        _cagrid.eb_we_start = _cagrid.eb_ns_x_pitch * _cagrid.eb_ns_y_size;
+
+#ifdef CA2D_MOORE
+        // Set the starting point for the two extra sub-buffers in the main buffer.
+        _cagrid.eb_nwse_start = _cagrid.eb_we_start + (_cagrid.eb_we_x_pitch * _cagrid.eb_we_y_size);
+        _cagrid.eb_nesw_start = _cagrid.eb_nwse_start + (_cagrid.eb_diag_x_pitch * _cagrid.eb_diag_y_size);
+#endif
+    }
+
+
+    inline size_t Grid::fileSize()
+    {
+        const size_t align = std::max(alignof(_caUnsigned), alignof(_caReal));
+        const size_t size = offsetof(_caGrid, print) + sizeof(bool);
+
+        return (size + align - 1) / align * align;
+    }
+
+
+    inline void Grid::setTiles(Unsigned tx, Unsigned ty)
+    {
+        _tile_x = tx;
+        _tile_y = ty;
+    }
+
+
+    inline Unsigned Grid::tileX() const
+    {
+        return _tile_x;
+    }
+
+
+    inline Unsigned Grid::tileY() const
+    {
+        return _tile_y;
+    }
+
+
+    inline void Grid::setSchedule(Schedule schedule)
+    {
+        _schedule = schedule;
+    }
+
+
+    inline Grid::Schedule Grid::schedule() const
+    {
+        return _schedule;
+    }
+
+
+    inline bool Grid::tiled() const
+    {
+        return _tile_x > 0 || _tile_y > 0 || _schedule != Static;
+    }
+
+
+    inline void Grid::manageOptions(const Options& options)
+    {
+        for (Options::const_iterator i = options.begin(); i != options.end(); ++i)
+        {
+            if ((*i)->name == "row-streaming")
+                _row_streaming = true;
+
+            if ((*i)->name == "numa")
+                setNuma(true);
+
+            if ((*i)->name == "row-skew")
+                _row_skew = true;
+
+            if ((*i)->name == "huge-pages")
+                _huge_pages = true;
+
+            if ((*i)->name == "cell-record" && (!fromString(_cell_record, (*i)->value) || _cell_record == 0))
+                throw std::runtime_error(std::string("Error reading the cell-record option: ") + (*i)->value);
+
+            if ((*i)->name == "team-min-cells" && !fromString(_team_min_cells, (*i)->value))
+                throw std::runtime_error(std::string("Error reading the team-min-cells option: ") + (*i)->value);
+
+            if ((*i)->name == "tile-x" && !fromString(_tile_x, (*i)->value))
+                throw std::runtime_error(std::string("Error reading the tile-x option: ") + (*i)->value);
+
+            if ((*i)->name == "tile-y" && !fromString(_tile_y, (*i)->value))
+                throw std::runtime_error(std::string("Error reading the tile-y option: ") + (*i)->value);
+
+            if ((*i)->name == "tile-schedule")
+            {
+                if (compareCaseInsensitive((*i)->value, "static"))
+                    _schedule = Static;
+                else if (compareCaseInsensitive((*i)->value, "dynamic"))
+                    _schedule = Dynamic;
+                else if (compareCaseInsensitive((*i)->value, "guided"))
+                    _schedule = Guided;
+                else if (compareCaseInsensitive((*i)->value, "stealing"))
+                    _schedule = Stealing;
+                else
+                    throw std::runtime_error(std::string("Error reading the tile-schedule option: ") + (*i)->value);
+            }
+        }
+
+        // The row pitch depends on the row skew mode and on the cell
+        // records.
+        setPitch();
+    }
+
+
     inline bool Grid::save(const std::string& mainid, const std::string& subid)
     {
         // Create the filename
@@ -470,8 +1125,18 @@ namespace CA {
         unsigned int magic = CAAPI_2D_MAGIC;
         file.write(reinterpret_cast<char*>(&magic), sizeof(unsigned int));
 
+        // The starting points of the sub-buffers of an edge buffer are
+        // saved without the row pitch.
+        _caGrid cagrid = _cagrid;
+        cagrid.eb_ns_start = 0;
+        cagrid.eb_we_start = cagrid.eb_ns_x_size * cagrid.eb_ns_y_size;
+#ifdef CA2D_MOORE
+        cagrid.eb_nwse_start = cagrid.eb_we_start + (cagrid.eb_we_x_size * cagrid.eb_we_y_size);
+        cagrid.eb_nesw_start = cagrid.eb_nwse_start + (cagrid.eb_diag_x_size * cagrid.eb_diag_y_size);
+#endif
+
         // Write the data in a go!
-        file.write(reinterpret_cast<char*>(&_cagrid), sizeof(_caGrid));
+        file.write(reinterpret_cast<char*>(&cagrid), fileSize());
         bool ret = file.good();
 
         // Close the file.
@@ -25,28 +25,11 @@ THE SOFTWARE.
 
 */
 
-#ifndef _CA_OPTIONS_HPP_
-#define _CA_OPTIONS_HPP_
-
 //! \file Options.hpp 
 //! Contains the list of implementation specific Options
 //! \author Michael J Gibson, University of Exeter, 
 //! contact: m.j.gibson [at] exeter.ac.uk 
 //! \date 2016-04
 
-
-#include"Common.hpp"
-
-
-namespace CA {
-
-
-    //! Return a list of implementation specific Options  
-    inline Options options()
-    {
-        return Options();
-    }
-
-}
-
-#endif  // _CA_OPTIONS_HPP_
+// The options are the same of the common CPU ones.
+#include"../../../../common/CPU/Options.hpp"
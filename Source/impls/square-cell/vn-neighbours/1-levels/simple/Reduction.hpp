@@ -0,0 +1,206 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef _CA_REDUCTION_HPP_
+#define _CA_REDUCTION_HPP_
+
+
+//! \file Reduction.hpp
+//! Define a global reduction of real values object.
+//! \author Michele Guidolin, University of Exeter, 
+//! contact: m.guidolin [at] exeter.ac.uk
+//! \date 2026-10
+
+
+#include"Grid.hpp"
+#include<limits>
+#include<vector>
+#include<algorithm>
+
+
+namespace CA {
+
+
+    //! Define a global reduction of real values. The values can be
+    //! reduced (only) inside a CA function by using the
+    //! caReduceAddReal, caReduceMinReal and caReduceMaxReal methods,
+    //! however the result can be retrieved only in the main file.
+
+    //! Each thread reduces the values into its own partial value, the
+    //! partial values are merged when the result is retrieved. The
+    //! partial values are allocated by the reset for the largest team
+    //! given by Grid::maxThreads.
+
+    //! \attention The CA function must use the method of the same
+    //! operator of the reduction (Add, Min or Max).
+
+    class ReductionReal : public CA::Uncopyable
+    {
+    public:
+
+        //! Create the reduction. It is possible to have implementation
+        //! specific options set by using the options list. \attention Do
+        //! not destroy the grid before destroying this object.
+        //! The reduction is reset to the identity of the operator.
+        //! \param grid    The Grid
+        //! \param op      The operator of the reduction (Add, Min or Max).
+        //! \param options The list of implementation specific options.
+        ReductionReal(Grid& grid, Seq::Operator op, const Options& options = Options());
+
+        //! Destroy the reduction.
+        virtual ~ReductionReal();
+
+        //! Return the specific options about the Reduction object and
+        //! this implementation.
+        static Options options();
+
+        //! Reset the reduction to the identity of the operator.
+        void reset();
+
+        //! Reset the reduction to the given value, i.e. the result is
+        //! the given value reduced with the values reduced by the CA
+        //! functions.
+        void reset(Real value);
+
+        //! Return the result of the reduction of the values reduced by
+        //! the CA functions executed after the last reset.
+        Real value();
+
+        // ---------  Implementation dependent --------------
+
+        // Convert the reduction into the CA_GLOB_REDUCE_REAL used in the CA function
+        operator _caReal*() { return &_partials[0]; }
+
+    private:
+
+        //! Return the identity of the operator.
+        Real identity() const;
+
+        //! The operator of the reduction.
+        Seq::Operator _op;
+
+        //! The partial value of each thread, each one at
+        //! _caReduceStride distance.
+        std::vector<_caReal> _partials;
+    };
+
+
+    /// ----- Inline implementation ----- ///
+
+
+    inline ReductionReal::ReductionReal(Grid& grid, Seq::Operator op, const Options& options) :
+        _op(op),
+        _partials()
+    {
+        // GRID and OPTIONS are not used, it is just there for conformity.
+        reset();
+    }
+
+
+    inline ReductionReal::~ReductionReal()
+    {
+    }
+
+
+    inline Options ReductionReal::options()
+    {
+        Options options;
+
+        // Add the optional arguments. The tag start from higher number
+        // for safety reason.
+        CA::Unsigned na = 7000;
+
+        // Example
+        //options.push_back(new Arguments::Arg(na++,"option-name", "Option desctiption","value",true, true, false));
+
+        return options;
+    }
+
+
+    inline void ReductionReal::reset()
+    {
+        reset(identity());
+    }
+
+
+    inline void ReductionReal::reset(Real value)
+    {
+        // A partial value for each thread of the largest team.
+        const size_t nthreads = static_cast<size_t>(Grid::maxThreads());
+
+        // The first partial value starts from the given value, the
+        // others from the identity.
+        _partials.assign(nthreads * _caReduceStride, identity());
+        _partials[0] = value;
+    }
+
+
+    inline Real ReductionReal::value()
+    {
+        Real result = _partials[0];
+
+        for (size_t i = _caReduceStride; i < _partials.size(); i += _caReduceStride)
+        {
+            switch (_op)
+            {
+            case Seq::Add:
+                result += _partials[i];
+                break;
+            case Seq::Mul:
+                result *= _partials[i];
+                break;
+            case Seq::Min:
+            case Seq::MinAbs:
+                result = std::min<Real>(result, _partials[i]);
+                break;
+            case Seq::Max:
+            case Seq::MaxAbs:
+                result = std::max<Real>(result, _partials[i]);
+                break;
+            }
+        }
+
+        return result;
+    }
+
+
+    inline Real ReductionReal::identity() const
+    {
+        switch (_op)
+        {
+        case Seq::Mul:
+            return 1;
+        case Seq::Min:
+        case Seq::MinAbs:
+            return std::numeric_limits<Real>::max();
+        case Seq::Max:
+            return -std::numeric_limits<Real>::max();
+        default:
+            return 0;
+        }
+    }
+}
+
+#endif  // _CA_REDUCTION_HPP_
@@ -0,0 +1,292 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef _CA_TASKLIST_HPP_
+#define _CA_TASKLIST_HPP_
+
+
+//! \file TaskList.hpp
+//! Contains the classes used to record a list of CA functions and to
+//! execute them with a single team of threads, which waits between
+//! the functions on a spinning barrier instead of starting a new
+//! parallel region for each function.
+//! \author Michele Guidolin, University of Exeter,
+//! contact: m.guidolin [at] exeter.ac.uk
+//! \date 2026-10
+
+
+#include"caapi2D.hpp"
+#include"Grid.hpp"
+#include<vector>
+#include<algorithm>
+
+#ifdef CA2D_OPENMP
+#include<atomic>
+#include<thread>
+#endif
+
+
+namespace CA {
+
+#ifdef CA2D_OPENMP
+
+    //! A barrier between the threads of a team which spins on an
+    //! atomic counter instead of sleeping. The sense of the barrier is
+    //! reversed at each use, thus it can be reused immediately. A
+    //! waiting thread yields after some spins, in case there are more
+    //! threads than cores.
+    class SpinBarrier : public CA::Uncopyable
+    {
+    public:
+
+        //! Create a barrier for the given number of threads.
+        SpinBarrier(int nthreads = 1) :
+            _nthreads(nthreads), _count(nthreads), _sense(false)
+        {
+        }
+
+        //! Set the number of threads. \attention No thread must be
+        //! waiting on the barrier.
+        void reset(int nthreads)
+        {
+            _nthreads = nthreads;
+            _count.store(nthreads);
+            _sense.store(false);
+        }
+
+        //! Wait until all the threads arrive. The given sense is
+        //! private to the calling thread and it must be false at the
+        //! first use.
+        void wait(bool& sense)
+        {
+            sense = !sense;
+
+            // The last thread to arrive resets the counter and releases
+            // the others, which see all the writes done before the
+            // barrier.
+            if (_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                _count.store(_nthreads, std::memory_order_relaxed);
+                _sense.store(sense, std::memory_order_release);
+                return;
+            }
+
+            for (int spin = 0; _sense.load(std::memory_order_acquire) != sense; ++spin)
+            {
+                if (spin >= 1024)
+                    std::this_thread::yield();
+            }
+        }
+
+    private:
+        int              _nthreads;
+        std::atomic<int> _count;
+        char             _pad[64];
+        std::atomic<bool> _sense;
+    };
+
+#endif
+
+
+    //! A CA function recorded in a TaskList.
+    class Task
+    {
+    public:
+        virtual ~Task() {}
+
+        //! Execute the function on the band of rows of each box of the
+        //! given thread out of the given number of threads.
+        virtual void run(const Grid& grid, Unsigned t, Unsigned nt) = 0;
+
+        //! Return the number of cells where the function is executed.
+        virtual Unsigned cells() const = 0;
+    };
+
+
+    //! A CA function, made by makeFunction, executed on a list of
+    //! boxes.
+    template<typename Func>
+    class TaskFunction : public Task
+    {
+    public:
+
+        TaskFunction(const BoxList& bl, Func f) :
+            _bl(bl), _f(f)
+        {
+        }
+
+        void run(const Grid& grid, Unsigned t, Unsigned nt)
+        {
+            // Local copies of the grid and of the function.
+            _caGrid _cagrid = grid;
+            Func f(_f);
+
+            for (BoxList::ConstIter ibox = _bl.begin(); ibox != _bl.end(); ++ibox)
+            {
+                const Box box(*ibox);
+
+                // Set the box.
+                _cagrid.bx_lx = box.x();
+                _cagrid.bx_ty = box.y();
+                _cagrid.bx_rx = box.w() + box.x();
+                _cagrid.bx_by = box.h() + box.y();
+
+                // The static band of rows of the thread.
+                const Unsigned h = box.h();
+                const Unsigned a = box.y() + t * (h / nt) + std::min(t, h % nt);
+                const Unsigned b = a + h / nt + ((t < h % nt) ? 1 : 0);
+
+                for (Unsigned j_reg = a; j_reg < b; ++j_reg)
+                {
+                    _caSetRow(_cagrid, j_reg);
+
+                    for (Unsigned i_reg = box.x(); i_reg < _cagrid.bx_rx; ++i_reg)
+                    {
+                        // Set the new cell to visit.
+                        _cagrid.main_x = i_reg;
+
+                        f(_cagrid);
+                    }
+                }
+            }
+        }
+
+        Unsigned cells() const
+        {
+            Unsigned num = 0;
+            for (BoxList::ConstIter ibox = _bl.begin(); ibox != _bl.end(); ++ibox)
+                num += ibox->size();
+            return num;
+        }
+
+    private:
+        BoxList _bl;
+        Func    _f;
+    };
+
+
+    //! Record a list of CA functions and execute them, in order, with
+    //! a single team of threads. Each thread executes a static band of
+    //! rows of each box and the threads wait on a SpinBarrier between
+    //! two functions, thus a function can read the values written by
+    //! the previous ones in the neighbour cells. The list can be
+    //! executed many times and it can be cleared and recorded again
+    //! (e.g. at each iteration). If the total number of cells is
+    //! smaller than the Grid teamMinCells, the list is executed by the
+    //! calling thread only.
+    //! \attention The row streaming and the tiles of the grid are not
+    //! used.
+    class TaskList : public CA::Uncopyable
+    {
+    public:
+
+        //! Create an empty list of functions executed on the given grid.
+        TaskList(Grid& grid) :
+            _grid(grid), _tasks()
+        {
+        }
+
+        ~TaskList()
+        {
+            clear();
+        }
+
+        //! Record the execution of the given function, made by
+        //! makeFunction, on the given list of boxes. The boxes are
+        //! copied, the arguments of the function are not.
+        template<typename Func>
+        void add(const BoxList& bl, Func f)
+        {
+            // Check that the extent of the boxlist is inside the domain
+            // of the grid.
+            if (!_grid.box().inside(bl.extent()))
+                return;
+
+            _tasks.push_back(new TaskFunction<Func>(bl, f));
+        }
+
+        //! Remove all the recorded functions.
+        void clear()
+        {
+            for (size_t k = 0; k < _tasks.size(); ++k)
+                delete _tasks[k];
+            _tasks.clear();
+        }
+
+        //! Return the number of recorded functions.
+        size_t size() const
+        {
+            return _tasks.size();
+        }
+
+        //! Execute the recorded functions in order.
+        void run()
+        {
+            if (_tasks.empty())
+                return;
+
+#ifdef CA2D_OPENMP
+            Unsigned cells = 0;
+            for (size_t k = 0; k < _tasks.size(); ++k)
+                cells += _tasks[k]->cells();
+
+            if (cells >= _grid.teamMinCells() && omp_get_max_threads() > 1)
+            {
+#pragma omp parallel default(shared)
+                {
+                    const Unsigned nt = omp_get_num_threads();
+                    const Unsigned t = omp_get_thread_num();
+                    bool sense = false;
+
+#pragma omp single
+                    _barrier.reset(static_cast<int>(nt));
+
+                    for (size_t k = 0; k < _tasks.size(); ++k)
+                    {
+                        if (k > 0)
+                            _barrier.wait(sense);
+
+                        _tasks[k]->run(_grid, t, nt);
+                    }
+                }
+                return;
+            }
+#endif
+            for (size_t k = 0; k < _tasks.size(); ++k)
+                _tasks[k]->run(_grid, 0, 1);
+        }
+
+    private:
+        Grid&               _grid;
+        std::vector<Task*>  _tasks;
+
+#ifdef CA2D_OPENMP
+        SpinBarrier         _barrier;
+#endif
+    };
+
+}
+
+#endif  // _CA_TASKLIST_HPP_
@@ -0,0 +1,184 @@
+/*
+
+Copyright (c) 2013 Centre for Water Systems,
+                   University of Exeter
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef _CA_WORKSTEALING_HPP_
+#define _CA_WORKSTEALING_HPP_
+
+
+//! \file WorkStealing.hpp
+//! Contains the classes used to schedule the tiles of a box between
+//! the threads using their cost in the previous execution and work
+//! stealing.
+//! \author Michele Guidolin, University of Exeter,
+//! contact: m.guidolin [at] exeter.ac.uk
+//! \date 2013-11
+
+
+#include"caapi2D.hpp"
+#include<vector>
+#include<iterator>
+
+
+namespace CA {
+
+    //! Keep the cost of each tile of each box of the last execution
+    //! of a CA function. A cost is any positive value proportional to
+    //! the work done in the tile, e.g. the number of wet cells or the
+    //! time spent. The costs of a box are reset to one when its number
+    //! of tiles changes.
+    class TileCosts
+    {
+    public:
+
+        //! Return the costs of the tiles of the given box.
+        std::vector<double>& box(size_t ibox, int ntiles)
+        {
+            if (_boxes.size() <= ibox)
+                _boxes.resize(ibox + 1);
+
+            std::vector<double>& costs = _boxes[ibox];
+            if (costs.size() != static_cast<size_t>(ntiles))
+                costs.assign(ntiles, 1.0);
+
+            return costs;
+        }
+
+    private:
+        std::vector< std::vector<double> > _boxes;
+    };
+
+
+#ifdef CA2D_OPENMP
+
+    //! Schedule the tiles of a box between the threads. At the start
+    //! each thread owns a contiguous range of tiles with about the same
+    //! total cost. A thread executes its own tiles from the front and,
+    //! when it finishes them, it steals the back half of the remaining
+    //! tiles of another thread.
+    class WorkStealing : public CA::Uncopyable
+    {
+    public:
+
+        //! Split the tiles with the given costs between the given
+        //! number of threads.
+        WorkStealing(const std::vector<double>& costs, int nthreads) :
+            _queues(nthreads > 0 ? nthreads : 1)
+        {
+            const int ntiles = static_cast<int>(costs.size());
+            const int nqueues = static_cast<int>(_queues.size());
+
+            double total = 0.0;
+            for (int t = 0; t < ntiles; ++t)
+                total += costs[t];
+
+            // Each thread takes the tiles until the prefix sum of the
+            // costs reaches its share of the total.
+            double sum = 0.0;
+            int t = 0;
+            for (int q = 0; q < nqueues; ++q)
+            {
+                const double share = total * (q + 1) / nqueues;
+
+                _queues[q].begin = t;
+                while (t < ntiles && (q == nqueues - 1 || sum + costs[t] * 0.5 <= share))
+                    sum += costs[t++];
+                _queues[q].end = t;
+
+                omp_init_lock(&_queues[q].lock);
+            }
+        }
+
+        ~WorkStealing()
+        {
+            for (size_t q = 0; q < _queues.size(); ++q)
+                omp_destroy_lock(&_queues[q].lock);
+        }
+
+        //! Return the next tile to execute by the given thread or -1 if
+        //! there are no more tiles.
+        int next(int tid)
+        {
+            const int nqueues = static_cast<int>(_queues.size());
+            Queue& own = _queues[tid % nqueues];
+            int t = -1;
+
+            omp_set_lock(&own.lock);
+            if (own.begin < own.end)
+                t = own.begin++;
+            omp_unset_lock(&own.lock);
+
+            if (t >= 0)
+                return t;
+
+            // Steal the back half of the tiles of another thread, the
+            // first stolen tile is returned and the others are kept.
+            for (int v = 1; v < nqueues; ++v)
+            {
+                Queue& victim = _queues[(tid + v) % nqueues];
+                int begin = 0, end = 0;
+
+                omp_set_lock(&victim.lock);
+                if (victim.begin < victim.end)
+                {
+                    end = victim.end;
+                    begin = end - (victim.end - victim.begin + 1) / 2;
+                    victim.end = begin;
+                }
+                omp_unset_lock(&victim.lock);
+
+                if (begin < end)
+                {
+                    omp_set_lock(&own.lock);
+                    own.begin = begin + 1;
+                    own.end = end;
+                    omp_unset_lock(&own.lock);
+
+                    return begin;
+                }
+            }
+
+            return -1;
+        }
+
+    private:
+
+        //! The range of tiles owned by a thread. It is padded to avoid
+        //! false sharing between the threads.
+        struct Queue
+        {
+            omp_lock_t lock;
+            int begin;
+            int end;
+            char pad[64];
+        };
+
+        std::vector<Queue> _queues;
+    };
+
+#endif
+
+}
+
+#endif  // _CA_WORKSTEALING_HPP_
@@ -51,9 +51,12 @@ THE SOFTWARE.
 #include"CellBuff.hpp"
 #include"EdgeBuff.hpp"
 #include"Alarms.hpp"
+#include"Reduction.hpp"
 #include"Table.hpp"
 #include"Functions.hpp"
 #include"Decomposition.hpp"
+#include"WorkStealing.hpp"
+#include"TaskList.hpp"
 
 #include "ESRI_ASCIIGrid.hpp"
 
@@ -67,6 +70,19 @@ THE SOFTWARE.
 #define CA_2D_INCLUDE(name) CA_QUOTE(name.ca)
 
 
+//! \def CA2D_ROWS
+//! Define that this implementation can execute a row function, i.e
+//! a function that is called once for each row of a box (see
+//! executeRowFunction) or of a list of rows (see executeRowList).
+#define CA2D_ROWS
+
+
+//! \def CA2D_TASKS
+//! Define that this implementation can record a list of CA functions
+//! and execute them with a single team of threads (see TaskList).
+#define CA2D_TASKS
+
+
 namespace CA {
 
     //! Initialise the 2D caAPI environment. This method must be called as
@@ -117,6 +133,29 @@ namespace CA {
     };
 
 
+    //! Define the type of the mask of a cell.
+    typedef _caMask Mask;
+
+
+    //! Identifies the buffer which contains the mask of each cell in
+    //! the grid (see createCellMask), the flags of a mask are read with
+    //! caMaskData, caMaskBorder and caMaskBoundary. A mask uses less
+    //! memory than a state value.
+    class CellBuffMask : public CellBuff<Mask>
+    {
+    public:
+        CellBuffMask(Grid& grid, const Options& options = Options()) :
+            CellBuff<Mask>(grid, options)
+        {
+        }
+
+        virtual ~CellBuffMask() {}
+
+    private:
+
+    };
+
+
     //! Identifies the buffer which contains a real value for each edge
     //! of each cell in the grid.
     class EdgeBuffReal : public EdgeBuff<Real>
@@ -184,6 +223,184 @@ namespace CA {
     };
 
 
+
+    //! Define how an argument of a CA function is passed when the
+    //! function is executed row by row. By default the argument is
+    //! passed by reference, as in the normal execution.
+    template<typename A>
+    struct RowArg
+    {
+        typedef A& Type;
+        static A& get(A& a) { return a; }
+    };
+
+
+    //! A global real value is copied, thus it cannot be changed by
+    //! any buffer write during the execution.
+    template<>
+    struct RowArg<Real>
+    {
+        typedef Real Type;
+        static Real get(Real& a) { return a; }
+    };
+
+
+    template<>
+    struct RowArg<const Real>
+    {
+        typedef Real Type;
+        static Real get(const Real& a) { return a; }
+    };
+
+
+    //! A global state value is copied, thus it cannot be changed by
+    //! any buffer write during the execution.
+    template<>
+    struct RowArg<State>
+    {
+        typedef State Type;
+        static State get(State& a) { return a; }
+    };
+
+
+    template<>
+    struct RowArg<const State>
+    {
+        typedef State Type;
+        static State get(const State& a) { return a; }
+    };
+
+
+    //! A buffer is passed as the pointer of its data, which is read
+    //! only once before the execution.
+    template<>
+    struct RowArg<CellBuffReal>
+    {
+        typedef Real* Type;
+        static Real* get(CellBuffReal& a) { return a; }
+    };
+
+
+    template<>
+    struct RowArg<CellBuffState>
+    {
+        typedef State* Type;
+        static State* get(CellBuffState& a) { return a; }
+    };
+
+
+    template<>
+    struct RowArg<CellBuffMask>
+    {
+        typedef Mask* Type;
+        static Mask* get(CellBuffMask& a) { return a; }
+    };
+
+
+    template<>
+    struct RowArg<EdgeBuffReal>
+    {
+        typedef Real* Type;
+        static Real* get(EdgeBuffReal& a) { return a; }
+    };
+
+
+    template<>
+    struct RowArg<EdgeBuffState>
+    {
+        typedef State* Type;
+        static State* get(EdgeBuffState& a) { return a; }
+    };
+
+
+    template<>
+    struct RowArg<TableReal>
+    {
+        typedef const Real* Type;
+        static const Real* get(TableReal& a) { return a; }
+    };
+
+
+    template<>
+    struct RowArg<TableState>
+    {
+        typedef const State* Type;
+        static const State* get(TableState& a) { return a; }
+    };
+
+
+    template<>
+    struct RowArg<Alarms>
+    {
+        typedef char* Type;
+        static char* get(Alarms& a) { return a; }
+    };
+
+
+    //! Identifies the tiles in which a box is split. The tiles are
+    //! numbered row by row and the tiles in the right/bottom border of
+    //! the box can be smaller.
+    class Tiles
+    {
+    public:
+
+        //! Split the box in tiles of the given sizes, a zero X size
+        //! means the width of the box and a zero Y size means one row.
+        //! A box whose right/bottom border is not after the left/top one
+        //! has no tiles, as in the loops of the cells.
+        Tiles(const Box& box, Unsigned tx, Unsigned ty) :
+            _x(box.x()), _y(box.y()), _rx(box.x() + box.w()), _by(box.y() + box.h()),
+            _w((tx > 0) ? tx : std::max(box.w(), static_cast<Unsigned>(1))),
+            _h((ty > 0) ? ty : 1),
+            _nx((_rx > _x) ? (_rx - _x + _w - 1) / _w : 0),
+            _ny((_by > _y) ? (_by - _y + _h - 1) / _h : 0)
+        {
+        }
+
+        //! Return the number of tiles.
+        int num() const { return static_cast<int>(_nx * _ny); }
+
+        //! Set the left x, top y, right x and bottom y of the given tile.
+        void tile(int t, Unsigned& lx, Unsigned& ty, Unsigned& rx, Unsigned& by) const
+        {
+            lx = _x + (t % _nx) * _w;
+            ty = _y + (t / _nx) * _h;
+            rx = std::min(lx + _w, _rx);
+            by = std::min(ty + _h, _by);
+        }
+
+    private:
+        Unsigned _x, _y, _rx, _by;
+        Unsigned _w, _h;
+        Unsigned _nx, _ny;
+    };
+
+
+#ifdef CA2D_OPENMP
+    //! Set the OpenMP schedule used by the loops of the tiles
+    //! (schedule(runtime)) using the policy of the grid.
+    inline void setTilesSchedule(const Grid& grid)
+    {
+        switch (grid.schedule())
+        {
+        case Grid::Dynamic: omp_set_schedule(omp_sched_dynamic, 0); break;
+        case Grid::Guided:  omp_set_schedule(omp_sched_guided, 0); break;
+        default:            omp_set_schedule(omp_sched_static, 0); break;
+        }
+    }
+#endif
+
+
+    //! Return the costs of the tiles of the last execution of the CA
+    //! functions of the given type, used by the stealing schedule.
+    template<typename Func>
+    inline TileCosts& tileCosts()
+    {
+        static TileCosts costs;
+        return costs;
+    }
+
+
     //! Execute a CA functions.
     template<typename Func>
     inline void execute(const BoxList& bl, Func f, Grid& grid)
@@ -205,6 +422,74 @@ namespace CA {
             const Box box(*ibox);
 
 #ifdef CA2D_OPENMP
+            if (grid.tiled())
+            {
+                // Split the box in tiles, each thread executes a tile
+                // at the time.
+                const Tiles tiles(box, grid.tileX(), grid.tileY());
+
+                // Set the box.
+                _cagrid.bx_lx = box.x();
+                _cagrid.bx_ty = box.y();
+                _cagrid.bx_rx = box.w() + box.x();
+                _cagrid.bx_by = box.h() + box.y();
+
+                if (grid.schedule() == Grid::Stealing)
+                {
+                    // The cost of a tile is the time spent on it.
+                    std::vector<double>& costs = tileCosts<Func>().box(std::distance(bl.begin(), ibox), tiles.num());
+                    WorkStealing ws(costs, omp_get_max_threads());
+
+#pragma omp parallel default(shared) firstprivate(f,_cagrid)
+                    {
+                        const int tid = omp_get_thread_num();
+                        for (int t = ws.next(tid); t >= 0; t = ws.next(tid))
+                        {
+                            Unsigned lx, ty, rx, by;
+                            tiles.tile(t, lx, ty, rx, by);
+
+                            const double start = omp_get_wtime();
+                            for (Unsigned j_reg = ty; j_reg < by; ++j_reg)
+                            {
+                                _caSetRow(_cagrid, j_reg);
+
+                                for (Unsigned i_reg = lx; i_reg < rx; ++i_reg)
+                                {
+                                    // Set the new cell to visit.
+                                    _cagrid.main_x = i_reg;
+
+                                    f(_cagrid);
+                                }
+                            }
+                            costs[t] = omp_get_wtime() - start + omp_get_wtick();
+                        }
+                    }
+                    continue;
+                }
+
+                setTilesSchedule(grid);
+#pragma omp parallel for default(shared) firstprivate(f,_cagrid) schedule(runtime)
+                for (int t = 0; t < tiles.num(); ++t)
+                {
+                    Unsigned lx, ty, rx, by;
+                    tiles.tile(t, lx, ty, rx, by);
+
+                    for (Unsigned j_reg = ty; j_reg < by; ++j_reg)
+                    {
+                        _caSetRow(_cagrid, j_reg);
+
+                        for (Unsigned i_reg = lx; i_reg < rx; ++i_reg)
+                        {
+                            // Set the new cell to visit.
+                            _cagrid.main_x = i_reg;
+
+                            f(_cagrid);
+                        }
+                    }
+                }
+                continue;
+            }
+
             Unsigned chunksize = box.h() / omp_get_num_procs() + 1;
             // Cycle through the region of cells to read. 
             // And set the nev value of the __cagrid.
@@ -213,11 +498,12 @@ namespace CA {
       // And set the nev value of the __cagrid.
             for (int j_reg = static_cast<int>(box.y()); j_reg < box.h() + box.y(); ++j_reg)
             {
+                _caSetRow(_cagrid, j_reg);
+
                 for (int i_reg = static_cast<int>(box.x()); i_reg < box.w() + box.x(); ++i_reg)
                 {
                     // Set the new cell to visit.
                     _cagrid.main_x = i_reg;
-                    _cagrid.main_y = j_reg;
 
                     // Set the box.
                     _cagrid.bx_lx = box.x();
@@ -233,11 +519,12 @@ namespace CA {
             // And set the nev value of the __cagrid.
             for (Unsigned j_reg = box.y(); j_reg < box.h() + box.y(); ++j_reg)
             {
+                _caSetRow(_cagrid, j_reg);
+
                 for (Unsigned i_reg = box.x(); i_reg < box.w() + box.x(); ++i_reg)
                 {
                     // Set the new cell to visit.
                     _cagrid.main_x = i_reg;
-                    _cagrid.main_y = j_reg;
 
                     // Set the box.
                     _cagrid.bx_lx = box.x();
@@ -253,9 +540,603 @@ namespace CA {
     }
 
 
+    //! Execute a CA functions row by row. The values of the grid are
+    //! copied locally and the box is set only once. The indices of the
+    //! row of the main cell, and of the rows above and below it, are
+    //! set once for each row (see _caSetRow), thus inside a row only
+    //! the X index of the main cell changes and the CAAPI functions
+    //! index the buffers with it. With Execute::function the buffers
+    //! are passed as the pointers of their data, read once before the
+    //! execution (see RowArg).
+    //! \attention The CA function is the same used by execute.
+    template<typename Func>
+    inline void executeRows(const BoxList& bl, Func f, Grid& grid)
+    {
+        // Check that the extent of the boxlist is inside the domain of
+        // the grid.
+        if (!grid.box().inside(bl.extent()))
+            return;
+
+        // Cycle through the boxes.
+        for (BoxList::ConstIter ibox = bl.begin(); ibox != bl.end(); ++ibox)
+        {
+            const Box box(*ibox);
+
+            // Local copy of the grid with the box set.
+            _caGrid _cagrid = grid;
+            _cagrid.bx_lx = box.x();
+            _cagrid.bx_ty = box.y();
+            _cagrid.bx_rx = box.w() + box.x();
+            _cagrid.bx_by = box.h() + box.y();
+
+            const Unsigned x_start = _cagrid.bx_lx;
+            const Unsigned x_stop = _cagrid.bx_rx;
+
+#ifdef CA2D_OPENMP
+            if (grid.tiled())
+            {
+                // Split the box in tiles, each thread executes the rows
+                // of a tile at the time.
+                const Tiles tiles(box, grid.tileX(), grid.tileY());
+
+                if (grid.schedule() == Grid::Stealing)
+                {
+                    // The cost of a tile is the time spent on it.
+                    std::vector<double>& costs = tileCosts<Func>().box(std::distance(bl.begin(), ibox), tiles.num());
+                    WorkStealing ws(costs, omp_get_max_threads());
+
+#pragma omp parallel default(shared) firstprivate(f,_cagrid)
+                    {
+                        const int tid = omp_get_thread_num();
+                        for (int t = ws.next(tid); t >= 0; t = ws.next(tid))
+                        {
+                            Unsigned lx, ty, rx, by;
+                            tiles.tile(t, lx, ty, rx, by);
+
+                            const double start = omp_get_wtime();
+                            for (Unsigned j_reg = ty; j_reg < by; ++j_reg)
+                            {
+                                _caSetRow(_cagrid, j_reg);
+
+                                for (Unsigned i_reg = lx; i_reg < rx; ++i_reg)
+                                {
+                                    _cagrid.main_x = i_reg;
+                                    f(_cagrid);
+                                }
+                            }
+                            costs[t] = omp_get_wtime() - start + omp_get_wtick();
+                        }
+                    }
+                    continue;
+                }
+
+                setTilesSchedule(grid);
+#pragma omp parallel for default(shared) firstprivate(f,_cagrid) schedule(runtime)
+                for (int t = 0; t < tiles.num(); ++t)
+                {
+                    Unsigned lx, ty, rx, by;
+                    tiles.tile(t, lx, ty, rx, by);
+
+                    for (Unsigned j_reg = ty; j_reg < by; ++j_reg)
+                    {
+                        _caSetRow(_cagrid, j_reg);
+
+                        for (Unsigned i_reg = lx; i_reg < rx; ++i_reg)
+                        {
+                            _cagrid.main_x = i_reg;
+                            f(_cagrid);
+                        }
+                    }
+                }
+                continue;
+            }
+
+            Unsigned chunksize = box.h() / omp_get_num_procs() + 1;
+            // Cycle through the rows of the box, each thread has its
+            // own copy of the grid.
+#pragma omp parallel for default(shared) firstprivate(f,_cagrid) schedule(static,chunksize)
+            for (int j_reg = static_cast<int>(box.y()); j_reg < static_cast<int>(box.h() + box.y()); ++j_reg)
+            {
+                _caSetRow(_cagrid, j_reg);
+
+                for (Unsigned i_reg = x_start; i_reg < x_stop; ++i_reg)
+                {
+                    _cagrid.main_x = i_reg;
+                    f(_cagrid);
+                }
+            }
+#else
+            // Cycle through the rows of the box.
+            for (Unsigned j_reg = box.y(); j_reg < box.h() + box.y(); ++j_reg)
+            {
+                _caSetRow(_cagrid, j_reg);
+
+                for (Unsigned i_reg = x_start; i_reg < x_stop; ++i_reg)
+                {
+                    _cagrid.main_x = i_reg;
+                    f(_cagrid);
+                }
+            }
+#endif
+        }
+    }
+
+
+    //! Execute a row function. The function is called once for each
+    //! row of each box with the signature Unsigned f(const _caGrid&,
+    //! Unsigned n) where the given grid has the box set and the main
+    //! cell set to the first cell of the row, and n is the number of
+    //! cells in the row. If the box is split in tiles, the function is
+    //! called for each row of a tile, thus the row can start after the
+    //! left border of the box. The function returns the work done in
+    //! the row, e.g. the number of wet cells, which is used as the cost
+    //! of the tile by the stealing schedule.
+    //! \attention The function must process the n cells of the row,
+    //! it can be used to execute explicitly vectorised code.
+    template<typename Func>
+    inline void executeRowFunction(const BoxList& bl, Func f, Grid& grid)
+    {
+        // Check that the extent of the boxlist is inside the domain of
+        // the grid.
+        if (!grid.box().inside(bl.extent()))
+            return;
+
+        // Cycle through the boxes.
+        for (BoxList::ConstIter ibox = bl.begin(); ibox != bl.end(); ++ibox)
+        {
+            const Box box(*ibox);
+
+            // Local copy of the grid with the box set.
+            _caGrid _cagrid = grid;
+            _cagrid.bx_lx = box.x();
+            _cagrid.bx_ty = box.y();
+            _cagrid.bx_rx = box.w() + box.x();
+            _cagrid.bx_by = box.h() + box.y();
+            _cagrid.main_x = box.x();
+
+            const Unsigned n = box.w();
+
+#ifdef CA2D_OPENMP
+            if (grid.tiled())
+            {
+                // Split the box in tiles, the function is called for
+                // each row of a tile.
+                const Tiles tiles(box, grid.tileX(), grid.tileY());
+
+                if (grid.schedule() == Grid::Stealing)
+                {
+                    // The cost of a tile is the work returned by the
+                    // function for its rows, e.g. the wet cells.
+                    std::vector<double>& costs = tileCosts<Func>().box(std::distance(bl.begin(), ibox), tiles.num());
+                    WorkStealing ws(costs, omp_get_max_threads());
+
+#pragma omp parallel default(shared) firstprivate(f,_cagrid)
+                    {
+                        const int tid = omp_get_thread_num();
+                        for (int t = ws.next(tid); t >= 0; t = ws.next(tid))
+                        {
+                            Unsigned lx, ty, rx, by;
+                            tiles.tile(t, lx, ty, rx, by);
+
+                            double cost = 0.0;
+                            _cagrid.main_x = lx;
+                            for (Unsigned j_reg = ty; j_reg < by; ++j_reg)
+                            {
+                                _caSetRow(_cagrid, j_reg);
+                                cost += 1.0 + f(static_cast<const _caGrid&>(_cagrid), rx - lx);
+                            }
+                            costs[t] = cost;
+                        }
+                    }
+                    continue;
+                }
+
+                setTilesSchedule(grid);
+#pragma omp parallel for default(shared) firstprivate(f,_cagrid) schedule(runtime)
+                for (int t = 0; t < tiles.num(); ++t)
+                {
+                    Unsigned lx, ty, rx, by;
+                    tiles.tile(t, lx, ty, rx, by);
+
+                    _cagrid.main_x = lx;
+                    for (Unsigned j_reg = ty; j_reg < by; ++j_reg)
+                    {
+                        _caSetRow(_cagrid, j_reg);
+                        f(static_cast<const _caGrid&>(_cagrid), rx - lx);
+                    }
+                }
+                continue;
+            }
+
+            Unsigned chunksize = box.h() / omp_get_num_procs() + 1;
+            // Cycle through the rows of the box, each thread has its
+            // own copy of the grid.
+#pragma omp parallel for default(shared) firstprivate(f,_cagrid) schedule(static,chunksize)
+            for (int j_reg = static_cast<int>(box.y()); j_reg < static_cast<int>(box.h() + box.y()); ++j_reg)
+            {
+                _caSetRow(_cagrid, j_reg);
+                f(static_cast<const _caGrid&>(_cagrid), n);
+            }
+#else
+            // Cycle through the rows of the box.
+            for (Unsigned j_reg = box.y(); j_reg < box.h() + box.y(); ++j_reg)
+            {
+                _caSetRow(_cagrid, j_reg);
+                f(static_cast<const _caGrid&>(_cagrid), n);
+            }
+#endif
+        }
+    }
+
+
+    //! Execute a row function on a list of rows of cells. The function
+    //! has the same signature used by executeRowFunction and it is
+    //! called once for each row of the list with the main cell set to
+    //! the first cell of the row. The box is set to the full grid, thus
+    //! the border of the box is the border of the grid. With OpenMP the
+    //! rows are split among the threads, whose work is balanced by a
+    //! guided schedule since the rows can have very different lengths.
+    template<typename Func>
+    inline void executeRowList(const RowList& rl, Func f, Grid& grid)
+    {
+        // Check that the extent of the rowlist is inside the domain of
+        // the grid.
+        if (rl.size() == 0 || !grid.box().inside(rl.extent()))
+            return;
+
+        // Local copy of the grid with the box set.
+        const Box box(grid.box());
+        _caGrid _cagrid = grid;
+        _cagrid.bx_lx = box.x();
+        _cagrid.bx_ty = box.y();
+        _cagrid.bx_rx = box.w() + box.x();
+        _cagrid.bx_by = box.h() + box.y();
+
+#ifdef CA2D_OPENMP
+#pragma omp parallel for default(shared) firstprivate(f,_cagrid) schedule(guided)
+        for (int i = 0; i < static_cast<int>(rl.size()); ++i)
+        {
+            const RowList::Row& r = rl[i];
+            _cagrid.main_x = r.x;
+            _caSetRow(_cagrid, r.y);
+            f(static_cast<const _caGrid&>(_cagrid), r.w);
+        }
+#else
+        for (RowList::ConstIter ir = rl.begin(); ir != rl.end(); ++ir)
+        {
+            _cagrid.main_x = ir->x;
+            _caSetRow(_cagrid, ir->y);
+            f(static_cast<const _caGrid&>(_cagrid), ir->w);
+        }
+#endif
+    }
+
+
+    //! Execute the pipeline of two row functions on the rows [a,b) of a
+    //! box. The second function is executed on a row after the first
+    //! one was executed on the row below. If top/bottom is true, the
+    //! first/last row is shared with another band and the second
+    //! function is not executed on it before the barrier.
+    template<typename Func1, typename Func2>
+    inline void executeRowBand(_caGrid& _cagrid, Func1& f1, Func2& f2, Unsigned n,
+        Unsigned a, Unsigned b, bool top, bool bottom)
+    {
+        const Unsigned lo = a + (top ? 1 : 0);
+        const Unsigned hi = b - (bottom ? 1 : 0);
+
+        for (Unsigned j_reg = a; j_reg < b; ++j_reg)
+        {
+            _caSetRow(_cagrid, j_reg);
+            f1(static_cast<const _caGrid&>(_cagrid), n);
+
+            if (j_reg > lo && j_reg - 1 < hi)
+            {
+                _caSetRow(_cagrid, j_reg - 1);
+                f2(static_cast<const _caGrid&>(_cagrid), n);
+            }
+        }
+
+        // The last row, if not shared.
+        if (b - 1 >= lo && b - 1 < hi)
+        {
+            _caSetRow(_cagrid, b - 1);
+            f2(static_cast<const _caGrid&>(_cagrid), n);
+        }
+    }
+
+
+    //! Execute the second function of the pipeline on the rows of the
+    //! band that are shared with other bands.
+    template<typename Func2>
+    inline void executeRowBandBorders(_caGrid& _cagrid, Func2& f2, Unsigned n,
+        Unsigned a, Unsigned b, bool top, bool bottom)
+    {
+        const Unsigned lo = a + (top ? 1 : 0);
+        const Unsigned hi = b - (bottom ? 1 : 0);
+
+        for (Unsigned j_reg = a; j_reg < lo; ++j_reg)
+        {
+            _caSetRow(_cagrid, j_reg);
+            f2(static_cast<const _caGrid&>(_cagrid), n);
+        }
+
+        for (Unsigned j_reg = std::max(lo, hi); j_reg < b; ++j_reg)
+        {
+            _caSetRow(_cagrid, j_reg);
+            f2(static_cast<const _caGrid&>(_cagrid), n);
+        }
+    }
+
+
+    //! Execute two row functions in a single sweep of each box. The
+    //! second function is executed on a row as soon as the first one
+    //! was executed on the row and on the rows above and below it,
+    //! thus the buffers of a row are read while they are still in
+    //! cache. The functions have the same signature used by
+    //! executeRowFunction. If the functions read/write only the main
+    //! cell and its von Neumann neighbours, the result is the same of
+    //! executing executeRowFunction with the first function and then
+    //! with the second one. With OpenMP, each thread executes a band of
+    //! rows and the rows in the border of the bands are completed after
+    //! a barrier.
+    //! \attention The boxes must not be adjacent or overlapping and the
+    //! tiles of the grid are not used.
+    template<typename Func1, typename Func2>
+    inline void executeRowFunctions(const BoxList& bl, Func1 f1, Func2 f2, Grid& grid)
+    {
+        // Check that the extent of the boxlist is inside the domain of
+        // the grid.
+        if (!grid.box().inside(bl.extent()))
+            return;
+
+        // Cycle through the boxes.
+        for (BoxList::ConstIter ibox = bl.begin(); ibox != bl.end(); ++ibox)
+        {
+            const Box box(*ibox);
+
+            // Local copy of the grid with the box set.
+            _caGrid _cagrid = grid;
+            _cagrid.bx_lx = box.x();
+            _cagrid.bx_ty = box.y();
+            _cagrid.bx_rx = box.w() + box.x();
+            _cagrid.bx_by = box.h() + box.y();
+            _cagrid.main_x = box.x();
+
+            const Unsigned n = box.w();
+            const Unsigned y_start = _cagrid.bx_ty;
+            const Unsigned y_stop = _cagrid.bx_by;
+
+            if (y_stop <= y_start)
+                continue;
+
+#ifdef CA2D_OPENMP
+#pragma omp parallel default(shared) firstprivate(f1,f2,_cagrid)
+            {
+                // Split the rows of the box in a band for each thread.
+                const Unsigned nt = omp_get_num_threads();
+                const Unsigned t = omp_get_thread_num();
+                const Unsigned h = y_stop - y_start;
+                const Unsigned a = y_start + t * (h / nt) + std::min(t, h % nt);
+                const Unsigned b = a + h / nt + ((t < h % nt) ? 1 : 0);
+                const bool top = a > y_start;
+                const bool bottom = b < y_stop;
+
+                if (a < b)
+                    executeRowBand(_cagrid, f1, f2, n, a, b, top, bottom);
+
+#pragma omp barrier
+
+                if (a < b)
+                    executeRowBandBorders(_cagrid, f2, n, a, b, top, bottom);
+            }
+#else
+            executeRowBand(_cagrid, f1, f2, n, y_start, y_stop, false, false);
+#endif
+        }
+    }
+
+
+    //! A row function that does nothing, e.g. the missing last function
+    //! of executeRowSteps.
+    struct NoRowFunction
+    {
+        Unsigned operator()(const _caGrid&, Unsigned) const
+        {
+            return 0;
+        }
+    };
+
+
+    //! Execute the pipeline of the steps of two row functions on the
+    //! rows [a,b) of a box. The step s is executed two rows behind the
+    //! step s-1, thus the first function of a step is executed on a
+    //! row after the second function of the previous step was executed
+    //! on the rows around it. The last function, if not null, is
+    //! executed as the first function of another step. If top/bottom
+    //! is true, the first/last rows are shared with another band and
+    //! each step leaves two more of them to executeRowStepsBorders.
+    template<typename Func1, typename Func2, typename Func3>
+    inline void executeRowStepsBand(_caGrid& _cagrid, const std::vector<Func1>& f1, const std::vector<Func2>& f2,
+        const Func3* f3, Unsigned n, Unsigned a, Unsigned b, bool top, bool bottom)
+    {
+        const Unsigned k = static_cast<Unsigned>(f1.size());
+        const Unsigned d3 = 2 * k;
+
+        for (Unsigned j_reg = a; j_reg < b + 2 * k - (f3 ? 0 : 1); ++j_reg)
+        {
+            for (Unsigned s = 0; s < k; ++s)
+            {
+                // The row of the first and of the second function of
+                // the step, whose first and last rows are skipped if
+                // shared.
+                const Unsigned d1 = 2 * s;
+                const Unsigned d2 = 2 * s + 1;
+
+                if (j_reg >= a + d1 && j_reg - d1 >= a + (top ? d1 : 0) && j_reg - d1 + (bottom ? d1 : 0) < b)
+                {
+                    _caSetRow(_cagrid, j_reg - d1);
+                    f1[s](static_cast<const _caGrid&>(_cagrid), n);
+                }
+
+                if (j_reg >= a + d2 && j_reg - d2 >= a + (top ? d2 : 0) && j_reg - d2 + (bottom ? d2 : 0) < b)
+                {
+                    _caSetRow(_cagrid, j_reg - d2);
+                    f2[s](static_cast<const _caGrid&>(_cagrid), n);
+                }
+            }
+
+            if (f3 && j_reg >= a + d3 && j_reg - d3 >= a + (top ? d3 : 0) && j_reg - d3 + (bottom ? d3 : 0) < b)
+            {
+                _caSetRow(_cagrid, j_reg - d3);
+                (*f3)(static_cast<const _caGrid&>(_cagrid), n);
+            }
+        }
+    }
+
+
+    //! Execute the steps of the two row functions, and the last
+    //! function if not null, on the rows around the row a, which is the
+    //! first row of a band shared with the band above it and that were
+    //! left by executeRowStepsBand.
+    template<typename Func1, typename Func2, typename Func3>
+    inline void executeRowStepsBorders(_caGrid& _cagrid, const std::vector<Func1>& f1, const std::vector<Func2>& f2,
+        const Func3* f3, Unsigned n, Unsigned a)
+    {
+        const Unsigned k = static_cast<Unsigned>(f1.size());
+
+        for (Unsigned s = 0; s < k; ++s)
+        {
+            for (Unsigned j_reg = a - 2 * s; j_reg < a + 2 * s; ++j_reg)
+            {
+                _caSetRow(_cagrid, j_reg);
+                f1[s](static_cast<const _caGrid&>(_cagrid), n);
+            }
+
+            for (Unsigned j_reg = a - 2 * s - 1; j_reg < a + 2 * s + 1; ++j_reg)
+            {
+                _caSetRow(_cagrid, j_reg);
+                f2[s](static_cast<const _caGrid&>(_cagrid), n);
+            }
+        }
+
+        if (f3)
+        {
+            for (Unsigned j_reg = a - 2 * k; j_reg < a + 2 * k; ++j_reg)
+            {
+                _caSetRow(_cagrid, j_reg);
+                (*f3)(static_cast<const _caGrid&>(_cagrid), n);
+            }
+        }
+    }
+
+
+    //! Execute the steps of two row functions, and then the last
+    //! function if not null, in a single sweep of each box (see
+    //! executeRowSteps).
+    template<typename Func1, typename Func2, typename Func3>
+    inline void executeRowStepsLast(const BoxList& bl, const std::vector<Func1>& f1, const std::vector<Func2>& f2,
+        const Func3* f3, Grid& grid)
+    {
+        // Check that the extent of the boxlist is inside the domain of
+        // the grid and that the steps match.
+        if (!grid.box().inside(bl.extent()) || f1.empty() || f1.size() != f2.size())
+            return;
+
+        const Unsigned k = static_cast<Unsigned>(f1.size());
+
+        // Cycle through the boxes.
+        for (BoxList::ConstIter ibox = bl.begin(); ibox != bl.end(); ++ibox)
+        {
+            const Box box(*ibox);
+
+            // Local copy of the grid with the box set.
+            _caGrid _cagrid = grid;
+            _cagrid.bx_lx = box.x();
+            _cagrid.bx_ty = box.y();
+            _cagrid.bx_rx = box.w() + box.x();
+            _cagrid.bx_by = box.h() + box.y();
+            _cagrid.main_x = box.x();
+
+            const Unsigned n = box.w();
+            const Unsigned y_start = _cagrid.bx_ty;
+            const Unsigned y_stop = _cagrid.bx_by;
+
+            if (y_stop <= y_start)
+                continue;
+
+#ifdef CA2D_OPENMP
+            // The number of bands, the borders of two bands must not
+            // touch.
+            const Unsigned h = y_stop - y_start;
+            const Unsigned nb = std::max(std::min(static_cast<Unsigned>(omp_get_max_threads()), h / (4 * k + 2)),
+                static_cast<Unsigned>(1));
+
+#pragma omp parallel default(shared) firstprivate(_cagrid) num_threads(nb)
+            {
+                // Split the rows of the box in a band for each thread.
+                const Unsigned nt = omp_get_num_threads();
+                const Unsigned t = omp_get_thread_num();
+                const Unsigned a = y_start + t * (h / nt) + std::min(t, h % nt);
+                const Unsigned b = a + h / nt + ((t < h % nt) ? 1 : 0);
+                const bool top = a > y_start;
+                const bool bottom = b < y_stop;
+
+                if (a < b)
+                    executeRowStepsBand(_cagrid, f1, f2, f3, n, a, b, top, bottom);
+
+#pragma omp barrier
+
+                if (a < b && top)
+                    executeRowStepsBorders(_cagrid, f1, f2, f3, n, a);
+            }
+#else
+            executeRowStepsBand(_cagrid, f1, f2, f3, n, y_start, y_stop, false, false);
+#endif
+        }
+    }
+
+
+    //! Execute the steps of two row functions in a single sweep of
+    //! each box, the functions of the step s are f1[s] and f2[s]. The
+    //! step s is executed on a row as soon as the step s-1 was
+    //! executed on the rows around it, thus the buffers of a row are
+    //! read by all the steps while they are still in cache and a
+    //! halo is not needed. The functions have the same signature used
+    //! by executeRowFunction and they must read/write only the main
+    //! cell and its von Neumann neighbours, then the result is the same
+    //! of executing executeRowFunctions with each step. With OpenMP,
+    //! each thread executes a band of rows that shrinks by two rows on
+    //! each shared side at each step, and the rows around the border
+    //! of the bands are completed after a barrier. The bands are at
+    //! least 4 * steps + 2 rows high.
+    //! \attention The boxes must not be adjacent or overlapping and the
+    //! tiles of the grid are not used.
+    template<typename Func1, typename Func2>
+    inline void executeRowSteps(const BoxList& bl, const std::vector<Func1>& f1, const std::vector<Func2>& f2,
+        Grid& grid)
+    {
+        executeRowStepsLast(bl, f1, f2, static_cast<const NoRowFunction*>(0), grid);
+    }
+
+
+    //! Execute the steps of two row functions as executeRowSteps and
+    //! then the last function, which is executed on a row as soon as
+    //! the last step was executed on the rows around it, i.e. it
+    //! reads the result of the steps in the same sweep.
+    template<typename Func1, typename Func2, typename Func3>
+    inline void executeRowSteps(const BoxList& bl, const std::vector<Func1>& f1, const std::vector<Func2>& f2,
+        const Func3& f3, Grid& grid)
+    {
+        executeRowStepsLast(bl, f1, f2, &f3, grid);
+    }
+
+
     //! Define the class that execute a CA Function.  This class works
     //! only with static methods. It is impossible to create a normal
     //! objects since the construct is private.
+    //! \attention If the grid has the row streaming set, the buffers
+    //! and the global values are read once before the execution and
+    //! the function is executed with executeRows.
     class Execute : public CA::Uncopyable
     {
     private:
@@ -267,42 +1148,42 @@ namespace CA {
         template<typename Func, typename A1>
         static void function(const BoxList& bl, Func f, Grid& g, A1& a1)
         {
-            CA::execute(bl, CA::makeFunction(f, a1), g);
+            dispatch(bl, f, g, a1);
         }
 
 
         template<typename Func, typename A1, typename A2>
         static void function(const BoxList& bl, Func f, Grid& g, A1& a1, A2& a2)
         {
-            CA::execute(bl, CA::makeFunction(f, a1, a2), g);
+            dispatch(bl, f, g, a1, a2);
         }
 
 
         template<typename Func, typename A1, typename A2, typename A3>
         static void function(const BoxList& bl, Func f, Grid& g, A1& a1, A2& a2, A3& a3)
         {
-            CA::execute(bl, CA::makeFunction(f, a1, a2, a3), g);
+            dispatch(bl, f, g, a1, a2, a3);
         }
 
 
         template<typename Func, typename A1, typename A2, typename A3, typename A4>
         static void function(const BoxList& bl, Func f, Grid& g, A1& a1, A2& a2, A3& a3, A4& a4)
         {
-            CA::execute(bl, CA::makeFunction(f, a1, a2, a3, a4), g);
+            dispatch(bl, f, g, a1, a2, a3, a4);
         }
 
 
         template<typename Func, typename A1, typename A2, typename A3, typename A4, typename A5>
         static void function(const BoxList& bl, Func f, Grid& g, A1& a1, A2& a2, A3& a3, A4& a4, A5& a5)
         {
-            CA::execute(bl, CA::makeFunction(f, a1, a2, a3, a4, a5), g);
+            dispatch(bl, f, g, a1, a2, a3, a4, a5);
         }
 
 
         template<typename Func, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6 >
         static void function(const BoxList& bl, Func f, Grid& g, A1& a1, A2& a2, A3& a3, A4& a4, A5& a5, A6& a6)
         {
-            CA::execute(bl, CA::makeFunction(f, a1, a2, a3, a4, a5, a6), g);
+            dispatch(bl, f, g, a1, a2, a3, a4, a5, a6);
         }
 
         // seven
@@ -311,7 +1192,7 @@ namespace CA {
             static void function(const BoxList& bl, Func f, Grid& g, A1& a1, A2& a2, A3& a3, A4& a4, A5& a5, A6& a6,
                 A7& a7)
         {
-            CA::execute(bl, CA::makeFunction(f, a1, a2, a3, a4, a5, a6, a7), g);
+            dispatch(bl, f, g, a1, a2, a3, a4, a5, a6, a7);
         }
 
         // eight
@@ -320,7 +1201,7 @@ namespace CA {
             static void function(const BoxList& bl, Func f, Grid& g, A1& a1, A2& a2, A3& a3, A4& a4, A5& a5, A6& a6,
                 A7& a7, A8& a8)
         {
-            CA::execute(bl, CA::makeFunction(f, a1, a2, a3, a4, a5, a6, a7, a8), g);
+            dispatch(bl, f, g, a1, a2, a3, a4, a5, a6, a7, a8);
         }
 
         // nine
@@ -329,7 +1210,7 @@ namespace CA {
             static void function(const BoxList& bl, Func f, Grid& g, A1& a1, A2& a2, A3& a3, A4& a4, A5& a5, A6& a6,
                 A7& a7, A8& a8, A9& a9)
         {
-            CA::execute(bl, CA::makeFunction(f, a1, a2, a3, a4, a5, a6, a7, a8, a9), g);
+            dispatch(bl, f, g, a1, a2, a3, a4, a5, a6, a7, a8, a9);
         }
 
         // ten
@@ -338,7 +1219,7 @@ namespace CA {
             static void function(const BoxList& bl, Func f, Grid& g, A1& a1, A2& a2, A3& a3, A4& a4, A5& a5, A6& a6,
                 A7& a7, A8& a8, A9& a9, A10& a10)
         {
-            CA::execute(bl, CA::makeFunction(f, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10), g);
+            dispatch(bl, f, g, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10);
         }
 
         // eleven
@@ -347,7 +1228,7 @@ namespace CA {
             static void function(const BoxList& bl, Func f, Grid& g, A1& a1, A2& a2, A3& a3, A4& a4, A5& a5, A6& a6,
                 A7& a7, A8& a8, A9& a9, A10& a10, A11& a11)
         {
-            CA::execute(bl, CA::makeFunction(f, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11), g);
+            dispatch(bl, f, g, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11);
         }
 
         // twleve
@@ -356,7 +1237,7 @@ namespace CA {
             static void function(const BoxList& bl, Func f, Grid& g, A1& a1, A2& a2, A3& a3, A4& a4, A5& a5, A6& a6,
                 A7& a7, A8& a8, A9& a9, A10& a10, A11& a11, A12& a12)
         {
-            CA::execute(bl, CA::makeFunction(f, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12), g);
+            dispatch(bl, f, g, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12);
         }
 
         // thirteen
@@ -366,7 +1247,7 @@ namespace CA {
             static void function(const BoxList& bl, Func f, Grid& g, A1& a1, A2& a2, A3& a3, A4& a4, A5& a5, A6& a6,
                 A7& a7, A8& a8, A9& a9, A10& a10, A11& a11, A12& a12, A13& a13)
         {
-            CA::execute(bl, CA::makeFunction(f, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13), g);
+            dispatch(bl, f, g, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13);
         }
 
         // fourtheen
@@ -376,7 +1257,7 @@ namespace CA {
             static void function(const BoxList& bl, Func f, Grid& g, A1& a1, A2& a2, A3& a3, A4& a4, A5& a5, A6& a6,
                 A7& a7, A8& a8, A9& a9, A10& a10, A11& a11, A12& a12, A13& a13, A14& a14)
         {
-            CA::execute(bl, CA::makeFunction(f, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14), g);
+            dispatch(bl, f, g, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14);
         }
 
         // fofiftenn
@@ -386,7 +1267,7 @@ namespace CA {
             static void function(const BoxList& bl, Func f, Grid& g, A1& a1, A2& a2, A3& a3, A4& a4, A5& a5, A6& a6,
                 A7& a7, A8& a8, A9& a9, A10& a10, A11& a11, A12& a12, A13& a13, A14& a14, A15& a15)
         {
-            CA::execute(bl, CA::makeFunction(f, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15), g);
+            dispatch(bl, f, g, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15);
         }
 
 
@@ -398,7 +1279,7 @@ namespace CA {
                 A7& a7, A8& a8, A9& a9, A10& a10, A11& a11, A12& a12, A13& a13, A14& a14, A15& a15,
                 A16& a16)
         {
-            CA::execute(bl, CA::makeFunction(f, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15, a16), g);
+            dispatch(bl, f, g, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15, a16);
         }
 
 
@@ -410,7 +1291,30 @@ namespace CA {
                 A7& a7, A8& a8, A9& a9, A10& a10, A11& a11, A12& a12, A13& a13, A14& a14, A15& a15,
                 A16& a16, A17& a17)
         {
-            CA::execute(bl, CA::makeFunction(f, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15, a16, a17), g);
+            dispatch(bl, f, g, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15, a16, a17);
+        }
+
+    private:
+
+        //! Execute the CA function with the given arguments, row by row
+        //! with executeRows if the grid has the row streaming set,
+        //! otherwise with execute.
+        template<typename Func, typename... A>
+        static void dispatch(const BoxList& bl, Func f, Grid& g, A&... a)
+        {
+            if (g.rowStreaming())
+                rows<Func, typename RowArg<A>::Type...>(bl, f, g, RowArg<A>::get(a)...);
+            else
+                CA::execute(bl, CA::makeFunction(f, a...), g);
+        }
+
+
+        //! Execute the CA function row by row with the arguments read
+        //! by RowArg, which are kept by this call during the execution.
+        template<typename Func, typename... R>
+        static void rows(const BoxList& bl, Func f, Grid& g, R... r)
+        {
+            CA::executeRows(bl, CA::makeFunction(f, r...), g);
         }
     };
 
@@ -50,6 +50,16 @@ THE SOFTWARE.
 #error This CAAPI 2D implementation requires a C++ compiler
 #endif
 
+// The number of rows of a tile of a cell buffer, one (row-major) if it
+// is not set by the CAAPI_CELL_TILE option of CMake.
+#ifndef CA_CELL_TILE
+#define CA_CELL_TILE 1
+#endif
+
+#if CA_CELL_TILE < 1 || (CA_CELL_TILE & (CA_CELL_TILE - 1)) != 0
+#error The number of rows of a tile of a cell buffer must be a power of two
+#endif
+
 #ifdef _MSC_VER
 #pragma warning(push)
 #pragma warning(disable:4305)
@@ -107,6 +117,15 @@ typedef double         _caReal;
 typedef int           _caState;
 
 
+//! Define the type of the cell mask values, which has a bit for each
+//! cell of the neighbourhood and two flags (see caMaskData).
+#ifdef CA2D_MOORE
+typedef unsigned short _caMask;
+#else
+typedef unsigned char  _caMask;
+#endif
+
+
 //! Define the type of a size value.
 typedef std::size_t   _caUnsigned;
 
@@ -237,8 +256,104 @@ struct _caGrid
 
     //! If true, print works.
     bool print;
+
+    // The fields below are not saved in the Grid file, they are set by
+    // the Grid when it is created or loaded.
+
+    //! The distance between the start of two consecutive rows of a
+    //! cell buffer (row pitch). It is the X size rounded up to align
+    //! the rows to the cache line.
+    _caUnsigned cb_x_pitch;
+
+    //! The row pitch of the north/south and of the west/east
+    //! sub-buffers of an edge buffer.
+    _caUnsigned eb_ns_x_pitch;
+    _caUnsigned eb_we_x_pitch;
+
+#ifdef CA2D_MOORE
+    //! The row pitch of the diagonal sub-buffer of an edge buffer.
+    _caUnsigned eb_diag_x_pitch;
+#endif
+
+    //! The index in a cell buffer of the first cell, border included,
+    //! of the row of the main cell, and of the rows above and below
+    //! it. They are set with main_y by _caSetRow, thus the CAAPI
+    //! functions add only the offset of main_x in the row (see
+    //! _caCellCol).
+    _caUnsigned cb_row;
+    _caUnsigned cb_row_n;
+    _caUnsigned cb_row_s;
+
+    //! The index of the edge with X index zero in the row of the main
+    //! cell of the north/south and of the west/east sub-buffers of an
+    //! edge buffer.
+    _caUnsigned eb_ns_row;
+    _caUnsigned eb_we_row;
+
+#ifdef CA2D_MOORE
+    //! The index of the edge with X index zero in the row of the main
+    //! cell of the two diagonal sub-buffers of an edge buffer.
+    _caUnsigned eb_nwse_row;
+    _caUnsigned eb_nesw_row;
+#endif
 };
 
+
+//! The X size of a tile of a cell buffer, 16 cells, i.e. a cache line
+//! of single precision values.
+const _caUnsigned _caCellTileX = 16;
+
+//! The number of rows of a tile of a cell buffer, a power of two set
+//! by the CAAPI_CELL_TILE option of CMake. The cells of a tile are
+//! contiguous and the tiles of a row of tiles follow each other, thus
+//! the north and south neighbours of a cell are in the near cache
+//! lines of the same tile. One means the row-major order.
+const _caUnsigned _caCellTileY = CA_CELL_TILE;
+
+
+//! Return the index in a cell buffer of the first cell of the row with
+//! the given Y index, border included.
+inline _caUnsigned _caCellRow(const _caGrid& grid, _caUnsigned y)
+{
+    return (y / _caCellTileY) * (grid.cb_x_pitch * _caCellTileY)
+        + (y % _caCellTileY) * _caCellTileX;
+}
+
+
+//! Return the offset in a row of a cell buffer of the cell with the
+//! given X index, border included. In row-major order it is the X
+//! index.
+inline _caUnsigned _caCellCol(const _caGrid& grid, _caUnsigned x)
+{
+    if (_caCellTileY == 1)
+        return x;
+
+    return (x / _caCellTileX) * (_caCellTileX * _caCellTileY) + x % _caCellTileX;
+}
+
+
+//! Set the Y index of the main cell and the indices of its row in the
+//! cell and edge buffers. The executors call it once for each row.
+inline void _caSetRow(_caGrid& grid, _caUnsigned y)
+{
+    grid.main_y = y;
+
+    grid.cb_row = _caCellRow(grid, y + grid.cb_border);
+    grid.cb_row_n = _caCellRow(grid, y + grid.cb_border - 1);
+    grid.cb_row_s = _caCellRow(grid, y + grid.cb_border + 1);
+
+    grid.eb_ns_row = (y + grid.eb_ns_y_border) * grid.eb_ns_x_pitch + grid.eb_ns_start;
+    grid.eb_we_row = y * grid.eb_we_x_pitch + grid.eb_we_x_border + grid.eb_we_start;
+
+#ifdef CA2D_MOORE
+    grid.eb_nwse_row = (y + grid.eb_diag_y_border) * grid.eb_diag_x_pitch
+        + grid.eb_diag_y_border + grid.eb_nwse_start;
+    grid.eb_nesw_row = (y + grid.eb_diag_y_border) * grid.eb_diag_x_pitch
+        + grid.eb_diag_y_border + grid.eb_nesw_start;
+#endif
+}
+
+
 // ---- GLOBAL VARIABLES  ----
 
 //! PI Value
@@ -275,6 +390,18 @@ static const char* caImplPrecision = "unknown";
 #endif
 
 
+//! The distance, in number of real values, between the partial values
+//! of two threads in a reduction. The partial values are on different
+//! cache lines to avoid false sharing.
+const int _caReduceStride = 64 / sizeof(_caReal);
+
+//! The distance between the alarms of two threads in a set of alarms.
+//! The alarms of each thread are on a different cache line to avoid
+//! false sharing, thus it is also the maximum number of alarms in a set
+//! of the OpenMP implementation.
+const int _caAlarmsStride = 64;
+
+
 #ifdef CA2D_MOORE
 
 #define CA2D_NEIGHBOURS 8
@@ -311,6 +438,14 @@ const int caMaxNeighboursLevel = 4;
 
 #endif
 
+//! The bit of a mask which is true if the main cell has data and a
+//! neighbour cell has nodata.
+const int caMaskBorderBit = 8 * sizeof(_caMask) - 2;
+
+//! The bit of a mask which is true if the main cell has nodata and a
+//! neighbour cell has data, i.e. a boundary cell.
+const int caMaskBoundaryBit = 8 * sizeof(_caMask) - 1;
+
 // ---- CA FUNCTION DECLARATION METHODS ----
 
 
@@ -337,6 +472,12 @@ typedef const _caState*     CA_CELLBUFF_STATE_I;
 //! Define the type of the read/write buffer with a state value in each cell.
 typedef _caState*           CA_CELLBUFF_STATE_IO;
 
+//! Define the type of the read only buffer with a mask in each cell.
+typedef const _caMask*      CA_CELLBUFF_MASK_I;
+
+//! Define the type of the read/write buffer with a mask in each cell.
+typedef _caMask*            CA_CELLBUFF_MASK_IO;
+
 //! Define the type of the read only buffer with a real value in each edge.
 typedef const _caReal*      CA_EDGEBUFF_REAL_I;
 
@@ -360,6 +501,11 @@ typedef const _caState      CA_GLOB_STATE_I;
 //! checked their status inside a CA function..
 typedef char*               CA_ALARMS_O;
 
+//! Define the type of a global reduction of real values. A value can
+//! be reduced (added, minimum, maximum) inside a CA function. However,
+//! the result can be retrieved only in the main file.
+typedef _caReal*            CA_GLOB_REDUCE_REAL;
+
 //! Define the type of a table with real data.
 typedef const  _caReal*     CA_TABLE_REAL_I;
 
@@ -374,6 +520,9 @@ typedef _caReal   CA_REAL;
 //! Define the type of a state value.
 typedef _caState  CA_STATE;
 
+//! Define the type of a mask value.
+typedef _caMask   CA_MASK;
+
 //! \def CA_GRID_INIT
 //! Intialise the grid structure.
 #ifdef  CA_GRID_INIT
@@ -1103,17 +1252,14 @@ inline void caCeilRealArray(_caReal values[], int n)
 //! Read the value stored in the selected bits from the given value.
 inline _caState caReadBitsState(_caState value, int start, int stop)
 {
-    _caState ret = 0;
+    if (stop <= start)
+        return 0;
 
-    int b = 0;
-    int s = 0;
+    // The bits are shifted as unsigned, the width can be 32 bits.
+    const unsigned int bits = static_cast<unsigned int>(value) >> start;
+    const unsigned int width = static_cast<unsigned int>(stop - start);
 
-    for (b = 0, s = start; s < stop; b++, s++)
-    {
-        ret |= (value & (1 << s)) >> (s - b);
-    }
-
-    return ret;
+    return static_cast<_caState>((width >= 32) ? bits : bits & ((1u << width) - 1u));
 }
 
 
@@ -1122,18 +1268,60 @@ inline _caState caReadBitsState(_caState value, int start, int stop)
 //! method.
 inline _caState caWriteBitsState(_caState value, _caState buffer, int start, int stop)
 {
-    int mask = 0;
-    int bits = 0;
-    int b = 0;
-    int s = 0;
+    if (stop <= start)
+        return buffer;
 
-    for (b = 0, s = start; s < stop; b++, s++)
-    {
-        mask |= (1 << s);
-        bits |= (((1 << b)&value) >> b) << s;
-        buffer = (buffer&(~mask)) ^ bits;
-    }
-    return buffer;
+    const unsigned int width = static_cast<unsigned int>(stop - start);
+    const unsigned int mask = ((width >= 32) ? ~0u : ((1u << width) - 1u)) << start;
+
+    return static_cast<_caState>((static_cast<unsigned int>(buffer) & ~mask) |
+        ((static_cast<unsigned int>(value) << start) & mask));
+}
+
+
+//! Return 1 if the given cell of the neighbourhood (0 is the main cell)
+//! has data in the given mask, 0 otherwise.
+inline _caState caMaskData(_caMask mask, int cell_number)
+{
+    return (mask >> cell_number) & 1;
+}
+
+
+//! Return 1 if the main cell of the given mask has data and a neighbour
+//! cell has nodata, 0 otherwise.
+inline _caState caMaskBorder(_caMask mask)
+{
+    return (mask >> caMaskBorderBit) & 1;
+}
+
+
+//! Return 1 if the main cell of the given mask has nodata and a
+//! neighbour cell has data, i.e. it is a boundary cell, 0 otherwise.
+inline _caState caMaskBoundary(_caMask mask)
+{
+    return (mask >> caMaskBoundaryBit) & 1;
+}
+
+
+//! Return the given mask with the data bit of the given cell of the
+//! neighbourhood set to the given value (0 or 1).
+inline _caMask caMaskSetData(_caMask mask, int cell_number, _caState value)
+{
+    return static_cast<_caMask>((mask & ~(1u << cell_number)) | ((value & 1u) << cell_number));
+}
+
+
+//! Return the given mask with the border bit set to the given value.
+inline _caMask caMaskSetBorder(_caMask mask, _caState value)
+{
+    return caMaskSetData(mask, caMaskBorderBit, value);
+}
+
+
+//! Return the given mask with the boundary bit set to the given value.
+inline _caMask caMaskSetBoundary(_caMask mask, _caState value)
+{
+    return caMaskSetData(mask, caMaskBoundaryBit, value);
 }
 
 // ---- SPECIALISED FUNCTIONS ----
@@ -1156,18 +1344,67 @@ inline _caReal caFlowVelocity(_caReal irough, _caReal S, _caReal R, _caReal D)
 // ---- ALARMS ----
 
 
+//! Return the alarms of the calling thread.
+inline CA_ALARMS_O _caAlarmsPartial(CA_ALARMS_O alarms)
+{
+#ifdef CA2D_OPENMP
+    return alarms + omp_get_thread_num() * _caAlarmsStride;
+#else
+    return alarms;
+#endif
+}
+
 //! Activate the specific alarm from the set of alarms.
 inline void caActivateAlarm(CA_GRID grid, CA_ALARMS_O alarms, int n)
 {
-    alarms[n] = 1;
+    _caAlarmsPartial(alarms)[n] = 1;
 }
 
 //! Activate all the alarms that have the bit set to true in the given
 //! mask.
 inline void caActivateAlarmMask(CA_GRID grid, CA_ALARMS_O alarms, CA_STATE mask, int num)
 {
+    CA_ALARMS_O partial = _caAlarmsPartial(alarms);
+
     for (int i = 0; i < num; i++)
-        if (((mask >> i) & 1) == 1) alarms[i] = 1;
+        if (((mask >> i) & 1) == 1) partial[i] = 1;
+}
+
+
+// ---- REDUCTIONS ----
+
+
+//! Return the partial value of the reduction of the calling thread.
+inline _caReal& _caReducePartial(CA_GLOB_REDUCE_REAL reduce)
+{
+#ifdef CA2D_OPENMP
+    return reduce[omp_get_thread_num() * _caReduceStride];
+#else
+    return reduce[0];
+#endif
+}
+
+//! Add the given value into the reduction. \attention The reduction
+//! must use the Add operator.
+inline void caReduceAddReal(CA_GRID grid, CA_GLOB_REDUCE_REAL reduce, _caReal value)
+{
+    _caReducePartial(reduce) += value;
+}
+
+//! Reduce the given value into the reduction using the minimum.
+//! \attention The reduction must use the Min operator.
+inline void caReduceMinReal(CA_GRID grid, CA_GLOB_REDUCE_REAL reduce, _caReal value)
+{
+    _caReal& partial = _caReducePartial(reduce);
+    partial = caMinReal(partial, value);
+}
+
+//! Reduce the given value into the reduction using the maximum.
+//! \attention The reduction must use the Max operator.
+inline void caReduceMaxReal(CA_GRID grid, CA_GLOB_REDUCE_REAL reduce, _caReal value)
+{
+    _caReal& partial = _caReducePartial(reduce);
+    partial = caMaxReal(partial, value);
 }
 
 
@@ -1177,32 +1414,40 @@ inline void caActivateAlarmMask(CA_GRID grid, CA_ALARMS_O alarms, CA_STATE mask,
 //! Read the real value of the cell from the given buffer at the given cell number.
 inline _caReal caReadCellBuffReal(CA_GRID grid, CA_CELLBUFF_REAL_I src, int cell_number)
 {
-    _caUnsigned x_size = grid.cb_x_size;
-    _caUnsigned i = (grid.main_y + grid.cb_border) * x_size + (grid.main_x + grid.cb_border);
+    // The offsets in a row of the main cell and of the cells at its
+    // east and west.
+    _caUnsigned x = grid.main_x + grid.cb_border;
+    _caUnsigned c = _caCellCol(grid, x);
+    _caUnsigned e = _caCellCol(grid, x + 1);
+    _caUnsigned w = _caCellCol(grid, x - 1);
+
+    _caUnsigned i = grid.cb_row;
+    _caUnsigned n = grid.cb_row_n;
+    _caUnsigned s = grid.cb_row_s;
 
     _caReal value = 0.0;
 
 #ifdef CA2D_MOORE
     switch (cell_number)
     {
-    case 0: value = src[i]; break; // found missing break here....
-    case 1: value = src[i + 1]; break;
-    case 2: value = src[i - x_size + 1]; break;
-    case 3: value = src[i - x_size]; break;
-    case 4: value = src[i - x_size - 1]; break;
-    case 5: value = src[i - 1]; break;
-    case 6: value = src[i + x_size - 1]; break;
-    case 7: value = src[i + x_size]; break;
-    case 8: value = src[i + x_size + 1]; break;
+    case 0: value = src[i + c]; break; // found missing break here....
+    case 1: value = src[i + e]; break;
+    case 2: value = src[n + e]; break;
+    case 3: value = src[n + c]; break;
+    case 4: value = src[n + w]; break;
+    case 5: value = src[i + w]; break;
+    case 6: value = src[s + w]; break;
+    case 7: value = src[s + c]; break;
+    case 8: value = src[s + e]; break;
     }
 #else //CA2D_VN
     switch (cell_number)
     {
-    case 0: value = src[i]; break;
-    case 1: value = src[i + 1]; break;
-    case 2: value = src[i - x_size]; break;
-    case 3: value = src[i - 1]; break;
-    case 4: value = src[i + x_size]; break;
+    case 0: value = src[i + c]; break;
+    case 1: value = src[i + e]; break;
+    case 2: value = src[n + c]; break;
+    case 3: value = src[i + w]; break;
+    case 4: value = src[s + c]; break;
     }
 #endif
     return value;
@@ -1213,29 +1458,36 @@ inline _caReal caReadCellBuffReal(CA_GRID grid, CA_CELLBUFF_REAL_I src, int cell
 //! cells from the given buffer.
 inline void  caReadCellBuffRealCellArray(CA_GRID grid, CA_CELLBUFF_REAL_I src, _caReal values[])
 {
-    _caUnsigned x_size = grid.cb_x_size;
+    // The offsets in a row of the main cell and of the cells at its
+    // east and west.
+    _caUnsigned x = grid.main_x + grid.cb_border;
+    _caUnsigned c = _caCellCol(grid, x);
+    _caUnsigned e = _caCellCol(grid, x + 1);
+    _caUnsigned w = _caCellCol(grid, x - 1);
 
-    _caUnsigned i = (grid.main_y + grid.cb_border) * x_size + (grid.main_x + grid.cb_border);
+    _caUnsigned i = grid.cb_row;
+    _caUnsigned n = grid.cb_row_n;
+    _caUnsigned s = grid.cb_row_s;
 
 #ifdef CA2D_MOORE
 
-    values[0] = src[i];
-    values[1] = src[i + 1];
-    values[2] = src[i - x_size + 1];
-    values[3] = src[i - x_size];
-    values[4] = src[i - x_size - 1];
-    values[5] = src[i - 1];
-    values[6] = src[i + x_size - 1];
-    values[7] = src[i + x_size];
-    values[8] = src[i + x_size + 1];
+    values[0] = src[i + c];
+    values[1] = src[i + e];
+    values[2] = src[n + e];
+    values[3] = src[n + c];
+    values[4] = src[n + w];
+    values[5] = src[i + w];
+    values[6] = src[s + w];
+    values[7] = src[s + c];
+    values[8] = src[s + e];
 
 #else // CA2D_VN
 
-    values[0] = src[i];
-    values[1] = src[i + 1];
-    values[2] = src[i - x_size];
-    values[3] = src[i - 1];
-    values[4] = src[i + x_size];
+    values[0] = src[i + c];
+    values[1] = src[i + e];
+    values[2] = src[n + c];
+    values[3] = src[i + w];
+    values[4] = src[s + c];
 
 #endif
 }
@@ -1244,39 +1496,47 @@ inline void  caReadCellBuffRealCellArray(CA_GRID grid, CA_CELLBUFF_REAL_I src, _
 //! Write the given real value of the cell into the given buffer at the main cell index.
 inline void caWriteCellBuffReal(CA_GRID grid, CA_CELLBUFF_REAL_IO dst, _caReal value)
 {
-    dst[(grid.main_y + grid.cb_border) * grid.cb_x_size + (grid.main_x + grid.cb_border)] = value;
+    dst[grid.cb_row + _caCellCol(grid, grid.main_x + grid.cb_border)] = value;
 }
 
 
 //! Read the state value of the cell from the given buffer at the given cell index.
 inline _caState caReadCellBuffState(CA_GRID grid, CA_CELLBUFF_STATE_I src, int cell_number)
 {
-    _caUnsigned x_size = grid.cb_x_size;
-    _caUnsigned i = (grid.main_y + grid.cb_border) * x_size + (grid.main_x + grid.cb_border);
+    // The offsets in a row of the main cell and of the cells at its
+    // east and west.
+    _caUnsigned x = grid.main_x + grid.cb_border;
+    _caUnsigned c = _caCellCol(grid, x);
+    _caUnsigned e = _caCellCol(grid, x + 1);
+    _caUnsigned w = _caCellCol(grid, x - 1);
+
+    _caUnsigned i = grid.cb_row;
+    _caUnsigned n = grid.cb_row_n;
+    _caUnsigned s = grid.cb_row_s;
 
     _caState value = 0;
 
 #ifdef CA2D_MOORE
     switch (cell_number)
     {
-    case 0: value = src[i]; break;
-    case 1: value = src[i + 1]; break;
-    case 2: value = src[i - x_size + 1]; break;
-    case 3: value = src[i - x_size]; break;
-    case 4: value = src[i - x_size - 1]; break;
-    case 5: value = src[i - 1]; break;
-    case 6: value = src[i + x_size - 1]; break;
-    case 7: value = src[i + x_size]; break;
-    case 8: value = src[i + x_size + 1]; break;
+    case 0: value = src[i + c]; break;
+    case 1: value = src[i + e]; break;
+    case 2: value = src[n + e]; break;
+    case 3: value = src[n + c]; break;
+    case 4: value = src[n + w]; break;
+    case 5: value = src[i + w]; break;
+    case 6: value = src[s + w]; break;
+    case 7: value = src[s + c]; break;
+    case 8: value = src[s + e]; break;
     }
 #else //CA2D_VN
     switch (cell_number)
     {
-    case 0: value = src[i]; break;
-    case 1: value = src[i + 1]; break;
-    case 2: value = src[i - x_size]; break;
-    case 3: value = src[i - 1]; break;
-    case 4: value = src[i + x_size]; break;
+    case 0: value = src[i + c]; break;
+    case 1: value = src[i + e]; break;
+    case 2: value = src[n + c]; break;
+    case 3: value = src[i + w]; break;
+    case 4: value = src[s + c]; break;
     }
 #endif
     return value;
@@ -1287,29 +1547,36 @@ inline _caState caReadCellBuffState(CA_GRID grid, CA_CELLBUFF_STATE_I src, int c
 //! cells from the given buffer.
 inline void  caReadCellBuffStateCellArray(CA_GRID grid, CA_CELLBUFF_STATE_I src, _caState values[])
 {
-    _caUnsigned x_size = grid.cb_x_size;
+    // The offsets in a row of the main cell and of the cells at its
+    // east and west.
+    _caUnsigned x = grid.main_x + grid.cb_border;
+    _caUnsigned c = _caCellCol(grid, x);
+    _caUnsigned e = _caCellCol(grid, x + 1);
+    _caUnsigned w = _caCellCol(grid, x - 1);
 
-    _caUnsigned i = (grid.main_y + grid.cb_border) * x_size + (grid.main_x + grid.cb_border);
+    _caUnsigned i = grid.cb_row;
+    _caUnsigned n = grid.cb_row_n;
+    _caUnsigned s = grid.cb_row_s;
 
 #ifdef CA2D_MOORE
 
-    values[0] = src[i];
-    values[1] = src[i + 1];
-    values[2] = src[i - x_size + 1];
-    values[3] = src[i - x_size];
-    values[4] = src[i - x_size - 1];
-    values[5] = src[i - 1];
-    values[6] = src[i + x_size - 1];
-    values[7] = src[i + x_size];
-    values[8] = src[i + x_size + 1];
+    values[0] = src[i + c];
+    values[1] = src[i + e];
+    values[2] = src[n + e];
+    values[3] = src[n + c];
+    values[4] = src[n + w];
+    values[5] = src[i + w];
+    values[6] = src[s + w];
+    values[7] = src[s + c];
+    values[8] = src[s + e];
 
 #else // CA2D_VN
 
-    values[0] = src[i];
-    values[1] = src[i + 1];
-    values[2] = src[i - x_size];
-    values[3] = src[i - 1];
-    values[4] = src[i + x_size];
+    values[0] = src[i + c];
+    values[1] = src[i + e];
+    values[2] = src[n + c];
+    values[3] = src[i + w];
+    values[4] = src[s + c];
 
 #endif
 }
@@ -1318,7 +1585,96 @@ inline void  caReadCellBuffStateCellArray(CA_GRID grid, CA_CELLBUFF_STATE_I src,
 //! Write the given state value of the cell into the given buffer at the main cell index.
 inline void caWriteCellBuffState(CA_GRID grid, CA_CELLBUFF_STATE_IO dst, _caState value)
 {
-    dst[(grid.main_y + grid.cb_border) * grid.cb_x_size + (grid.main_x + grid.cb_border)] = value;
+    dst[grid.cb_row + _caCellCol(grid, grid.main_x + grid.cb_border)] = value;
+}
+
+
+//! Read the mask of the cell from the given buffer at the given cell index.
+inline _caMask caReadCellBuffMask(CA_GRID grid, CA_CELLBUFF_MASK_I src, int cell_number)
+{
+    // The offsets in a row of the main cell and of the cells at its
+    // east and west.
+    _caUnsigned x = grid.main_x + grid.cb_border;
+    _caUnsigned c = _caCellCol(grid, x);
+    _caUnsigned e = _caCellCol(grid, x + 1);
+    _caUnsigned w = _caCellCol(grid, x - 1);
+
+    _caUnsigned i = grid.cb_row;
+    _caUnsigned n = grid.cb_row_n;
+    _caUnsigned s = grid.cb_row_s;
+
+    _caMask value = 0;
+
+#ifdef CA2D_MOORE
+    switch (cell_number)
+    {
+    case 0: value = src[i + c]; break;
+    case 1: value = src[i + e]; break;
+    case 2: value = src[n + e]; break;
+    case 3: value = src[n + c]; break;
+    case 4: value = src[n + w]; break;
+    case 5: value = src[i + w]; break;
+    case 6: value = src[s + w]; break;
+    case 7: value = src[s + c]; break;
+    case 8: value = src[s + e]; break;
+    }
+#else //CA2D_VN
+    switch (cell_number)
+    {
+    case 0: value = src[i + c]; break;
+    case 1: value = src[i + e]; break;
+    case 2: value = src[n + c]; break;
+    case 3: value = src[i + w]; break;
+    case 4: value = src[s + c]; break;
+    }
+#endif
+    return value;
+}
+
+
+//! Set the given ca array with the masks of all the visible cells from
+//! the given buffer.
+inline void  caReadCellBuffMaskCellArray(CA_GRID grid, CA_CELLBUFF_MASK_I src, _caMask values[])
+{
+    // The offsets in a row of the main cell and of the cells at its
+    // east and west.
+    _caUnsigned x = grid.main_x + grid.cb_border;
+    _caUnsigned c = _caCellCol(grid, x);
+    _caUnsigned e = _caCellCol(grid, x + 1);
+    _caUnsigned w = _caCellCol(grid, x - 1);
+
+    _caUnsigned i = grid.cb_row;
+    _caUnsigned n = grid.cb_row_n;
+    _caUnsigned s = grid.cb_row_s;
+
+#ifdef CA2D_MOORE
+
+    values[0] = src[i + c];
+    values[1] = src[i + e];
+    values[2] = src[n + e];
+    values[3] = src[n + c];
+    values[4] = src[n + w];
+    values[5] = src[i + w];
+    values[6] = src[s + w];
+    values[7] = src[s + c];
+    values[8] = src[s + e];
+
+#else // CA2D_VN
+
+    values[0] = src[i + c];
+    values[1] = src[i + e];
+    values[2] = src[n + c];
+    values[3] = src[i + w];
+    values[4] = src[s + c];
+
+#endif
+}
+
+
+//! Write the given mask of the cell into the given buffer at the main cell index.
+inline void caWriteCellBuffMask(CA_GRID grid, CA_CELLBUFF_MASK_IO dst, _caMask value)
+{
+    dst[grid.cb_row + _caCellCol(grid, grid.main_x + grid.cb_border)] = value;
 }
 
 
@@ -1331,8 +1687,9 @@ inline _caReal caReadEdgeBuffReal(CA_GRID grid, CA_EDGEBUFF_REAL_I src,
 {
     _caReal value = 0.0;
 
+    // The X index of the cell and its row relative to the main cell.
     _caUnsigned x = grid.main_x;
-    _caUnsigned y = grid.main_y;
+    int y = 0;
 
 #ifdef CA2D_MOORE
     switch (cell_number)
@@ -1358,19 +1715,15 @@ inline _caReal caReadEdgeBuffReal(CA_GRID grid, CA_EDGEBUFF_REAL_I src,
     }
 #endif
 
-    _caUnsigned i_ns = (y + grid.eb_ns_y_border) * grid.eb_ns_x_size
-        + x + grid.eb_ns_start;
+    _caUnsigned i_ns = grid.eb_ns_row + y * grid.eb_ns_x_pitch + x;
 
-    _caUnsigned i_we = (y)* grid.eb_we_x_size
-        + x + grid.eb_we_x_border + grid.eb_we_start;
+    _caUnsigned i_we = grid.eb_we_row + y * grid.eb_we_x_pitch + x;
 
 #ifdef CA2D_MOORE
 
-    _caUnsigned i_nwse = (y + grid.eb_diag_y_border) * grid.eb_diag_x_size
-        + (x + grid.eb_diag_y_border) + grid.eb_nwse_start;
+    _caUnsigned i_nwse = grid.eb_nwse_row + y * grid.eb_diag_x_pitch + x;
 
-    _caUnsigned i_nesw = (y + grid.eb_diag_y_border) * grid.eb_diag_x_size
-        + (x + grid.eb_diag_y_border) + grid.eb_nesw_start;
+    _caUnsigned i_nesw = grid.eb_nesw_row + y * grid.eb_diag_x_pitch + x;
 
     switch (edge_number)
     {
@@ -1380,9 +1733,9 @@ inline _caReal caReadEdgeBuffReal(CA_GRID grid, CA_EDGEBUFF_REAL_I src,
     case 3: value = src[i_ns]; break;
     case 4: value = src[i_nwse]; break;
     case 5: value = src[i_we]; break;
-    case 6: value = src[i_nesw + grid.eb_diag_x_size]; break;
-    case 7: value = src[i_ns + grid.eb_ns_x_size]; break;
-    case 8: value = src[i_nwse + 1 + grid.eb_diag_x_size]; break;
+    case 6: value = src[i_nesw + grid.eb_diag_x_pitch]; break;
+    case 7: value = src[i_ns + grid.eb_ns_x_pitch]; break;
+    case 8: value = src[i_nwse + 1 + grid.eb_diag_x_pitch]; break;
     }
 #else  // CA2D_VN
     switch (edge_number)
@@ -1391,7 +1744,7 @@ inline _caReal caReadEdgeBuffReal(CA_GRID grid, CA_EDGEBUFF_REAL_I src,
     case 1: value = src[i_we + 1]; break;
     case 2: value = src[i_ns]; break;
     case 3: value = src[i_we]; break;
-    case 4: value = src[i_ns + grid.eb_ns_x_size]; break;
+    case 4: value = src[i_ns + grid.eb_ns_x_pitch]; break;
     }
 #endif
 
@@ -1404,8 +1757,9 @@ inline _caReal caReadEdgeBuffReal(CA_GRID grid, CA_EDGEBUFF_REAL_I src,
 inline void  caReadEdgeBuffRealEdgeArray(CA_GRID grid, CA_EDGEBUFF_REAL_I src,
     int cell_number, _caReal values[])
 {
+    // The X index of the cell and its row relative to the main cell.
     _caUnsigned x = grid.main_x;
-    _caUnsigned y = grid.main_y;
+    int y = 0;
 
 #ifdef CA2D_MOORE
     switch (cell_number)
@@ -1431,19 +1785,15 @@ inline void  caReadEdgeBuffRealEdgeArray(CA_GRID grid, CA_EDGEBUFF_REAL_I src,
     }
 #endif
 
-    _caUnsigned i_ns = (y + grid.eb_ns_y_border) * grid.eb_ns_x_size
-        + x + grid.eb_ns_start;
+    _caUnsigned i_ns = grid.eb_ns_row + y * grid.eb_ns_x_pitch + x;
 
-    _caUnsigned i_we = (y)* grid.eb_we_x_size
-        + x + grid.eb_we_x_border + grid.eb_we_start;
+    _caUnsigned i_we = grid.eb_we_row + y * grid.eb_we_x_pitch + x;
 
 #ifdef CA2D_MOORE
 
-    _caUnsigned i_nwse = (y + grid.eb_diag_y_border) * grid.eb_diag_x_size
-        + (x + grid.eb_diag_y_border) + grid.eb_nwse_start;
+    _caUnsigned i_nwse = grid.eb_nwse_row + y * grid.eb_diag_x_pitch + x;
 
-    _caUnsigned i_nesw = (y + grid.eb_diag_y_border) * grid.eb_diag_x_size
-        + (x + grid.eb_diag_y_border) + grid.eb_nesw_start;
+    _caUnsigned i_nesw = grid.eb_nesw_row + y * grid.eb_diag_x_pitch + x;
 
     values[0] = 0.0;
     values[1] = src[i_we + 1];
@@ -1451,9 +1801,9 @@ inline void  caReadEdgeBuffRealEdgeArray(CA_GRID grid, CA_EDGEBUFF_REAL_I src,
     values[3] = src[i_ns];
     values[4] = src[i_nwse];
     values[5] = src[i_we];
-    values[6] = src[i_nesw + grid.eb_diag_x_size];
-    values[7] = src[i_ns + grid.eb_ns_x_size];
-    values[8] = src[i_nwse + 1 + grid.eb_diag_x_size];
+    values[6] = src[i_nesw + grid.eb_diag_x_pitch];
+    values[7] = src[i_ns + grid.eb_ns_x_pitch];
+    values[8] = src[i_nwse + 1 + grid.eb_diag_x_pitch];
 
 #else  // CA2D_VN
 
@@ -1461,7 +1811,7 @@ inline void  caReadEdgeBuffRealEdgeArray(CA_GRID grid, CA_EDGEBUFF_REAL_I src,
     values[1] = src[i_we + 1];
     values[2] = src[i_ns];
     values[3] = src[i_we];
-    values[4] = src[i_ns + grid.eb_ns_x_size];
+    values[4] = src[i_ns + grid.eb_ns_x_pitch];
 
 #endif
 }
@@ -1471,19 +1821,15 @@ inline void  caReadEdgeBuffRealEdgeArray(CA_GRID grid, CA_EDGEBUFF_REAL_I src,
 //! index and given edge number.
 inline void caWriteEdgeBuffReal(CA_GRID grid, CA_EDGEBUFF_REAL_IO dst, int edge_number, _caReal value)
 {
-    _caUnsigned i_ns = (grid.main_y + grid.eb_ns_y_border) * grid.eb_ns_x_size
-        + grid.main_x + grid.eb_ns_start;
+    _caUnsigned i_ns = grid.eb_ns_row + grid.main_x;
 
-    _caUnsigned i_we = (grid.main_y) * grid.eb_we_x_size
-        + grid.main_x + grid.eb_we_x_border + grid.eb_we_start;
+    _caUnsigned i_we = grid.eb_we_row + grid.main_x;
 
 #ifdef CA2D_MOORE
 
-    _caUnsigned i_nwse = (grid.main_y + grid.eb_diag_y_border) * grid.eb_diag_x_size
-        + (grid.main_x + grid.eb_diag_y_border) + grid.eb_nwse_start;
+    _caUnsigned i_nwse = grid.eb_nwse_row + grid.main_x;
 
-    _caUnsigned i_nesw = (grid.main_y + grid.eb_diag_y_border) * grid.eb_diag_x_size
-        + (grid.main_x + grid.eb_diag_y_border) + grid.eb_nesw_start;
+    _caUnsigned i_nesw = grid.eb_nesw_row + grid.main_x;
 
     switch (edge_number)
     {
@@ -1493,9 +1839,9 @@ inline void caWriteEdgeBuffReal(CA_GRID grid, CA_EDGEBUFF_REAL_IO dst, int edge_
     case 3: dst[i_ns] = value; break;
     case 4: dst[i_nwse] = value; break;
     case 5: dst[i_we] = value; break;
-    case 6: dst[i_nesw + grid.eb_diag_x_size] = value; break;
-    case 7: dst[i_ns + grid.eb_ns_x_size] = value; break;
-    case 8: dst[i_nwse + 1 + grid.eb_diag_x_size] = value; break;
+    case 6: dst[i_nesw + grid.eb_diag_x_pitch] = value; break;
+    case 7: dst[i_ns + grid.eb_ns_x_pitch] = value; break;
+    case 8: dst[i_nwse + 1 + grid.eb_diag_x_pitch] = value; break;
     }
 
 #else  // CA2D_VN
@@ -1506,7 +1852,7 @@ inline void caWriteEdgeBuffReal(CA_GRID grid, CA_EDGEBUFF_REAL_IO dst, int edge_
     case 1: dst[i_we + 1] = value; break;
     case 2: dst[i_ns] = value; break;
     case 3: dst[i_we] = value; break;
-    case 4: dst[i_ns + grid.eb_ns_x_size] = value; break;
+    case 4: dst[i_ns + grid.eb_ns_x_pitch] = value; break;
     }
 
 #endif
@@ -1520,8 +1866,9 @@ inline _caState caReadEdgeBuffState(CA_GRID grid, CA_EDGEBUFF_STATE_I src,
 {
     _caState value = 0;
 
+    // The X index of the cell and its row relative to the main cell.
     _caUnsigned x = grid.main_x;
-    _caUnsigned y = grid.main_y;
+    int y = 0;
 
 #ifdef CA2D_MOORE
     switch (cell_number)
@@ -1547,19 +1894,15 @@ inline _caState caReadEdgeBuffState(CA_GRID grid, CA_EDGEBUFF_STATE_I src,
     }
 #endif
 
-    _caUnsigned i_ns = (y + grid.eb_ns_y_border) * grid.eb_ns_x_size
-        + x + grid.eb_ns_start;
+    _caUnsigned i_ns = grid.eb_ns_row + y * grid.eb_ns_x_pitch + x;
 
-    _caUnsigned i_we = (y)* grid.eb_we_x_size
-        + x + grid.eb_we_x_border + grid.eb_we_start;
+    _caUnsigned i_we = grid.eb_we_row + y * grid.eb_we_x_pitch + x;
 
 #ifdef CA2D_MOORE
 
-    _caUnsigned i_nwse = (y + grid.eb_diag_y_border) * grid.eb_diag_x_size
-        + (x + grid.eb_diag_y_border) + grid.eb_nwse_start;
+    _caUnsigned i_nwse = grid.eb_nwse_row + y * grid.eb_diag_x_pitch + x;
 
-    _caUnsigned i_nesw = (y + grid.eb_diag_y_border) * grid.eb_diag_x_size
-        + (x + grid.eb_diag_y_border) + grid.eb_nesw_start;
+    _caUnsigned i_nesw = grid.eb_nesw_row + y * grid.eb_diag_x_pitch + x;
 
     switch (edge_number)
     {
@@ -1569,9 +1912,9 @@ inline _caState caReadEdgeBuffState(CA_GRID grid, CA_EDGEBUFF_STATE_I src,
     case 3: value = src[i_ns]; break;
     case 4: value = src[i_nwse]; break;
     case 5: value = src[i_we]; break;
-    case 6: value = src[i_nesw + grid.eb_diag_x_size]; break;
-    case 7: value = src[i_ns + grid.eb_ns_x_size]; break;
-    case 8: value = src[i_nwse + 1 + grid.eb_diag_x_size]; break;
+    case 6: value = src[i_nesw + grid.eb_diag_x_pitch]; break;
+    case 7: value = src[i_ns + grid.eb_ns_x_pitch]; break;
+    case 8: value = src[i_nwse + 1 + grid.eb_diag_x_pitch]; break;
     }
 #else  // CA2D_VN
     switch (edge_number)
@@ -1580,7 +1923,7 @@ inline _caState caReadEdgeBuffState(CA_GRID grid, CA_EDGEBUFF_STATE_I src,
     case 1: value = src[i_we + 1]; break;
     case 2: value = src[i_ns]; break;
     case 3: value = src[i_we]; break;
-    case 4: value = src[i_ns + grid.eb_ns_x_size]; break;
+    case 4: value = src[i_ns + grid.eb_ns_x_pitch]; break;
     }
 #endif
 
@@ -1593,8 +1936,9 @@ inline _caState caReadEdgeBuffState(CA_GRID grid, CA_EDGEBUFF_STATE_I src,
 inline void  caReadEdgeBuffStateEdgeArray(CA_GRID grid, CA_EDGEBUFF_STATE_I src,
     int cell_number, _caState values[])
 {
+    // The X index of the cell and its row relative to the main cell.
     _caUnsigned x = grid.main_x;
-    _caUnsigned y = grid.main_y;
+    int y = 0;
 
 #ifdef CA2D_MOORE
     switch (cell_number)
@@ -1620,19 +1964,15 @@ inline void  caReadEdgeBuffStateEdgeArray(CA_GRID grid, CA_EDGEBUFF_STATE_I src,
     }
 #endif
 
-    _caUnsigned i_ns = (y + grid.eb_ns_y_border) * grid.eb_ns_x_size
-        + x + grid.eb_ns_start;
+    _caUnsigned i_ns = grid.eb_ns_row + y * grid.eb_ns_x_pitch + x;
 
-    _caUnsigned i_we = (y)* grid.eb_we_x_size
-        + x + grid.eb_we_x_border + grid.eb_we_start;
+    _caUnsigned i_we = grid.eb_we_row + y * grid.eb_we_x_pitch + x;
 
 #ifdef CA2D_MOORE
 
-    _caUnsigned i_nwse = (y + grid.eb_diag_y_border) * grid.eb_diag_x_size
-        + (x + grid.eb_diag_y_border) + grid.eb_nwse_start;
+    _caUnsigned i_nwse = grid.eb_nwse_row + y * grid.eb_diag_x_pitch + x;
 
-    _caUnsigned i_nesw = (y + grid.eb_diag_y_border) * grid.eb_diag_x_size
-        + (x + grid.eb_diag_y_border) + grid.eb_nesw_start;
+    _caUnsigned i_nesw = grid.eb_nesw_row + y * grid.eb_diag_x_pitch + x;
 
     values[0] = 0.0;
     values[1] = src[i_we + 1];
@@ -1640,9 +1980,9 @@ inline void  caReadEdgeBuffStateEdgeArray(CA_GRID grid, CA_EDGEBUFF_STATE_I src,
     values[3] = src[i_ns];
     values[4] = src[i_nwse];
     values[5] = src[i_we];
-    values[6] = src[i_nesw + grid.eb_diag_x_size];
-    values[7] = src[i_ns + grid.eb_ns_x_size];
-    values[8] = src[i_nwse + 1 + grid.eb_diag_x_size];
+    values[6] = src[i_nesw + grid.eb_diag_x_pitch];
+    values[7] = src[i_ns + grid.eb_ns_x_pitch];
+    values[8] = src[i_nwse + 1 + grid.eb_diag_x_pitch];
 
 #else  // CA2D_VN
 
@@ -1650,7 +1990,7 @@ inline void  caReadEdgeBuffStateEdgeArray(CA_GRID grid, CA_EDGEBUFF_STATE_I src,
     values[1] = src[i_we + 1];
     values[2] = src[i_ns];
     values[3] = src[i_we];
-    values[4] = src[i_ns + grid.eb_ns_x_size];
+    values[4] = src[i_ns + grid.eb_ns_x_pitch];
 
 #endif
 }
@@ -1660,19 +2000,15 @@ inline void  caReadEdgeBuffStateEdgeArray(CA_GRID grid, CA_EDGEBUFF_STATE_I src,
 //! index and given edge number.
 inline void caWriteEdgeBuffState(CA_GRID grid, CA_EDGEBUFF_STATE_IO dst, int edge_number, _caState value)
 {
-    _caUnsigned i_ns = (grid.main_y + grid.eb_ns_y_border) * grid.eb_ns_x_size
-        + grid.main_x + grid.eb_ns_start;
+    _caUnsigned i_ns = grid.eb_ns_row + grid.main_x;
 
-    _caUnsigned i_we = (grid.main_y) * grid.eb_we_x_size
-        + grid.main_x + grid.eb_we_x_border + grid.eb_we_start;
+    _caUnsigned i_we = grid.eb_we_row + grid.main_x;
 
 #ifdef CA2D_MOORE
 
-    _caUnsigned i_nwse = (grid.main_y + grid.eb_diag_y_border) * grid.eb_diag_x_size
-        + (grid.main_x + grid.eb_diag_y_border) + grid.eb_nwse_start;
+    _caUnsigned i_nwse = grid.eb_nwse_row + grid.main_x;
 
-    _caUnsigned i_nesw = (grid.main_y + grid.eb_diag_y_border) * grid.eb_diag_x_size
-        + (grid.main_x + grid.eb_diag_y_border) + grid.eb_nesw_start;
+    _caUnsigned i_nesw = grid.eb_nesw_row + grid.main_x;
 
     switch (edge_number)
     {
@@ -1682,9 +2018,9 @@ inline void caWriteEdgeBuffState(CA_GRID grid, CA_EDGEBUFF_STATE_IO dst, int edg
     case 3: dst[i_ns] = value; break;
     case 4: dst[i_nwse] = value; break;
     case 5: dst[i_we] = value; break;
-    case 6: dst[i_nesw + grid.eb_diag_x_size] = value; break;
-    case 7: dst[i_ns + grid.eb_ns_x_size] = value; break;
-    case 8: dst[i_nwse + 1 + grid.eb_diag_x_size] = value; break;
+    case 6: dst[i_nesw + grid.eb_diag_x_pitch] = value; break;
+    case 7: dst[i_ns + grid.eb_ns_x_pitch] = value; break;
+    case 8: dst[i_nwse + 1 + grid.eb_diag_x_pitch] = value; break;
     }
 
 #else  // CA2D_VN
@@ -1695,7 +2031,7 @@ inline void caWriteEdgeBuffState(CA_GRID grid, CA_EDGEBUFF_STATE_IO dst, int edg
     case 1: dst[i_we + 1] = value; break;
     case 2: dst[i_ns] = value; break;
     case 3: dst[i_we] = value; break;
-    case 4: dst[i_ns + grid.eb_ns_x_size] = value; break;
+    case 4: dst[i_ns + grid.eb_ns_x_pitch] = value; break;
     }
 
 #endif